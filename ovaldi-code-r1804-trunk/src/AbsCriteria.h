@@ -82,6 +82,16 @@ public :
 	/** Abstract method that evaluates a concrete criteria to not evaluated returns the result. */
 	virtual OvalEnum::ResultEnumeration NotEvaluated() = 0;
 
+	/** Abstract method that marks a concrete criteria as not evaluated because the result of its parent was
+		already decided. Unlike NotEvaluated() the referenced test or definition is left alone so that other 
+		definitions that reference it can still analyze it.
+	*/
+	virtual OvalEnum::ResultEnumeration SkipEvaluation() = 0;
+
+	/** Abstract method that returns a rough relative estimate of the work needed to analyze a concrete criteria.
+		Anything that has already been analyzed costs nothing.
+	*/
+	virtual unsigned int EstimateCost() = 0;
 
 
 	/** Get the result of the criteria. */
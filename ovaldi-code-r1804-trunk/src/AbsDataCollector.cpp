@@ -28,7 +28,10 @@
 //
 //****************************************************************************************//
 
+#include <ctime>
 #include <iostream>
+#include <map>
+#include <xercesc/dom/DOMDocument.hpp>
 #include <xercesc/dom/DOMElement.hpp>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
@@ -40,6 +43,8 @@
 #include "Version.h"
 #include "AbsVariable.h"
 #include "CollectedObject.h"
+#include "AnalysisPipeline.h"
+#include "ConfigSnapshot.h"
 
 #include "AbsDataCollector.h"
 
@@ -134,6 +139,30 @@ void AbsDataCollector::AddSchemaLocation(string newSchemaLocation) {
 
 void AbsDataCollector::Run() {
 
+	if(Common::GetPipelineAnalysis()) {
+		this->CollectObjectsByDefinition();
+	} else {
+		this->CollectObjects(NULL);
+	}
+}
+
+void AbsDataCollector::Run(StringVector* definitionIds) {
+
+	Log::Debug("Determining the objects referenced by the definitions to evaluate.");
+
+	StringSet* objectIds = this->GetReferencedObjectIds(definitionIds);
+
+	string logMessage = "     - collecting " + Common::ToString(objectIds->size()) + " objects referenced by the specified definitions\n";
+	cout << logMessage;
+	Log::UnalteredMessage(logMessage);
+
+	this->CollectObjects(objectIds);
+
+	delete objectIds;
+}
+
+void AbsDataCollector::CollectObjects(StringSet* objectIds) {
+
 	AbsDataCollector::isRunning = true;
 	//////////////////////////////////////////////////////
 	////////////////  Process OVAL objects  //////////////
@@ -149,7 +178,6 @@ void AbsDataCollector::Run() {
 
 		//	Loop through all the nodes in objects children
 		int prevIdLength = 1;
-		int curIdLength = 1;
 		unsigned int index = 0;
 		while(index < ovalObjectsChildren->getLength()) {
 			DOMNode *tmpNode = ovalObjectsChildren->item(index);
@@ -159,55 +187,236 @@ void AbsDataCollector::Run() {
 				DOMElement *object = (DOMElement*)tmpNode;
 
 				string objectId = XmlCommon::GetAttributeByName(object, "id");
-				
-				Log::Debug("Collecting object id: " + objectId);
-
-				if(!Log::WriteToScreen()) {
-					curIdLength = objectId.length();
-					string blankSpaces = "";
-					if(prevIdLength > curIdLength)
-						blankSpaces = Common::PadStringWithChar(blankSpaces, ' ', prevIdLength-curIdLength);
-
-					string backSpaces = "";
-					backSpaces = Common::PadStringWithChar(backSpaces, '\b', prevIdLength);
-					string endBackSpaces = "";
-					endBackSpaces = Common::PadStringWithChar(endBackSpaces, '\b', blankSpaces.length());
-					cout << backSpaces << objectId << blankSpaces << endBackSpaces;
-				}
-
-				this->objectCollector->Run(objectId);
 
-				prevIdLength = curIdLength;
+				// skip objects that none of the specified definitions reference
+				if(objectIds != NULL && objectIds->find(objectId) == objectIds->end()) {
+					index ++;
+					continue;
+				}
+				
+				this->CollectObject(objectId, &prevIdLength);
 			}
 
 			index ++;
 		}
 
-		if(!Log::WriteToScreen()) {
-			string fin = " FINISHED ";
-			int curLen = fin.length();
-			string blankSpaces = "";
-			if(prevIdLength > curLen)
-				blankSpaces = Common::PadStringWithChar(blankSpaces, ' ', prevIdLength-curLen);
-			string backSpaces = "";
-			backSpaces = Common::PadStringWithChar(backSpaces, '\b', prevIdLength);
-			
-			cout << backSpaces << fin << blankSpaces << endl;
+		AbsDataCollector::ShowFinished(prevIdLength);
+	} 
+
+	this->Finish();
+}
+
+void AbsDataCollector::CollectObjectsByDefinition() {
+
+	AbsDataCollector::isRunning = true;
+
+	DOMDocument* definitionDoc = DocumentManager::GetDefinitionDocument();
+	DOMElement* definitionsElm = XmlCommon::FindElementNS(definitionDoc, "definitions");
+	DOMElement* objectsElm = XmlCommon::FindElementNS(definitionDoc, "objects");
+
+	map<string, DOMElement*> elementsById;
+	AbsDataCollector::IndexDefinitionDocument(&elementsById);
+
+	StringSet allObjectIds;
+	if(objectsElm != NULL) {
+		for(DOMNode* child = objectsElm->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+			if(child->getNodeType() == DOMNode::ELEMENT_NODE)
+				allObjectIds.insert(XmlCommon::GetAttributeByName((DOMElement*)child, "id"));
+		}
+	}
+
+	StringVector definitionIds;
+	if(definitionsElm != NULL) {
+		for(DOMNode* child = definitionsElm->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+			if(child->getNodeType() == DOMNode::ELEMENT_NODE)
+				definitionIds.push_back(XmlCommon::GetAttributeByName((DOMElement*)child, "id"));
 		}
+	}
 
-		// Once finished running call write method on all collected objects
-		CollectedObject::WriteCollectedObjects();
+	AnalysisPipeline::Start(definitionIds.size());
 
-		// clean up after the run completes
-		State::ClearCache();
-		AbsVariable::ClearCache();
-		AbsProbe::ClearGlobalCache();
-        Item::ClearCache();
-	} 
+	if(!Log::WriteToScreen())
+		cout << "      Collecting object:  "; 
+
+	// every element that has been walked already had all of its objects collected 
+	// for an earlier definition, so each definition only collects what is new to it
+	StringSet walked;
+	StringSet collected;
+	int prevIdLength = 1;
+	for(StringVector::iterator it = definitionIds.begin(); it != definitionIds.end(); it++) {
+		StringVector pending(1, *it);
+		while(!pending.empty()) {
+			string id = pending.back();
+			pending.pop_back();
+
+			if(!walked.insert(id).second)
+				continue;
+
+			map<string, DOMElement*>::iterator found = elementsById.find(id);
+			if(found != elementsById.end())
+				AbsDataCollector::AppendReferencedIds(found->second, &pending);
+
+			if(allObjectIds.find(id) != allObjectIds.end() && collected.insert(id).second)
+				this->CollectObject(id, &prevIdLength);
+		}
+
+		AnalysisPipeline::DefinitionReady(*it);
+	}
+
+	// objects that no definition references still belong in the system characteristics
+	if(objectsElm != NULL) {
+		for(DOMNode* child = objectsElm->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+			if(child->getNodeType() != DOMNode::ELEMENT_NODE)
+				continue;
+
+			string objectId = XmlCommon::GetAttributeByName((DOMElement*)child, "id");
+			if(collected.insert(objectId).second)
+				this->CollectObject(objectId, &prevIdLength);
+		}
+	}
+
+	AbsDataCollector::ShowFinished(prevIdLength);
+
+	AnalysisPipeline::Flush();
+
+	this->Finish();
+}
+
+void AbsDataCollector::CollectObject(const string &objectId, int* prevIdLength) {
+
+	if(Log::IsDebug())
+		Log::Debug("Collecting object id: " + objectId);
+
+	int curIdLength = objectId.length();
+	if(!Log::WriteToScreen()) {
+		string blankSpaces = "";
+		if(*prevIdLength > curIdLength)
+			blankSpaces = Common::PadStringWithChar(blankSpaces, ' ', *prevIdLength-curIdLength);
+
+		string backSpaces = "";
+		backSpaces = Common::PadStringWithChar(backSpaces, '\b', *prevIdLength);
+		string endBackSpaces = "";
+		endBackSpaces = Common::PadStringWithChar(endBackSpaces, '\b', blankSpaces.length());
+		cout << backSpaces << objectId << blankSpaces << endBackSpaces;
+	}
+
+	this->objectCollector->Run(objectId);
+
+	*prevIdLength = curIdLength;
+}
+
+void AbsDataCollector::ShowFinished(int prevIdLength) {
+
+	if(!Log::WriteToScreen()) {
+		string fin = " FINISHED ";
+		int curLen = fin.length();
+		string blankSpaces = "";
+		if(prevIdLength > curLen)
+			blankSpaces = Common::PadStringWithChar(blankSpaces, ' ', prevIdLength-curLen);
+		string backSpaces = "";
+		backSpaces = Common::PadStringWithChar(backSpaces, '\b', prevIdLength);
+		
+		cout << backSpaces << fin << blankSpaces << endl;
+	}
+}
+
+void AbsDataCollector::Finish() {
+
+	// Once finished running call write method on all collected objects
+	CollectedObject::WriteCollectedObjects();
+
+	// clean up after the run completes
+	State::ClearCache();
+	AbsVariable::ClearCache();
+	AbsProbe::ClearGlobalCache();
+	AbsObjectCollector::ClearCache();
+	ConfigSnapshot::ClearCache();
+	Item::ClearCache();
 
 	AbsDataCollector::isRunning = false;
 }
 
+StringSet* AbsDataCollector::GetReferencedObjectIds(StringVector* definitionIds) {
+
+	DOMDocument* definitionDoc = DocumentManager::GetDefinitionDocument();
+
+	// index every definition, test, object, state, and variable by its id
+	map<string, DOMElement*> elementsById;
+	AbsDataCollector::IndexDefinitionDocument(&elementsById);
+
+	// walk the references starting from the specified definitions
+	StringSet visited;
+	StringVector pending(definitionIds->begin(), definitionIds->end());
+	while(!pending.empty()) {
+		string id = pending.back();
+		pending.pop_back();
+
+		if(!visited.insert(id).second)
+			continue;
+
+		map<string, DOMElement*>::iterator found = elementsById.find(id);
+		if(found != elementsById.end())
+			AbsDataCollector::AppendReferencedIds(found->second, &pending);
+	}
+
+	// only the objects are needed
+	StringSet* objectIds = new StringSet();
+	DOMElement* objectsElm = XmlCommon::FindElementNS(definitionDoc, "objects");
+	if(objectsElm != NULL) {
+		for(DOMNode* child = objectsElm->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+			if(child->getNodeType() == DOMNode::ELEMENT_NODE) {
+				string objectId = XmlCommon::GetAttributeByName((DOMElement*)child, "id");
+				if(visited.find(objectId) != visited.end())
+					objectIds->insert(objectId);
+			}
+		}
+	}
+
+	return objectIds;
+}
+
+void AbsDataCollector::IndexDefinitionDocument(map<string, DOMElement*>* elementsById) {
+
+	DOMDocument* definitionDoc = DocumentManager::GetDefinitionDocument();
+
+	const char* sections[] = { "definitions", "tests", "objects", "states", "variables" };
+	for(unsigned int i = 0; i < sizeof(sections) / sizeof(sections[0]); i++) {
+		DOMElement* sectionElm = XmlCommon::FindElementNS(definitionDoc, sections[i]);
+		if(sectionElm == NULL)
+			continue;
+
+		for(DOMNode* child = sectionElm->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+			if(child->getNodeType() == DOMNode::ELEMENT_NODE) {
+				DOMElement* childElm = (DOMElement*)child;
+				(*elementsById)[XmlCommon::GetAttributeByName(childElm, "id")] = childElm;
+			}
+		}
+	}
+}
+
+void AbsDataCollector::AppendReferencedIds(DOMElement* elm, StringVector* ids) {
+
+	// extend_definition, criterion, test object and state, object and state entity 
+	// var_ref, object_component, and variable_component references
+	const char* refAttributes[] = { "definition_ref", "test_ref", "object_ref", "state_ref", "var_ref" };
+	for(unsigned int i = 0; i < sizeof(refAttributes) / sizeof(refAttributes[0]); i++) {
+		string ref = XmlCommon::GetAttributeByName(elm, refAttributes[i]);
+		if(!ref.empty())
+			ids->push_back(ref);
+	}
+
+	// set objects reference objects and filter states by element value
+	string name = XmlCommon::GetElementName(elm);
+	if(name.compare("object_reference") == 0 || name.compare("filter") == 0) {
+		ids->push_back(XmlCommon::GetDataNodeValue(elm));
+	}
+
+	for(DOMNode* child = elm->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+		if(child->getNodeType() == DOMNode::ELEMENT_NODE)
+			AbsDataCollector::AppendReferencedIds((DOMElement*)child, ids);
+	}
+}
+
 bool AbsDataCollector::GetIsRunning(){
 
 	return AbsDataCollector::isRunning;
@@ -222,6 +431,8 @@ void AbsDataCollector::WriteGenerator() {
 	XmlCommon::AddChildElementNS(DocumentManager::GetSystemCharacteristicsDocument(), generatorElm, XmlCommon::comNS, "oval:schema_version", Version::GetSchemaVersion());
 	XmlCommon::AddChildElementNS(DocumentManager::GetSystemCharacteristicsDocument(), generatorElm, XmlCommon::comNS, "oval:timestamp", Common::GetTimeStamp());
 	XmlCommon::AddChildElement(DocumentManager::GetSystemCharacteristicsDocument(), generatorElm, "vendor", Version::GetVendor());
+	// the timestamp is local time without an offset, a later scan reusing this one needs the exact start
+	XmlCommon::AddChildElement(DocumentManager::GetSystemCharacteristicsDocument(), generatorElm, "scan_start_time", Common::ToString((unsigned long)time(NULL)));
 }
 
 //****************************************************************************************//
@@ -34,10 +34,12 @@
 //	other includes
 #include <string>
 #include <vector>
+#include <map>
 #include <xercesc/dom/DOMElement.hpp>
 
 //	include common classes
 #include "Exception.h"
+#include "StdTypedefs.h"
 #include "AbsObjectCollector.h"
 
 /**
@@ -66,9 +68,18 @@ public:
 	void AddXmlns(std::string newXmlnsAlias, std::string newXmlnsUri);
 	/** Loop through all objects in the provided oval definitions document.
 		Get the object reference from the test and call the object collector.
+		When analysis is pipelined the objects are collected definition by definition 
+		so that each definition can be analyzed as soon as its objects are collected.
 	*/
 	void Run();
 
+	/** Collect only the objects that the specified definitions depend on.
+		The definitions are walked through their criteria, extended definitions, tests, 
+		states, variables, and set objects to find every object that could be needed 
+		to evaluate them. All other objects are left out of the system characteristics.
+	*/
+	void Run(StringVector* definitionIds);
+
 	/** Return a reference to the collected_objects element in the sc document. */
 	xercesc::DOMElement* GetSCCollectedObjectsElm();
 	/** Return a reference to the system data element in the sc document. */
@@ -82,6 +93,9 @@ public:
 	/** Return true if the data collector is running. */
 	static bool GetIsRunning();
 
+	/** Write the collected objects to the sc document and clear the caches used during collection. */
+	void Finish();
+
 protected:
 
 	/** Write the generator element to the oval system characteristics document. 
@@ -93,6 +107,32 @@ protected:
 	*/
 	virtual void WriteSystemInfo() = 0;
 
+	/** Collect the objects in the oval definitions document.
+		If objectIds is not NULL only the objects in the set are collected.
+	*/
+	void CollectObjects(StringSet* objectIds);
+
+	/** Collect the objects referenced by each definition in document order and hand every 
+		definition to the AnalysisPipeline once all of its objects are collected. 
+		Objects that no definition references are collected last.
+	*/
+	void CollectObjectsByDefinition();
+
+	/** Collect a single object and update the progress display. */
+	void CollectObject(const std::string &objectId, int* prevIdLength);
+
+	/** Finish the progress display. */
+	static void ShowFinished(int prevIdLength);
+
+	/** Map the id of every definition, test, object, state, and variable to its element. */
+	static void IndexDefinitionDocument(std::map<std::string, xercesc::DOMElement*>* elementsById);
+
+	/** Return the ids of all objects referenced, directly or indirectly, by the specified definitions. */
+	StringSet* GetReferencedObjectIds(StringVector* definitionIds);
+
+	/** Add the id of every definition, test, object, state, or variable referenced by the element or its descendants. */
+	static void AppendReferencedIds(xercesc::DOMElement* elm, StringVector* ids);
+
 	xercesc::DOMElement* collectedObjectsElm;
 	
 	xercesc::DOMElement* systemDataElm;
@@ -33,6 +33,8 @@
 #include <vector>
 
 #include "Common.h"
+#include "CollectionDeadline.h"
+#include "Instrumentation.h"
 #include "XmlCommon.h"
 #include "DocumentManager.h"
 #include "Log.h"
@@ -48,6 +50,8 @@ using namespace xercesc;
 //							AbsObjectCollector Class									  //	
 //****************************************************************************************//
 AbsObjectCollector* AbsObjectCollector::instance = NULL;
+map<string, ItemVector> AbsObjectCollector::collectedItems;
+unsigned long AbsObjectCollector::sharedCount = 0;
 
 AbsObjectCollector::AbsObjectCollector() {
 	
@@ -153,6 +157,15 @@ CollectedObject* AbsObjectCollector::Run(string objectId) {
 	return collectedObject;
 }
 
+void AbsObjectCollector::ClearCache() {
+
+	if(AbsObjectCollector::sharedCount > 0)
+		Log::Debug("Objects: " + Common::ToString(AbsObjectCollector::sharedCount) + " reused the items of an identical object.");
+	AbsObjectCollector::sharedCount = 0;
+
+	AbsObjectCollector::collectedItems.clear();
+}
+
 // ***************************************************************************************	//
 //								Private members												//
 // ***************************************************************************************	//
@@ -359,15 +372,57 @@ CollectedObject* AbsObjectCollector::ProcessObject(Object* object) {
 			collectedObject->SetVariableValues(object->GetVariableValues());
 		} else {
 
+			// an identical object was already collected, so its items are the answer
+			string key = AbsObjectCollector::GetObjectKey(object);
+			map<string, ItemVector>::iterator identical = AbsObjectCollector::collectedItems.end();
+			if(!key.empty())
+				identical = AbsObjectCollector::collectedItems.find(key);
+			if(identical != AbsObjectCollector::collectedItems.end()) {
+				if(Log::IsDebug())
+					Log::Debug("Object " + object->GetId() + " is identical to an object already collected. Reusing its items.");
+				AbsObjectCollector::sharedCount++;
+
+				collectedObject = CollectedObject::Create(object);
+				collectedObject->AppendVariableValues(object->GetVariableValues());
+				ItemVector items(identical->second);
+				collectedObject->AppendReferencesAndComputeFlag(&items);
+				return collectedObject;
+			}
+
 			ItemVector* items = NULL;
-			AbsProbe* probe = this->GetProbe(object);
+
+			// the object's time budget also covers creating the probe, some probes
+			// read the system when they are created
+			Instrumentation::StartObject(object->GetId(), object->GetName());
+			CollectionDeadline::Start();
+			AbsProbe* probe = NULL;
+			try {
+				probe = this->GetProbe(object);
+				if(probe != NULL)
+					items = probe->Run(object);
+			} catch(...) {
+				CollectionDeadline::Stop();
+				Instrumentation::StopObject(0);
+				throw;
+			}
+			CollectionDeadline::Stop();
+			Instrumentation::StopObject(items != NULL ? (unsigned int)items->size() : 0);
+
 			if(probe != NULL) {
-				items = probe->Run(object);
 
 				// only create collected object if the probe succeeds
 				collectedObject = CollectedObject::Create(object);
 				collectedObject->AppendVariableValues(object->GetVariableValues());
 				collectedObject->AppendReferencesAndComputeFlag(items);
+
+				// some of the items could not be collected in time
+				if(CollectionDeadline::GetTimeoutCount() > 0) {
+					if(collectedObject->GetFlag() != OvalEnum::FLAG_ERROR)
+						collectedObject->SetFlag(OvalEnum::FLAG_INCOMPLETE);
+					collectedObject->AppendOvalMessage(new OvalMessage(CollectionDeadline::GetTimeoutMessage(), OvalEnum::LEVEL_WARNING));
+				} else if(!key.empty()) {
+					AbsObjectCollector::collectedItems[key] = *items;
+				}
 				delete items;
 			} else {
 				
@@ -380,6 +435,65 @@ CollectedObject* AbsObjectCollector::ProcessObject(Object* object) {
 	return collectedObject;
 }
 
+string AbsObjectCollector::GetObjectKey(Object* object) {
+
+	string key = "";
+	AbsObjectCollector::AppendKeyPart(&key, object->GetXmlns());
+	AbsObjectCollector::AppendKeyPart(&key, object->GetName());
+
+	AbsEntityVector* entities = object->GetElements();
+	AbsObjectCollector::AppendKeyPart(&key, Common::ToString(entities->size()));
+	for(AbsEntityVector::iterator iterator = entities->begin(); iterator != entities->end(); iterator++) {
+		AbsEntity* entity = (*iterator);
+		if(entity->GetDatatype() == OvalEnum::DATATYPE_RECORD)
+			return "";
+
+		AbsObjectCollector::AppendKeyPart(&key, entity->GetName());
+		AbsObjectCollector::AppendKeyPart(&key, Common::ToString(entity->GetDatatype()));
+		AbsObjectCollector::AppendKeyPart(&key, Common::ToString(entity->GetOperation()));
+		AbsObjectCollector::AppendKeyPart(&key, Common::ToString(entity->GetNil()));
+
+		// a variable is compared by the values it resolved to, not by its id
+		AbsVariable* var = entity->GetVarRef();
+		if(var == NULL) {
+			AbsObjectCollector::AppendKeyPart(&key, "value");
+			AbsObjectCollector::AppendKeyPart(&key, entity->GetValue());
+		} else {
+			AbsObjectCollector::AppendKeyPart(&key, "var_ref");
+			AbsObjectCollector::AppendKeyPart(&key, Common::ToString(entity->GetVarCheck()));
+			AbsObjectCollector::AppendKeyPart(&key, Common::ToString(var->GetFlag()));
+			VariableValueVector values = var->GetValues();
+			AbsObjectCollector::AppendKeyPart(&key, Common::ToString(values.size()));
+			for(VariableValueVector::iterator value = values.begin(); value != values.end(); value++)
+				AbsObjectCollector::AppendKeyPart(&key, value->GetValue());
+		}
+	}
+
+	BehaviorVector* behaviors = object->GetBehaviors();
+	AbsObjectCollector::AppendKeyPart(&key, Common::ToString(behaviors->size()));
+	for(BehaviorVector::iterator iterator = behaviors->begin(); iterator != behaviors->end(); iterator++) {
+		AbsObjectCollector::AppendKeyPart(&key, (*iterator)->GetName());
+		AbsObjectCollector::AppendKeyPart(&key, (*iterator)->GetValue());
+	}
+
+	// states are only parsed once, so the same state id is the same state
+	FilterVector* filters = object->GetFilters();
+	AbsObjectCollector::AppendKeyPart(&key, Common::ToString(filters->size()));
+	for(FilterVector::iterator iterator = filters->begin(); iterator != filters->end(); iterator++) {
+		AbsObjectCollector::AppendKeyPart(&key, (*iterator)->IsExcluding() ? "exclude" : "include");
+		AbsObjectCollector::AppendKeyPart(&key, (*iterator)->GetState()->GetId());
+	}
+
+	return key;
+}
+
+void AbsObjectCollector::AppendKeyPart(string* key, const string &part) {
+
+	key->append(Common::ToString(part.length()));
+	key->append(":");
+	key->append(part);
+}
+
 OvalEnum::Flag AbsObjectCollector::CombineFlagBySetOperator(OvalEnum::SetOperator setOp, OvalEnum::Flag set1Flag, OvalEnum::Flag set2Flag) {
 
 	OvalEnum::Flag result = OvalEnum::FLAG_ERROR;
@@ -33,6 +33,7 @@
 
 
 //	other includes
+#include <map>
 #include <string>
 
 #include "OvalEnum.h"
@@ -66,6 +67,11 @@ public:
 	*/
 	CollectedObject* Run(std::string objectId);
 
+	/** Forget the items of the objects collected so far. 
+		Called when collection completes and the items are released.
+	*/
+	static void ClearCache();
+
 protected:
 	AbsObjectCollector();
 	static AbsObjectCollector* instance;
@@ -110,9 +116,22 @@ protected:
 		 - Run the probe with the object
 		 - Set the matching collected items for the collected object
 		 - Set the flag value for the collected object.
+		An object identical to one already collected reuses its items instead of
+		running the probe again. See GetObjectKey().
 	*/
 	CollectedObject* ProcessObject(Object* object);
 
+	/**
+		Return a key that is the same for any two objects that collect the same items: 
+		the same object type, entities, resolved variable values, behaviors and filters.
+		The id, version and comment are left out. An empty key is returned for objects
+		that can't be compared this way, such as objects with record entities.
+	*/
+	static std::string GetObjectKey(Object* object);
+
+	/** Append a length prefixed part to the key, so that parts can't run into each other. */
+	static void AppendKeyPart(std::string* key, const std::string &part);
+
 	/** 
 		Process the input set and return the resulting CollectedSet.
 		Either recursivley process each child set or Process each object reference. 
@@ -153,6 +172,11 @@ protected:
 		filter (which depends on its action attribute), and remove all others.
 	*/
 	void ApplyFilters(ItemVector* items, FilterVector* filters);
+
+	/** The items collected for each object key. The items are owned by the AbsProbe global cache. */
+	static std::map<std::string, ItemVector> collectedItems;
+	/** The number of objects that reused the items of an identical object. */
+	static unsigned long sharedCount;
 };
 
 /** 
@@ -31,6 +31,8 @@
 #include <algorithm>
 #include <set>
 
+#include "PreviousScan.h"
+
 #include "AbsProbe.h"
 
 using namespace std;
@@ -74,9 +76,13 @@ AbsProbe::~AbsProbe() {
 //****************************************************************************************//
 ItemVector* AbsProbe::Run(Object* object) {
 
-	// create a vector of items that match the specified object
-	ItemVector* items = this->CollectItems(object);	
-	this->DeleteItemEntities();
+	// reuse what the previous scan found if nothing the object depends on has changed,
+	// otherwise create a vector of items that match the specified object
+	ItemVector* items = PreviousScan::GetItems(object);
+	if(items == NULL) {
+		items = this->CollectItems(object);	
+		this->DeleteItemEntities();
+	}
 	this->ApplyFilters(items, object->GetFilters());
 	items = this->CacheAllItems(items);
 
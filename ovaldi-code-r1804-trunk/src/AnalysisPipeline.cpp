@@ -0,0 +1,255 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+#include "Log.h"
+#include "Common.h"
+#include "DocumentManager.h"
+#include "AbsDataCollector.h"
+#include "Analyzer.h"
+
+#ifndef WIN32
+#  include <cerrno>
+#  include <cstdio>
+#  include <cstdlib>
+#  include <cstring>
+#  include <signal.h>
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#  include "TimedFileOps.h"
+#endif
+
+#include "AnalysisPipeline.h"
+
+using namespace std;
+
+namespace {
+	/** Batches per worker, so that a worker that finishes early can pick up more of the work. */
+	const unsigned int BATCHES_PER_WORKER = 4;
+
+#ifndef WIN32
+	/** A running worker's results file and the definitions it is analyzing. */
+	struct Worker {
+		string partFile;
+		StringVector batch;
+	};
+
+	/** The running workers, by process id. */
+	map<pid_t, Worker> running;
+#endif
+}
+
+//****************************************************************************************//
+//								AnalysisPipeline Class									  //	
+//****************************************************************************************//
+bool AnalysisPipeline::started = false;
+unsigned int AnalysisPipeline::batchSize = 1;
+unsigned int AnalysisPipeline::batchCount = 0;
+unsigned int AnalysisPipeline::failures = 0;
+StringVector AnalysisPipeline::pending;
+StringVector AnalysisPipeline::partFiles;
+StringVector AnalysisPipeline::unanalyzed;
+
+void AnalysisPipeline::Start(unsigned int definitionCount) {
+
+#ifndef WIN32
+	AnalysisPipeline::started = true;
+	AnalysisPipeline::batchSize = definitionCount / (AnalysisPipeline::GetMaxWorkers() * BATCHES_PER_WORKER);
+	if(AnalysisPipeline::batchSize == 0)
+		AnalysisPipeline::batchSize = 1;
+
+	Log::Debug("Analyzing definitions in batches of " + Common::ToString(AnalysisPipeline::batchSize) + " while collecting.");
+#endif
+}
+
+bool AnalysisPipeline::IsStarted() {
+
+	return AnalysisPipeline::started;
+}
+
+void AnalysisPipeline::DefinitionReady(const string &definitionId) {
+
+	if(!AnalysisPipeline::started)
+		return;
+
+	AnalysisPipeline::pending.push_back(definitionId);
+	if(AnalysisPipeline::pending.size() < AnalysisPipeline::batchSize)
+		return;
+
+#ifndef WIN32
+	// never hold up collection waiting for a worker, the batch just grows until one is free
+	AnalysisPipeline::Reap(false);
+	if(running.size() < AnalysisPipeline::GetMaxWorkers()) {
+		StringVector batch;
+		batch.swap(AnalysisPipeline::pending);
+		AnalysisPipeline::StartBatch(batch);
+	}
+#endif
+}
+
+void AnalysisPipeline::Flush() {
+
+	if(!AnalysisPipeline::started)
+		return;
+
+	// split what is left so that all the workers share it
+	unsigned int workers = AnalysisPipeline::GetMaxWorkers();
+	unsigned int size = (AnalysisPipeline::pending.size() + workers - 1) / workers;
+	StringVector::iterator start = AnalysisPipeline::pending.begin();
+	while(start != AnalysisPipeline::pending.end()) {
+		StringVector::iterator end = start + min(size, (unsigned int)(AnalysisPipeline::pending.end() - start));
+		StringVector batch(start, end);
+		start = end;
+
+#ifndef WIN32
+		while(running.size() >= workers)
+			AnalysisPipeline::Reap(true);
+#endif
+		AnalysisPipeline::StartBatch(batch);
+	}
+	AnalysisPipeline::pending.clear();
+}
+
+unsigned int AnalysisPipeline::Wait() {
+
+#ifndef WIN32
+	while(!running.empty())
+		AnalysisPipeline::Reap(true);
+#endif
+
+	return AnalysisPipeline::failures;
+}
+
+const StringVector& AnalysisPipeline::GetPartFiles() {
+
+	return AnalysisPipeline::partFiles;
+}
+
+const StringVector& AnalysisPipeline::GetUnanalyzed() {
+
+	return AnalysisPipeline::unanalyzed;
+}
+
+// ***************************************************************************************	//
+//								Private members												//
+// ***************************************************************************************	//
+void AnalysisPipeline::StartBatch(const StringVector &batch) {
+
+#ifdef WIN32
+	AnalysisPipeline::unanalyzed.insert(AnalysisPipeline::unanalyzed.end(), batch.begin(), batch.end());
+#else
+	string partFile = Common::GetOutputFilename() + ".pipeline." + Common::ToString(AnalysisPipeline::batchCount++) + ".part";
+
+	cout.flush();
+	Log::Flush();
+	pid_t pid = fork();
+	if(pid == 0) {
+		TimedFileOps::ForgetHelper();
+
+		// the worker writes what has been collected so far to its copy of the 
+		// system characteristics document and analyzes the batch against it
+		bool written = false;
+		try {
+			AbsDataCollector::Instance()->Finish();
+			Analyzer analyzer;
+			analyzer.AnalyzePart(batch, partFile);
+			written = true;
+		} catch(Exception ex) {
+			Log::Fatal("Error in analysis worker: " + ex.GetErrorMessage());
+		} catch(...) {
+			Log::Fatal("Unknown error in analysis worker.");
+		}
+		cout.flush();
+		Log::Flush();
+		_exit(written ? EXIT_SUCCESS : EXIT_FAILURE);
+
+	} else if(pid < 0) {
+		Log::Info("Unable to start an analysis worker process: " + string(strerror(errno)));
+		AnalysisPipeline::unanalyzed.insert(AnalysisPipeline::unanalyzed.end(), batch.begin(), batch.end());
+
+	} else {
+		if(Log::IsDebug())
+			Log::Debug("Started analysis worker " + Common::ToString(pid) + " for " + Common::ToString(batch.size()) + " definitions.");
+		Worker &worker = running[pid];
+		worker.partFile = partFile;
+		worker.batch = batch;
+	}
+#endif
+}
+
+void AnalysisPipeline::Reap(bool block) {
+
+#ifndef WIN32
+	// only wait on the workers, probes wait on the processes they start themselves
+	while(!running.empty()) {
+		bool reaped = false;
+		map<pid_t, Worker>::iterator iterator = running.begin();
+		while(iterator != running.end()) {
+			int status = 0;
+			pid_t pid = waitpid(iterator->first, &status, WNOHANG);
+			if(pid == 0 || (pid < 0 && errno == EINTR)) {
+				iterator++;
+				continue;
+			}
+
+			if(pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS) {
+				AnalysisPipeline::partFiles.push_back(iterator->second.partFile);
+			} else {
+				// the batch is analyzed again after collection, in this process
+				Log::Info("Analysis worker " + Common::ToString(iterator->first) + " failed. Its " 
+					+ Common::ToString(iterator->second.batch.size()) + " definitions will be analyzed after collection.");
+				AnalysisPipeline::failures++;
+				AnalysisPipeline::unanalyzed.insert(AnalysisPipeline::unanalyzed.end(), iterator->second.batch.begin(), iterator->second.batch.end());
+				remove(iterator->second.partFile.c_str());
+			}
+			running.erase(iterator++);
+			reaped = true;
+		}
+
+		if(reaped || !block || running.empty())
+			return;
+
+		// nothing has finished yet, so wait for the oldest worker without reaping it
+		siginfo_t info;
+		while(waitid(P_PID, running.begin()->first, &info, WEXITED | WNOWAIT) < 0 && errno == EINTR)
+			;
+	}
+#endif
+}
+
+unsigned int AnalysisPipeline::GetMaxWorkers() {
+
+	unsigned int workers = Common::GetWorkerCount();
+	return workers > 0 ? workers : 1;
+}
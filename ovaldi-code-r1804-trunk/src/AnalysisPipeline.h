@@ -0,0 +1,107 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifndef ANALYSISPIPELINE_H
+#define ANALYSISPIPELINE_H
+
+#include <string>
+
+#include "StdTypedefs.h"
+
+/**
+	This class analyzes definitions while the data collector is still collecting the objects
+	of later definitions.
+
+	The data collector reports each definition once every object it depends on has been
+	collected. Ready definitions are gathered into batches and each batch is analyzed in a 
+	forked worker process, which sees the system characteristics collected so far, so the
+	analysis of the first definitions overlaps the collection of the rest. Each worker writes
+	the results of its batch to a file that the Analyzer merges into the results document
+	once collection is complete.
+
+	Tests shared by definitions in different batches are evaluated once per batch. The 
+	Analyzer drops the duplicate results when merging.
+
+	Worker processes need fork, so on Windows nothing is started and every definition is
+	analyzed after collection as usual.
+*/
+class AnalysisPipeline {
+public:
+
+	/** Start the pipeline for a collection run that will report the specified number of definitions. */
+	static void Start(unsigned int definitionCount);
+
+	/** Return true if the pipeline was started for this run. */
+	static bool IsStarted();
+
+	/** Note that every object the definition depends on has been collected. 
+		A batch is handed to a worker once enough definitions are ready and a worker is free.
+	*/
+	static void DefinitionReady(const std::string &definitionId);
+
+	/** Hand the definitions that are still waiting to workers. Called once collection is complete. */
+	static void Flush();
+
+	/** Wait for every worker to finish and return the number of workers that failed. 
+		The definitions of a failed worker are added to the unanalyzed definitions.
+	*/
+	static unsigned int Wait();
+
+	/** Return the results files written by the workers that succeeded. */
+	static const StringVector& GetPartFiles();
+
+	/** Return the definitions that could not be handed to a worker, or whose worker failed, 
+		and still need to be analyzed. 
+	*/
+	static const StringVector& GetUnanalyzed();
+
+private:
+
+	/** Fork a worker to analyze the definitions in the batch. */
+	static void StartBatch(const StringVector &batch);
+
+	/** Reap the workers that have finished. If block is true wait for at least one. */
+	static void Reap(bool block);
+
+	/** Return the number of workers that may run at the same time. */
+	static unsigned int GetMaxWorkers();
+
+	static bool started;
+	static unsigned int batchSize;
+	static unsigned int batchCount;
+	static unsigned int failures;
+
+	/** Definitions that are ready but not yet handed to a worker. */
+	static StringVector pending;
+	static StringVector partFiles;
+	static StringVector unanalyzed;
+};
+
+#endif
@@ -28,9 +28,11 @@
 //
 //****************************************************************************************//
 
+#include <algorithm>
 #include <xercesc/dom/DOMElement.hpp>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
+#include <xercesc/util/XMLString.hpp>
 
 #include "Log.h"
 #include "Definition.h"
@@ -40,12 +42,57 @@
 #include "XmlCommon.h"
 #include "Common.h"
 #include "Test.h"
+#include "SystemCharacteristicsIndex.h"
+#include "XmlProcessor.h"
+#include "OvalEnum.h"
+#include "AnalysisPipeline.h"
+
+#ifndef WIN32
+#  include <cerrno>
+#  include <cstdio>
+#  include <cstring>
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#  include "TimedFileOps.h"
+#endif
 
 #include "Analyzer.h"
 
 using namespace std;
 using namespace xercesc;
 
+namespace {
+	/** Orders pairs by their first member only, so a stable sort keeps ties in place. */
+	struct FirstLess {
+		bool operator()(const pair<unsigned int, DOMElement*> &left, const pair<unsigned int, DOMElement*> &right) const {
+			return left.first < right.first;
+		}
+	};
+
+	/** Orders ids by their position in a document. */
+	struct DocumentOrderLess {
+		const map<string, unsigned int>* order;
+		DocumentOrderLess(const map<string, unsigned int>* order) : order(order) {}
+		bool operator()(const string &left, const string &right) const {
+			return order->find(left)->second < order->find(right)->second;
+		}
+	};
+
+	/** Return the values of the attribute on every descendant element with the specified local name. */
+	StringVector GetDescendantAttributes(DOMElement* elm, const char* localName, const char* attribute) {
+		StringVector values;
+		XMLCh* any = XMLString::transcode("*");
+		XMLCh* name = XMLString::transcode(localName);
+		DOMNodeList* elms = elm->getElementsByTagNameNS(any, name);
+		XMLString::release(&any);
+		XMLString::release(&name);
+		for(XMLSize_t i = 0; i < elms->getLength(); i++)
+			values.push_back(XmlCommon::GetAttributeByName((DOMElement*)elms->item(i), attribute));
+		return values;
+	}
+}
+
 DOMElement* Analyzer::definitionsElm = NULL;
 DOMElement* Analyzer::testsElm = NULL;
 DOMElement* Analyzer::resultsSystemElm = NULL;
@@ -66,6 +113,7 @@ Analyzer::Analyzer() {
     this->trueResults.clear();
     this->falseResults.clear();
     this->errorResults.clear();
+    this->unknownResults.clear();
     this->notEvaluatedResults.clear();
     this->notApplicableResults.clear();
     definitionsElm = NULL;
@@ -76,26 +124,7 @@ Analyzer::Analyzer() {
 
 Analyzer::~Analyzer() {
 
-    StringPairVector::iterator iterator;
-    for(iterator = trueResults.begin(); iterator != this->trueResults.end(); iterator++)
-        delete (*iterator); 
-    this->trueResults.clear();
-
-    for(iterator = falseResults.begin(); iterator != falseResults.end(); iterator++)
-        delete (*iterator);
-    this->falseResults.clear();
-
-    for(iterator = errorResults.begin(); iterator != errorResults.end(); iterator++)
-        delete (*iterator);
-    this->errorResults.clear();
-
-    for(iterator = notEvaluatedResults.begin(); iterator != notEvaluatedResults.end(); iterator++)
-        delete (*iterator);
-    this->notEvaluatedResults.clear();
-
-    for(iterator = notApplicableResults.begin(); iterator != notApplicableResults.end(); iterator++)
-        delete (*iterator);
-    this->notApplicableResults.clear();
+	Analyzer::ClearResultLists();
 }
 
 // ***************************************************************************************	//
@@ -168,59 +197,72 @@ void Analyzer::Run() {
 	DOMElement* definitionsElm = XmlCommon::FindElementNS(DocumentManager::GetDefinitionDocument(), "definitions");
 	if(definitionsElm != NULL) {
 
-		if(!Log::WriteToScreen())
-			cout << "      Analyzing definition:  "; 
-
-		DOMNodeList* definitionElms = definitionsElm->getChildNodes();
-		unsigned int i = 0;
-		while(i < definitionElms->getLength()) {
-			DOMNode* tmpNode = definitionElms->item(i);
-			if (tmpNode->getNodeType() == DOMNode::ELEMENT_NODE) {
-				DOMElement *definitionElm = (DOMElement*)tmpNode;
+		// the definitions may already have been analyzed while collecting, and
+		// large documents may be spread over several worker processes
+		if(AnalysisPipeline::IsStarted()) {
+			this->MergePipelineResults();
+		} else if(!this->AnalyzeInWorkers(definitionsElm)) {
+
+			if(!Log::WriteToScreen())
+				cout << "      Analyzing definition:  "; 
+
+			DOMNodeList* definitionElms = definitionsElm->getChildNodes();
+			unsigned int i = 0;
+			while(i < definitionElms->getLength()) {
+				DOMNode* tmpNode = definitionElms->item(i);
+				if (tmpNode->getNodeType() == DOMNode::ELEMENT_NODE) {
+					DOMElement *definitionElm = (DOMElement*)tmpNode;
 				
-				// get the definition id and check the cache
-				string definitionId = XmlCommon::GetAttributeByName(definitionElm, "id");
-				if(Definition::SearchCache(definitionId) == NULL) {
+					// get the definition id and check the cache
+					string definitionId = XmlCommon::GetAttributeByName(definitionElm, "id");
+					Definition* cachedDef = Definition::SearchCache(definitionId);
+					if(cachedDef == NULL || !cachedDef->GetAnalyzed()) {
 
-					Log::Debug("Analyzing definition: " + definitionId);
+						if(Log::IsDebug())
+							Log::Debug("Analyzing definition: " + definitionId);
 					
-					if(!Log::WriteToScreen()) {
-						curIdLength = definitionId.length();
-						string blankSpaces = "";
-						if(prevIdLength > curIdLength)
-							blankSpaces = Common::PadStringWithChar(blankSpaces, ' ', prevIdLength-curIdLength);
-
-						string backSpaces = "";
-						backSpaces = Common::PadStringWithChar(backSpaces, '\b', prevIdLength);
-						string endBackSpaces = "";
-						endBackSpaces = Common::PadStringWithChar(endBackSpaces, '\b', blankSpaces.length());
-						cout << backSpaces << definitionId << blankSpaces << endBackSpaces;
+						if(!Log::WriteToScreen()) {
+							curIdLength = definitionId.length();
+							string blankSpaces = "";
+							if(prevIdLength > curIdLength)
+								blankSpaces = Common::PadStringWithChar(blankSpaces, ' ', prevIdLength-curIdLength);
+
+							string backSpaces = "";
+							backSpaces = Common::PadStringWithChar(backSpaces, '\b', prevIdLength);
+							string endBackSpaces = "";
+							endBackSpaces = Common::PadStringWithChar(endBackSpaces, '\b', blankSpaces.length());
+							cout << backSpaces << definitionId << blankSpaces << endBackSpaces;
+						}
+
+						Definition* def = Definition::GetDefinitionById(definitionId);
+						def->Analyze();
+						if(!def->GetWritten())
+							def->Write(Analyzer::GetResultsSystemDefinitionsElm());					
+						prevIdLength = definitionId.length();
 					}
+	   			}
+				i++;
+			}
 
-					Definition* def = Definition::GetDefinitionById(definitionId);
-					def->Analyze();
-					def->Write(Analyzer::GetResultsSystemDefinitionsElm());					
-					prevIdLength = definitionId.length();
-				}
-   			}
-			i++;
+			if(!Log::WriteToScreen()) {
+				string fin = " FINISHED ";
+				int curLen = fin.length();
+				string blankSpaces = "";
+				if(prevIdLength > curLen)
+					blankSpaces = Common::PadStringWithChar(blankSpaces, ' ', prevIdLength-curLen);
+				string backSpaces = "";
+				backSpaces = Common::PadStringWithChar(backSpaces, '\b', prevIdLength);
+				cout << backSpaces << fin << blankSpaces << endl;
+			}
 		}
 
-		if(!Log::WriteToScreen()) {
-			string fin = " FINISHED ";
-			int curLen = fin.length();
-			string blankSpaces = "";
-			if(prevIdLength > curLen)
-				blankSpaces = Common::PadStringWithChar(blankSpaces, ' ', prevIdLength-curLen);
-			string backSpaces = "";
-			backSpaces = Common::PadStringWithChar(backSpaces, '\b', prevIdLength);
-			cout << backSpaces << fin << blankSpaces << endl;
+		// write out anything that was only referenced by short circuited criteria
+		if(Common::GetShortCircuitCriteria()) {
+			Definition::WriteNotEvaluated(Analyzer::GetResultsSystemDefinitionsElm());
+			Test::WriteNotEvaluated(Analyzer::GetResultsSystemTestsElm());
 		}
 
-		Definition::ClearCache();
-		Test::ClearCache();
-		Item::ClearCache();
-		State::ClearCache();
+		Analyzer::ClearCaches();
 
 		this->FinializeResultsDocument();
 
@@ -253,13 +295,15 @@ void Analyzer::Run(StringVector* definitionIds) {
 		for(iterator = definitionIds->begin(); iterator != definitionIds->end(); iterator++) {
 
 			string definitionId = (*iterator);
-			if(Definition::SearchCache(definitionId) == NULL) {
+			Definition* cachedDef = Definition::SearchCache(definitionId);
+			if(cachedDef == NULL || !cachedDef->GetAnalyzed()) {
 				// get the definition element by its id
 				DOMElement *definitionElm = XmlCommon::FindElementByAttribute(definitionsElm, "id", definitionId);
 
 				if(definitionElm != NULL) {
 
-					Log::Debug("Analyzing definition: " + definitionId);
+					if(Log::IsDebug())
+						Log::Debug("Analyzing definition: " + definitionId);
 							
 					if(!Log::WriteToScreen()) {
 						curIdLength = definitionId.length();
@@ -276,7 +320,8 @@ void Analyzer::Run(StringVector* definitionIds) {
 
 					Definition* def = Definition::GetDefinitionById(definitionId);
 					def->Analyze();
-					def->Write(Analyzer::GetResultsSystemDefinitionsElm());					
+					if(!def->GetWritten())
+						def->Write(Analyzer::GetResultsSystemDefinitionsElm());					
 					prevIdLength = definitionId.length();
 
 				} else {
@@ -296,9 +341,11 @@ void Analyzer::Run(StringVector* definitionIds) {
 				
 				// get the dedfinition id and check the cache
 				string definitionId = XmlCommon::GetAttributeByName(definitionElm, "id");
-				if(Definition::SearchCache(definitionId) == NULL) {
+				Definition* cachedDef = Definition::SearchCache(definitionId);
+				if(cachedDef == NULL || !cachedDef->GetAnalyzed()) {
 
-					Log::Debug("Analyzing definition: " + definitionId);
+					if(Log::IsDebug())
+						Log::Debug("Analyzing definition: " + definitionId);
 						
 					if(!Log::WriteToScreen()) {
 						curIdLength = definitionId.length();
@@ -315,7 +362,8 @@ void Analyzer::Run(StringVector* definitionIds) {
 
 					Definition* def = Definition::GetDefinitionById(definitionId);
 					def->NotEvaluated();
-					def->Write(Analyzer::GetResultsSystemDefinitionsElm());
+					if(!def->GetWritten())
+						def->Write(Analyzer::GetResultsSystemDefinitionsElm());
 					prevIdLength = definitionId.length();					
 				}
    			}
@@ -333,10 +381,13 @@ void Analyzer::Run(StringVector* definitionIds) {
 			cout << backSpaces << fin << blankSpaces << endl;
 		}
 
-		Definition::ClearCache();
-		Test::ClearCache();
-		Item::ClearCache();
-		State::ClearCache();
+		// write out anything that was only referenced by short circuited criteria
+		if(Common::GetShortCircuitCriteria()) {
+			Definition::WriteNotEvaluated(Analyzer::GetResultsSystemDefinitionsElm());
+			Test::WriteNotEvaluated(Analyzer::GetResultsSystemTestsElm());
+		}
+
+		Analyzer::ClearCaches();
 
 		this->FinializeResultsDocument();
 
@@ -351,6 +402,36 @@ void Analyzer::Run(StringVector* definitionIds) {
 	}
 }
 
+void Analyzer::AnalyzePart(const StringVector &definitionIds, const string &partFile) {
+
+	DocumentManager::SetResultDocument(XmlProcessor::Instance()->CreateDOMDocumentNS(XmlCommon::resNS, "oval_results"));
+	this->InitResultsDocument();
+
+	// the system characteristics have grown since any index of them, or any state
+	// result remembered for their items, was built
+	SystemCharacteristicsIndex::Clear();
+	State::ClearResults();
+	Analyzer::AnalyzeDefinitions(definitionIds);
+
+	XmlProcessor::Instance()->WriteDOMDocument(DocumentManager::GetResultDocument(), partFile);
+}
+
+void Analyzer::ClearCaches() {
+
+	Definition::ClearCache();
+	Test::ClearCache();
+	Item::ClearCache();
+	State::ClearCache();
+	SystemCharacteristicsIndex::Clear();
+}
+
+void Analyzer::ClearItemCaches() {
+
+	Item::ClearCache();
+	State::ClearResults();
+	SystemCharacteristicsIndex::Clear();
+}
+
 void Analyzer::PrintResults() {
 
 	///////////////////////////////////////////////////////////////////////////
@@ -505,6 +586,350 @@ void Analyzer::FinializeResultsDocument() {
 
 }
 
+bool Analyzer::AnalyzeInWorkers(DOMElement* definitionsElm) {
+
+#ifdef WIN32
+	return false;
+#else
+	// batch analysis already spreads whole files over the workers
+	unsigned int workers = Common::GetWorkerCount();
+	if(workers < 2 || !Common::GetBatchFile().empty())
+		return false;
+
+	// Group the definitions so that definitions sharing a test, or extending one another,
+	// end up in the same group. Tests are kept apart from definitions by a prefix.
+	StringVector definitionIds;
+	map<string, unsigned int> definitionOrder;
+	map<string, unsigned int> testCounts;
+	map<string, string> groups;
+	for(DOMNode* node = definitionsElm->getFirstChild(); node != NULL; node = node->getNextSibling()) {
+		if(node->getNodeType() != DOMNode::ELEMENT_NODE)
+			continue;
+
+		DOMElement* definitionElm = (DOMElement*)node;
+		string definitionId = XmlCommon::GetAttributeByName(definitionElm, "id");
+		if(definitionOrder.find(definitionId) != definitionOrder.end())
+			continue;
+		definitionOrder[definitionId] = definitionIds.size();
+		definitionIds.push_back(definitionId);
+
+		string group = Analyzer::FindGroup(groups, "d:" + definitionId);
+		StringVector testRefs = GetDescendantAttributes(definitionElm, "criterion", "test_ref");
+		for(StringVector::iterator iterator = testRefs.begin(); iterator != testRefs.end(); iterator++) {
+			string other = Analyzer::FindGroup(groups, "t:" + (*iterator));
+			if(other != group)
+				groups[other] = group;
+		}
+		StringVector definitionRefs = GetDescendantAttributes(definitionElm, "extend_definition", "definition_ref");
+		for(StringVector::iterator iterator = definitionRefs.begin(); iterator != definitionRefs.end(); iterator++) {
+			string other = Analyzer::FindGroup(groups, "d:" + (*iterator));
+			if(other != group)
+				groups[other] = group;
+		}
+		testCounts[definitionId] = testRefs.size();
+	}
+
+	// the tests of a group are a rough measure of how long it takes to analyze
+	map<string, StringVector> members;
+	map<string, unsigned int> weights;
+	for(StringVector::iterator iterator = definitionIds.begin(); iterator != definitionIds.end(); iterator++) {
+		string group = Analyzer::FindGroup(groups, "d:" + (*iterator));
+		members[group].push_back((*iterator));
+		weights[group] += 1 + testCounts[(*iterator)];
+	}
+
+	if(members.size() < 2)
+		return false;
+	if(workers > members.size())
+		workers = members.size();
+
+	// hand out the heaviest groups first, each to the least loaded worker
+	vector<pair<unsigned int, string> > byWeight;
+	for(map<string, unsigned int>::iterator iterator = weights.begin(); iterator != weights.end(); iterator++)
+		byWeight.push_back(make_pair(iterator->second, iterator->first));
+	sort(byWeight.rbegin(), byWeight.rend());
+
+	vector<StringVector> workerDefinitions(workers);
+	vector<unsigned int> loads(workers, 0);
+	for(vector<pair<unsigned int, string> >::iterator iterator = byWeight.begin(); iterator != byWeight.end(); iterator++) {
+		unsigned int lightest = min_element(loads.begin(), loads.end()) - loads.begin();
+		StringVector &groupMembers = members[iterator->second];
+		workerDefinitions[lightest].insert(workerDefinitions[lightest].end(), groupMembers.begin(), groupMembers.end());
+		loads[lightest] += iterator->first;
+	}
+
+	string logMessage = "      Analyzing " + Common::ToString(definitionIds.size()) + " definitions in " + Common::ToString(workers) + " worker processes.\n";
+	if(!Log::WriteToScreen())
+		cout << logMessage;
+	Log::UnalteredMessage(logMessage);
+
+	// Every worker inherits the parsed documents. Workers that can't be started are run
+	// here once all the others have been forked, so that none of them inherit the results.
+	vector<pid_t> pids(workers, -1);
+	StringVector workerFiles(workers);
+	for(unsigned int worker = 0; worker < workers; worker++) {
+		sort(workerDefinitions[worker].begin(), workerDefinitions[worker].end(), DocumentOrderLess(&definitionOrder));
+		workerFiles[worker] = Common::GetOutputFilename() + "." + Common::ToString(worker) + ".part";
+
+		cout.flush();
+		Log::Flush();
+		pid_t pid = fork();
+		if(pid == 0) {
+			TimedFileOps::ForgetHelper();
+			bool written = false;
+			try {
+				Analyzer::AnalyzeDefinitions(workerDefinitions[worker]);
+				XmlProcessor::Instance()->WriteDOMDocument(DocumentManager::GetResultDocument(), workerFiles[worker]);
+				written = true;
+			} catch(Exception ex) {
+				Log::Fatal("Error in analysis worker: " + ex.GetErrorMessage());
+			} catch(...) {
+				Log::Fatal("Unknown error in analysis worker.");
+			}
+			cout.flush();
+			Log::Flush();
+			_exit(written ? EXIT_SUCCESS : EXIT_FAILURE);
+		} else if(pid < 0) {
+			Log::Info("Unable to start an analysis worker process: " + string(strerror(errno)));
+		}
+		pids[worker] = pid;
+	}
+
+	for(unsigned int worker = 0; worker < workers; worker++) {
+		if(pids[worker] < 0)
+			Analyzer::AnalyzeDefinitions(workerDefinitions[worker]);
+	}
+
+	unsigned int failures = 0;
+	for(unsigned int worker = 0; worker < workers; worker++) {
+		if(pids[worker] < 0)
+			continue;
+
+		int status = 0;
+		while(waitpid(pids[worker], &status, 0) < 0 && errno == EINTR)
+			;
+		if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+			failures++;
+			remove(workerFiles[worker].c_str());
+		} else {
+			Analyzer::MergeWorkerFile(workerFiles[worker]);
+		}
+	}
+
+	if(failures > 0)
+		throw AnalyzerException("The analysis failed in " + Common::ToString(failures) + " worker processes. See the log for details.");
+
+	Analyzer::FinishMerge();
+
+	return true;
+#endif
+}
+
+void Analyzer::AnalyzeDefinitions(const StringVector &definitionIds) {
+
+	for(StringVector::const_iterator iterator = definitionIds.begin(); iterator != definitionIds.end(); iterator++) {
+		// a definition that was only parsed for a short circuited extend_definition is cached
+		// but was never analyzed
+		Definition* cachedDef = Definition::SearchCache((*iterator));
+		if(cachedDef == NULL || !cachedDef->GetAnalyzed()) {
+
+			if(Log::IsDebug())
+				Log::Debug("Analyzing definition: " + (*iterator));
+
+			Definition* def = Definition::GetDefinitionById((*iterator));
+			def->Analyze();
+			if(!def->GetWritten())
+				def->Write(Analyzer::GetResultsSystemDefinitionsElm());
+		}
+	}
+
+	// write out anything that was only referenced by short circuited criteria
+	if(Common::GetShortCircuitCriteria()) {
+		Definition::WriteNotEvaluated(Analyzer::GetResultsSystemDefinitionsElm());
+		Test::WriteNotEvaluated(Analyzer::GetResultsSystemTestsElm());
+	}
+}
+
+string Analyzer::FindGroup(map<string, string> &groups, const string &id) {
+
+	map<string, string>::iterator found = groups.find(id);
+	if(found == groups.end()) {
+		groups[id] = id;
+		return id;
+	}
+	if(found->second == id)
+		return id;
+
+	// point everything on the way straight at the representative
+	string group = Analyzer::FindGroup(groups, found->second);
+	groups[id] = group;
+	return group;
+}
+
+void Analyzer::MergePipelineResults() {
+
+	string logMessage = "      Merging the results of the definitions analyzed during collection.\n";
+	if(!Log::WriteToScreen())
+		cout << logMessage;
+	Log::UnalteredMessage(logMessage);
+
+	unsigned int failures = AnalysisPipeline::Wait();
+
+	const StringVector &partFiles = AnalysisPipeline::GetPartFiles();
+	for(StringVector::const_iterator iterator = partFiles.begin(); iterator != partFiles.end(); iterator++)
+		Analyzer::MergeWorkerFile((*iterator));
+
+	// the definitions of failed workers are among the unanalyzed ones, so the run only
+	// fails if they can not be analyzed here either
+	try {
+		Analyzer::AnalyzeDefinitions(AnalysisPipeline::GetUnanalyzed());
+	} catch(Exception ex) {
+		if(failures == 0)
+			throw;
+		throw AnalyzerException("The analysis failed in " + Common::ToString(failures) + " worker processes and again after collection: " + ex.GetErrorMessage());
+	}
+
+	Analyzer::FinishMerge();
+}
+
+void Analyzer::MergeWorkerFile(const string &workerFile) {
+
+	DOMDocument* resultDoc = DocumentManager::GetResultDocument();
+	DOMDocument* workerDoc = XmlProcessor::Instance()->ParseFileWithoutValidation(workerFile);
+
+	DOMElement* workerDefinitionsElm = XmlCommon::FindElementNS(workerDoc, "definitions");
+	if(workerDefinitionsElm != NULL) {
+		DOMElement* resultsDefinitionsElm = Analyzer::GetResultsSystemDefinitionsElm();
+		for(DOMNode* node = workerDefinitionsElm->getFirstChild(); node != NULL; node = node->getNextSibling()) {
+			if(node->getNodeType() == DOMNode::ELEMENT_NODE)
+				resultsDefinitionsElm->appendChild(resultDoc->importNode(node, true));
+		}
+	}
+
+	DOMElement* workerTestsElm = XmlCommon::FindElementNS(workerDoc, "tests");
+	if(workerTestsElm != NULL) {
+		DOMElement* resultsTestsElm = NULL;
+		for(DOMNode* node = workerTestsElm->getFirstChild(); node != NULL; node = node->getNextSibling()) {
+			if(node->getNodeType() != DOMNode::ELEMENT_NODE)
+				continue;
+			if(resultsTestsElm == NULL)
+				resultsTestsElm = Analyzer::GetResultsSystemTestsElm();
+			resultsTestsElm->appendChild(resultDoc->importNode(node, true));
+		}
+	}
+
+	workerDoc->release();
+	remove(workerFile.c_str());
+}
+
+void Analyzer::FinishMerge() {
+
+	// definitions and tests shared between pipeline batches were written by each of them
+	Analyzer::RemoveDuplicates(Analyzer::GetResultsSystemDefinitionsElm(), "definition_id");
+	if(Analyzer::testsElm != NULL)
+		Analyzer::RemoveDuplicates(Analyzer::testsElm, "test_id");
+
+	// put the results back in the order a single process would have written them
+	Analyzer::SortChildren(Analyzer::GetResultsSystemDefinitionsElm(), "definition_id", Analyzer::GetDocumentOrder("definitions"));
+	if(Analyzer::testsElm != NULL)
+		Analyzer::SortChildren(Analyzer::testsElm, "test_id", Analyzer::GetDocumentOrder("tests"));
+
+	// the result lists were filled in by the workers, so fill them in again here
+	Analyzer::ClearResultLists();
+	for(DOMNode* node = Analyzer::GetResultsSystemDefinitionsElm()->getFirstChild(); node != NULL; node = node->getNextSibling()) {
+		if(node->getNodeType() != DOMNode::ELEMENT_NODE)
+			continue;
+
+		StringPair* pair = new StringPair();
+		pair->first = XmlCommon::GetAttributeByName((DOMElement*)node, "definition_id");
+		pair->second = XmlCommon::GetAttributeByName((DOMElement*)node, "result");
+		OvalEnum::ResultEnumeration result = OvalEnum::ToResult(pair->second);
+		if(result == OvalEnum::RESULT_TRUE) {
+			Analyzer::AppendTrueResult(pair);
+		} else if(result == OvalEnum::RESULT_FALSE) {
+			Analyzer::AppendFalseResult(pair);
+		} else if(result == OvalEnum::RESULT_UNKNOWN) {
+			Analyzer::AppendUnknownResult(pair);
+		} else if(result == OvalEnum::RESULT_NOT_APPLICABLE) {
+			Analyzer::AppendNotApplicableResult(pair);
+		} else if(result == OvalEnum::RESULT_NOT_EVALUATED) {
+			Analyzer::AppendNotEvaluatedResult(pair);
+		} else {
+			Analyzer::AppendErrorResult(pair);
+		}
+	}
+}
+
+void Analyzer::RemoveDuplicates(DOMElement* parentElm, const string &idAttribute) {
+
+	string notEvaluated = OvalEnum::ResultToString(OvalEnum::RESULT_NOT_EVALUATED);
+
+	map<string, DOMElement*> kept;
+	DOMNode* node = parentElm->getFirstChild();
+	while(node != NULL) {
+		DOMNode* next = node->getNextSibling();
+		if(node->getNodeType() == DOMNode::ELEMENT_NODE) {
+			DOMElement* elm = (DOMElement*)node;
+			string key = XmlCommon::GetAttributeByName(elm, idAttribute) + " " + XmlCommon::GetAttributeByName(elm, "variable_instance");
+
+			map<string, DOMElement*>::iterator found = kept.find(key);
+			if(found == kept.end()) {
+				kept[key] = elm;
+			} else {
+				DOMElement* duplicate = elm;
+				if(XmlCommon::GetAttributeByName(found->second, "result") == notEvaluated && XmlCommon::GetAttributeByName(elm, "result") != notEvaluated) {
+					duplicate = found->second;
+					found->second = elm;
+				}
+				parentElm->removeChild(duplicate)->release();
+			}
+		}
+		node = next;
+	}
+}
+
+map<string, unsigned int> Analyzer::GetDocumentOrder(const string &section) {
+
+	map<string, unsigned int> order;
+	DOMElement* sectionElm = XmlCommon::FindElementNS(DocumentManager::GetDefinitionDocument(), section);
+	if(sectionElm != NULL) {
+		for(DOMNode* node = sectionElm->getFirstChild(); node != NULL; node = node->getNextSibling()) {
+			if(node->getNodeType() == DOMNode::ELEMENT_NODE)
+				order.insert(make_pair(XmlCommon::GetAttributeByName((DOMElement*)node, "id"), (unsigned int)order.size()));
+		}
+	}
+	return order;
+}
+
+void Analyzer::ClearResultLists() {
+
+	StringPairVector* lists[] = { &Analyzer::trueResults, &Analyzer::falseResults, &Analyzer::errorResults, 
+		&Analyzer::unknownResults, &Analyzer::notEvaluatedResults, &Analyzer::notApplicableResults };
+	for(unsigned int i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+		for(StringPairVector::iterator iterator = lists[i]->begin(); iterator != lists[i]->end(); iterator++)
+			delete (*iterator);
+		lists[i]->clear();
+	}
+}
+
+void Analyzer::SortChildren(DOMElement* parentElm, const string &idAttribute, const map<string, unsigned int> &order) {
+
+	// elements with an id that isn't in the order go last, in the order they are in now
+	vector<pair<unsigned int, DOMElement*> > children;
+	for(DOMNode* node = parentElm->getFirstChild(); node != NULL; node = node->getNextSibling()) {
+		if(node->getNodeType() != DOMNode::ELEMENT_NODE)
+			continue;
+		map<string, unsigned int>::const_iterator position = order.find(XmlCommon::GetAttributeByName((DOMElement*)node, idAttribute));
+		children.push_back(make_pair(position != order.end() ? position->second : (unsigned int)order.size(), (DOMElement*)node));
+	}
+
+	stable_sort(children.begin(), children.end(), FirstLess());
+
+	// appending a child that is already there moves it to the end
+	for(vector<pair<unsigned int, DOMElement*> >::iterator iterator = children.begin(); iterator != children.end(); iterator++)
+		parentElm->appendChild(iterator->second);
+}
+
 //****************************************************************************************//
 //								AnalyzerException Class									  //	
 //****************************************************************************************//
@@ -31,6 +31,9 @@
 #ifndef ANALYZER_H
 #define ANALYZER_H
 
+#include <map>
+#include <string>
+#include <xercesc/dom/DOMDocument.hpp>
 #include <xercesc/dom/DOMElement.hpp>
 
 // other includes
@@ -49,6 +52,9 @@ public:
 	/** Evaluate all OVAL Definitions.
 		This Run method runs through all the OVAL Definitions in the specified
 	    OVAL Definitions file and evaluates them.
+		When more than one worker process was requested the definitions are spread
+		over the workers. See AnalyzeInWorkers(). When the definitions were already
+		analyzed by the AnalysisPipeline during collection only their results are merged.
 	*/
 	void Run();
 	/** Evaluate the set of OVAL Definitions.
@@ -69,9 +75,25 @@ public:
 	/** Return a ptr to the results element in the results document. **/
 	static xercesc::DOMElement* GetResultsElm();
 
+	/** Analyze the specified definitions into a new results document and write it to the file.
+		This is how an AnalysisPipeline worker analyzes its batch of definitions.
+	*/
+	void AnalyzePart(const StringVector &definitionIds, const std::string &partFile);
+
 	/** Print the results of the analysis. */
 	void PrintResults();
 
+	/** Delete the definitions, tests, items and states cached by the analysis and the
+		index of the system characteristics. None of them may outlive the system
+		characteristics document they were analyzed against.
+	*/
+	static void ClearCaches();
+
+	/** Delete only what is cached about the items of the system characteristics document.
+		Definitions and tests that have been parsed but not analyzed yet are kept.
+	*/
+	static void ClearItemCaches();
+
 	/** Append a true result. **/
 	static void AppendTrueResult(StringPair* pair);
 	/** Append a false result. **/
@@ -90,6 +112,49 @@ private:
 	/** Format a pair of definition id and result value as a string for display. */
 	std::string ResultPairToStr(StringPair* pair);
 
+	/** Analyze the definitions in the worker processes requested on the command line.
+		Definitions that share a test or extend one another are kept in the same worker,
+		so every test is still evaluated exactly once. Each worker writes its part of the
+		results to a file, which is merged back into the results document in the order
+		of the definitions document.
+		Returns false, without analyzing anything, if the definitions should be analyzed
+		in this process instead.
+	*/
+	bool AnalyzeInWorkers(xercesc::DOMElement* definitionsElm);
+
+	/** Analyze and write each of the specified definitions, in order. */
+	static void AnalyzeDefinitions(const StringVector &definitionIds);
+
+	/** Return the representative of the group the id is in, adding the id if needed. */
+	static std::string FindGroup(std::map<std::string, std::string> &groups, const std::string &id);
+
+	/** Merge the results written by the AnalysisPipeline workers during collection
+		and analyze whatever could not be handed to a worker.
+	*/
+	void MergePipelineResults();
+
+	/** Move the definition and test results in a worker's results file into the results document and remove the file. */
+	static void MergeWorkerFile(const std::string &workerFile);
+
+	/** Drop duplicate results, put the merged results back in the order a single process 
+		would have written them and rebuild the result lists from them. 
+	*/
+	static void FinishMerge();
+
+	/** Remove all but one of the child elements with the same id and variable instance.
+		A result other than not evaluated is kept over a not evaluated one.
+	*/
+	static void RemoveDuplicates(xercesc::DOMElement* parentElm, const std::string &idAttribute);
+
+	/** Return the position of every child element of the section in the definitions document by id. */
+	static std::map<std::string, unsigned int> GetDocumentOrder(const std::string &section);
+
+	/** Delete every pair in the result lists. */
+	static void ClearResultLists();
+
+	/** Sort the child elements of the parent by the position of the value of their id attribute in the order. */
+	static void SortChildren(xercesc::DOMElement* parentElm, const std::string &idAttribute, const std::map<std::string, unsigned int> &order);
+
 	/** Initialize the results document adding the basic structure to it. */
 	void InitResultsDocument();
 
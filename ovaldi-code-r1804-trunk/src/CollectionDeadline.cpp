@@ -0,0 +1,108 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <sys/time.h>
+#endif
+
+#include <climits>
+
+#include "Common.h"
+
+#include "CollectionDeadline.h"
+
+using namespace std;
+
+//****************************************************************************************//
+//								CollectionDeadline Class								  //	
+//****************************************************************************************//
+bool CollectionDeadline::running = false;
+unsigned long long CollectionDeadline::started = 0;
+unsigned int CollectionDeadline::timeoutCount = 0;
+string CollectionDeadline::firstTimeout = "";
+
+void CollectionDeadline::Start() {
+	CollectionDeadline::running = true;
+	CollectionDeadline::started = CollectionDeadline::Now();
+	CollectionDeadline::timeoutCount = 0;
+	CollectionDeadline::firstTimeout = "";
+}
+
+void CollectionDeadline::Stop() {
+	CollectionDeadline::running = false;
+}
+
+int CollectionDeadline::GetCallBudget() {
+
+	long long budget = -1;
+	if(Common::GetCallTimeout() > 0)
+		budget = (long long)Common::GetCallTimeout() * 1000;
+
+	if(CollectionDeadline::running && Common::GetObjectTimeout() > 0) {
+		long long left = (long long)Common::GetObjectTimeout() * 1000 - (long long)(CollectionDeadline::Now() - CollectionDeadline::started);
+		if(left <= 0)
+			return 0;
+		if(budget < 0 || left < budget)
+			budget = left;
+	}
+
+	if(budget > INT_MAX)
+		budget = INT_MAX;
+
+	return (int)budget;
+}
+
+void CollectionDeadline::RecordTimeout(const string &call) {
+	if(CollectionDeadline::timeoutCount == 0)
+		CollectionDeadline::firstTimeout = call;
+	CollectionDeadline::timeoutCount++;
+}
+
+unsigned int CollectionDeadline::GetTimeoutCount() {
+	return CollectionDeadline::timeoutCount;
+}
+
+string CollectionDeadline::GetTimeoutMessage() {
+	return Common::ToString(CollectionDeadline::timeoutCount) + 
+		" file system call(s) did not complete within the collection time limits, starting with " + 
+		CollectionDeadline::firstTimeout + ". The collected items may be incomplete.";
+}
+
+unsigned long long CollectionDeadline::Now() {
+#ifdef WIN32
+	return GetTickCount64();
+#else
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (unsigned long long)now.tv_sec * 1000 + now.tv_usec / 1000;
+#endif
+}
@@ -0,0 +1,82 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifndef COLLECTIONDEADLINE_H
+#define COLLECTIONDEADLINE_H
+
+#include <string>
+
+/**
+	This class keeps the time budget for collecting the object that is currently being processed.
+
+	The object collector starts the clock before it hands an object to a probe and stops it once 
+	the probe returns. Blocking file system calls made while the object is being collected ask 
+	for their budget before they start: a call may take at most the configured per call timeout, 
+	and never more than what is left of the configured per object timeout. Once the object's 
+	budget is used up every further call fails straight away, so one unresponsive file system 
+	cannot hold up the rest of the scan.
+
+	Calls that run out of time are counted so that the collected object can be flagged as 
+	incomplete.
+*/
+class CollectionDeadline {
+public:
+
+	/** Start the clock for a new object and forget about any earlier timeouts. */
+	static void Start();
+
+	/** Stop the clock. Calls made outside of an object are only limited by the per call timeout. */
+	static void Stop();
+
+	/** Return the number of milliseconds the next blocking call may take. 
+		-1 means the call is not limited, 0 means the object's budget is used up.
+	*/
+	static int GetCallBudget();
+
+	/** Record that the described call did not complete within its budget. */
+	static void RecordTimeout(const std::string &call);
+
+	/** Return the number of calls that timed out since the clock was last started. */
+	static unsigned int GetTimeoutCount();
+
+	/** Return a message describing the timeouts recorded since the clock was last started. */
+	static std::string GetTimeoutMessage();
+
+	/** Return a millisecond count from an arbitrary starting point, for measuring elapsed time. */
+	static unsigned long long Now();
+
+private:
+	static bool running;
+	static unsigned long long started;
+	static unsigned int timeoutCount;
+	static std::string firstTimeout;
+};
+
+#endif
@@ -43,6 +43,9 @@
 
 #ifdef WIN32
 	#include <windows.h>
+#else
+	#include <sys/types.h>
+	#include <sys/stat.h>
 #endif
 
 #include "Common.h"
@@ -97,6 +100,19 @@ bool    Common::limitEvaluationToDefinitionIds = false;
 string  Common::definitionIds                  = "";
 string  Common::definitionIdsFile              = "";
 
+bool    Common::shortCircuitCriteria           = false;
+bool    Common::orderCriteriaByCost            = false;
+
+string       Common::batchFile                 = "";
+unsigned int Common::workerCount               = 1;
+unsigned int Common::xmlDocumentCacheSize      = 64;
+unsigned int Common::callTimeout               = 0;
+unsigned int Common::objectTimeout             = 0;
+string       Common::instrumentationFile       = "";
+string       Common::previousDatafile          = "";
+bool         Common::nativeHtml                = false;
+bool         Common::pipelineAnalysis          = false;
+
 const string Common::REGEX_CHARS = "^$\\.[](){}*+?|";
 
 namespace {
@@ -214,6 +230,50 @@ string Common::GetResultsSchematronPath() {
 	return Common::resultsSchematronPath;
 }
 
+bool Common::GetShortCircuitCriteria() {
+	return Common::shortCircuitCriteria;
+}
+
+bool Common::GetOrderCriteriaByCost() {
+	return Common::orderCriteriaByCost;
+}
+
+string Common::GetBatchFile() {
+	return Common::batchFile;
+}
+
+unsigned int Common::GetWorkerCount() {
+	return Common::workerCount;
+}
+
+unsigned int Common::GetXmlDocumentCacheSize() {
+	return Common::xmlDocumentCacheSize;
+}
+
+unsigned int Common::GetCallTimeout() {
+	return Common::callTimeout;
+}
+
+unsigned int Common::GetObjectTimeout() {
+	return Common::objectTimeout;
+}
+
+string Common::GetInstrumentationFile() {
+	return Common::instrumentationFile;
+}
+
+string Common::GetPreviousDatafile() {
+	return Common::previousDatafile;
+}
+
+bool Common::GetNativeHtml() {
+	return Common::nativeHtml;
+}
+
+bool Common::GetPipelineAnalysis() {
+	return Common::pipelineAnalysis;
+}
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  Mutators  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
@@ -357,6 +417,60 @@ void Common::SetResultsSchematronPath(string path) {
 	}
 }
 
+void Common::SetShortCircuitCriteria(bool set) {
+	Common::shortCircuitCriteria = set;
+}
+
+void Common::SetOrderCriteriaByCost(bool set) {
+	Common::orderCriteriaByCost = set;
+}
+
+void Common::SetBatchFile(string batchFile) {
+
+	if(Common::FileExists(batchFile)) {
+		Common::batchFile = batchFile;
+	} else {
+		throw CommonException("The specified batch file does not exist! " + batchFile);
+	}
+}
+
+void Common::SetWorkerCount(unsigned int workers) {
+	Common::workerCount = workers;
+}
+
+void Common::SetXmlDocumentCacheSize(unsigned int megabytes) {
+	Common::xmlDocumentCacheSize = megabytes;
+}
+
+void Common::SetCallTimeout(unsigned int seconds) {
+	Common::callTimeout = seconds;
+}
+
+void Common::SetObjectTimeout(unsigned int seconds) {
+	Common::objectTimeout = seconds;
+}
+
+void Common::SetInstrumentationFile(string instrumentationFile) {
+	Common::instrumentationFile = instrumentationFile;
+}
+
+void Common::SetPreviousDatafile(string previousDatafile) {
+
+	if(Common::FileExists(previousDatafile)) {
+		Common::previousDatafile = previousDatafile;
+	} else {
+		throw CommonException("The specified previous system characteristics file does not exist! " + previousDatafile);
+	}
+}
+
+void Common::SetNativeHtml(bool nativeHtml) {
+	Common::nativeHtml = nativeHtml;
+}
+
+void Common::SetPipelineAnalysis(bool pipelineAnalysis) {
+	Common::pipelineAnalysis = pipelineAnalysis;
+}
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  Public Members  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
@@ -642,6 +756,36 @@ StringPair* Common::SplitFilePathRegex(const string filepath) {
 	return fpComponents;
 }
 
+bool Common::GetFileKey(const string &filePath, string *key, unsigned long long *size) {
+#ifdef WIN32
+	HANDLE file = CreateFile(filePath.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+							 NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+		return false;
+
+	BY_HANDLE_FILE_INFORMATION info;
+	BOOL ok = GetFileInformationByHandle(file, &info);
+	CloseHandle(file);
+	if(!ok)
+		return false;
+
+	*key = Common::ToString(info.dwVolumeSerialNumber) + ":" +
+		Common::ToString(info.nFileIndexHigh) + ":" + Common::ToString(info.nFileIndexLow) + ":" +
+		Common::ToString(info.ftLastWriteTime.dwHighDateTime) + ":" + Common::ToString(info.ftLastWriteTime.dwLowDateTime);
+	*size = ((unsigned long long)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+#else
+	struct stat st;
+	if(stat(filePath.c_str(), &st) != 0)
+		return false;
+
+	*key = Common::ToString((unsigned long long)st.st_dev) + ":" +
+		Common::ToString((unsigned long long)st.st_ino) + ":" +
+		Common::ToString((long long)st.st_mtime);
+	*size = st.st_size;
+#endif
+	return true;
+}
+
 void Common::TrimStart(string &str) {
 	// isspace is apparently overloaded, so the compiler doesn't know how to
 	//   instantiate the ptr_fun template with isspace... So I gotta use this
@@ -90,6 +90,17 @@ class Common {
 		static std::string   GetSystemCharacteristicsSchematronPath();
 		static std::string   GetResultsSchematronPath();
 		static std::string   GetDefinitionIdsFile();
+		static bool     GetShortCircuitCriteria();
+		static bool     GetOrderCriteriaByCost();
+		static std::string   GetBatchFile();
+		static unsigned int  GetWorkerCount();
+		static unsigned int  GetXmlDocumentCacheSize();
+		static unsigned int  GetCallTimeout();
+		static unsigned int  GetObjectTimeout();
+		static std::string   GetInstrumentationFile();
+		static std::string   GetPreviousDatafile();
+		static bool     GetNativeHtml();
+		static bool     GetPipelineAnalysis();
 
 		static void		SetDataFile(std::string);
 		static void		SetGenerateMD5(bool);
@@ -115,6 +126,17 @@ class Common {
 		static void     SetSystemCharacteristicsSchematronPath(std::string path);
 		static void     SetResultsSchematronPath(std::string path);
 		static void     SetDefinitionIdsFile(std::string definitionIdsFile);
+		static void     SetShortCircuitCriteria(bool set);
+		static void     SetOrderCriteriaByCost(bool set);
+		static void     SetBatchFile(std::string batchFile);
+		static void     SetWorkerCount(unsigned int workers);
+		static void     SetXmlDocumentCacheSize(unsigned int megabytes);
+		static void     SetCallTimeout(unsigned int seconds);
+		static void     SetObjectTimeout(unsigned int seconds);
+		static void     SetInstrumentationFile(std::string instrumentationFile);
+		static void     SetPreviousDatafile(std::string previousDatafile);
+		static void     SetNativeHtml(bool nativeHtml);
+		static void     SetPipelineAnalysis(bool pipelineAnalysis);
 
 		static StringVector* ParseDefinitionIdsFile();
 		static StringVector* ParseDefinitionIdsString();
@@ -292,6 +314,13 @@ class Common {
          */
 		static StringPair* SplitFilePathRegex(const std::string filepath);
 
+		/**
+		 *	Get a key that identifies the current contents of a file: the device, inode and modification 
+		 *	time on unix, and the volume, file index and last write time on windows. Also get the size of the file.
+		 *	@return false if the file could not be examined.
+		 */
+		static bool GetFileKey(const std::string &filePath, std::string *key, unsigned long long *size);
+
 		/** Removes whitespace at the start of the given string. */
 		static void TrimStart(std::string& str);
 
@@ -354,6 +383,24 @@ class Common {
 		static std::string resultsSchematronPath;
 		static std::string systemCharacteristicsSchematronPath;
 		static std::string definitionIdsFile;
+		static bool shortCircuitCriteria;
+		static bool orderCriteriaByCost;
+		static std::string batchFile;
+		static unsigned int workerCount;
+		/** The number of megabytes of parsed xml documents the xmlfilecontent probe may keep in memory. */
+		static unsigned int xmlDocumentCacheSize;
+		/** The number of seconds a single blocking file system call may take during collection. 0 means no limit. */
+		static unsigned int callTimeout;
+		/** The number of seconds the collection of a single object may take. 0 means no limit. */
+		static unsigned int objectTimeout;
+		/** The file to write the timing and memory report to. Empty if no report is wanted. */
+		static std::string instrumentationFile;
+		/** The system characteristics file of a previous scan whose items may be reused. Empty if everything is collected. */
+		static std::string previousDatafile;
+		/** Write the results html directly instead of applying the results xsl. */
+		static bool nativeHtml;
+		/** Analyze definitions in worker processes while the remaining objects are still being collected. */
+		static bool pipelineAnalysis;
 
 		/** format of a definition id. */
 		static const std::string DEFINITION_ID;
@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <vector>
 
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
@@ -49,57 +50,65 @@ using namespace xercesc;
 // ***************************************************************************************	//
 ComponentValue* ConcatFunction::ComputeValue() {
 
-	/** 
-	    Make initial call to start the recursive processing of components.
-	    Call starts with the index of the first item in the set of components
-	*/
-	return this->ProcessComponents(0);
-}
+	AbsComponentVector* components = this->GetComponents();
+	unsigned int count = components->size();
+
+	// a single component is just passed along as is
+	if(count == 1)
+		return components->at(0)->ComputeValue();
+
+	// Compute each component's values exactly once. Components are computed,
+	// and their messages collected, from last to first to keep the same 
+	// ordering the results have always had.
+	std::vector<ComponentValue*> componentValues(count, (ComponentValue*)NULL);
+	ComponentValue* results = new ComponentValue();
+	IntVector flags;
+	StringVector::size_type total = 1;
+	for(unsigned int index = count; index > 0; index--) {
+		ComponentValue* values = components->at(index-1)->ComputeValue();
+		componentValues[index-1] = values;
+		flags.push_back(values->GetFlag());
+		results->AppendMessages(values->GetMessages());
+		total *= values->GetValues()->size();
+	}
+	results->SetFlag(OvalEnum::CombineFlags(&flags));
+
+	// Walk the cross product of the component values with the last component
+	// varying fastest. The concatenated prefix is kept in a single buffer and 
+	// only the part after the left most component that changed is rebuilt.
+	if(total > 0) {
+		StringVector* resultValues = results->GetValues();
+		resultValues->reserve(total);
+
+		std::vector<StringVector::size_type> positions(count, 0);
+		std::vector<string::size_type> prefixLengths(count, 0);
+		string buffer;
+		unsigned int changed = 0;
+		while(true) {
+			buffer.resize(prefixLengths[changed]);
+			for(unsigned int index = changed; index < count; index++) {
+				prefixLengths[index] = buffer.size();
+				buffer.append(componentValues[index]->GetValues()->at(positions[index]));
+			}
+			resultValues->push_back(buffer);
 
-ComponentValue* ConcatFunction::ProcessComponents(unsigned int index) {
-	
-	if(this->GetComponents()->size()-1 == index) {
-		// reached the end of the line just return all this components values in a vector
-		ComponentValue* results = this->GetComponents()->at(index)->ComputeValue();
-		return results;
-	} else {
-		// make recursive call
-		ComponentValue* values = this->ProcessComponents(index+1);
-
-		// get the set of current values
-		ComponentValue* currentValues = this->GetComponents()->at(index)->ComputeValue();
-
-		// Create a object to store the results of the concat
-		ComponentValue* results = new ComponentValue();
-		// combine the flag values and set the new value
-		IntVector* flags = new IntVector();
-		flags->push_back(values->GetFlag());
-		flags->push_back(currentValues->GetFlag());
-		results->SetFlag(OvalEnum::CombineFlags(flags));
-		delete flags;
-		
-		// loop over current values
-		StringVector::iterator currentIterator;
-		for(currentIterator = currentValues->GetValues()->begin(); currentIterator != currentValues->GetValues()->end(); currentIterator++) {
-		
-			// loop over results of recursive call
-			StringVector::iterator iterator;
-			for(iterator = values->GetValues()->begin(); iterator != values->GetValues()->end(); iterator++) {
-				// concat the values
-				string tmpStr = (*currentIterator) + (*iterator);
-				results->AppendValue(tmpStr);
+			// advance to the next combination
+			unsigned int index = count;
+			while(index > 0 && ++positions[index-1] == componentValues[index-1]->GetValues()->size()) {
+				positions[index-1] = 0;
+				index--;
 			}
+			if(index == 0)
+				break;
+			changed = index-1;
 		}
+	}
 
-		// make sure all the messages are passed along tot he results
-		results->AppendMessages(values->GetMessages());
-		results->AppendMessages(currentValues->GetMessages());
-
-		delete currentValues;
-		delete values;		
-
-		return results;
+	for(unsigned int index = 0; index < count; index++) {
+		delete componentValues[index];
 	}
+
+	return results;
 }
 
 void ConcatFunction::Parse(DOMElement* componentElm) {
@@ -48,18 +48,15 @@ public:
 	/** Parse the concat element and its child component elements. */
 	virtual void Parse(xercesc::DOMElement* componentElm); 
 
-	/** Compute the desired concatenated strings and return the values. */
+	/** 
+		Compute the desired concatenated strings and return the values. 
+		Every combination of the component values is produced, with the 
+		first component's value at the front of each string.
+	*/
 	virtual ComponentValue* ComputeValue();
 
 	/** Return the variable values used to compute this function's value. */
 	virtual VariableValueVector GetVariableValues();
-
-	/**
-		Recursively process all components of this function starting
-		with the component at the designated index.
-		@param index the index of the component to process.
-	*/
-	ComponentValue* ProcessComponents(unsigned int index);
 };
 
 #endif
@@ -0,0 +1,123 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#include "Log.h"
+#include "Common.h"
+
+#include "ConfigSnapshot.h"
+
+using namespace std;
+
+//****************************************************************************************//
+//								ConfigSnapshot Class									  //	
+//****************************************************************************************//
+map<string, ConfigSnapshot*> ConfigSnapshot::snapshots;
+unsigned long ConfigSnapshot::hits = 0;
+unsigned long ConfigSnapshot::misses = 0;
+
+ConfigSnapshot::ConfigSnapshot() {
+}
+
+ConfigSnapshot::~ConfigSnapshot() {
+}
+
+// ***************************************************************************************	//
+//								 Public members												//
+// ***************************************************************************************	//
+void ConfigSnapshot::AddSource(const string &path) {
+	this->sources[path] = ConfigSnapshot::GetSourceKey(path);
+}
+
+bool ConfigSnapshot::IsCurrent() const {
+	for(map<string, string>::const_iterator iterator = this->sources.begin(); iterator != this->sources.end(); iterator++) {
+		if(ConfigSnapshot::GetSourceKey(iterator->first) != iterator->second)
+			return false;
+	}
+	return true;
+}
+
+ConfigSnapshot* ConfigSnapshot::Get(const string &name) {
+
+	map<string, ConfigSnapshot*>::iterator iterator = ConfigSnapshot::snapshots.find(name);
+	if(iterator == ConfigSnapshot::snapshots.end()) {
+		ConfigSnapshot::misses++;
+		return NULL;
+	}
+
+	if(!iterator->second->IsCurrent()) {
+		Log::Debug("The configuration read for " + name + " has changed, it will be read again.");
+		delete iterator->second;
+		ConfigSnapshot::snapshots.erase(iterator);
+		ConfigSnapshot::misses++;
+		return NULL;
+	}
+
+	ConfigSnapshot::hits++;
+	return iterator->second;
+}
+
+void ConfigSnapshot::Put(const string &name, ConfigSnapshot *snapshot) {
+
+	map<string, ConfigSnapshot*>::iterator iterator = ConfigSnapshot::snapshots.find(name);
+	if(iterator != ConfigSnapshot::snapshots.end()) {
+		if(iterator->second == snapshot)
+			return;
+		delete iterator->second;
+		iterator->second = snapshot;
+	} else {
+		ConfigSnapshot::snapshots[name] = snapshot;
+	}
+}
+
+void ConfigSnapshot::ClearCache() {
+
+	if(ConfigSnapshot::hits > 0 || ConfigSnapshot::misses > 0)
+		Log::Debug("Configuration snapshots: " + Common::ToString(ConfigSnapshot::hits) + " reused, " + Common::ToString(ConfigSnapshot::misses) + " read.");
+	ConfigSnapshot::hits = 0;
+	ConfigSnapshot::misses = 0;
+
+	for(map<string, ConfigSnapshot*>::iterator iterator = ConfigSnapshot::snapshots.begin(); iterator != ConfigSnapshot::snapshots.end(); iterator++)
+		delete iterator->second;
+	ConfigSnapshot::snapshots.clear();
+}
+
+// ***************************************************************************************	//
+//								Private members												//
+// ***************************************************************************************	//
+string ConfigSnapshot::GetSourceKey(const string &path) {
+
+	string key = "";
+	unsigned long long size = 0;
+	if(!Common::GetFileKey(path, &key, &size))
+		return "";
+
+	// the size catches most changes made within the same second as the last one
+	return key + ":" + Common::ToString(size);
+}
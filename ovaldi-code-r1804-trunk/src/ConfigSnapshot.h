@@ -0,0 +1,88 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifndef CONFIGSNAPSHOT_H
+#define CONFIGSNAPSHOT_H
+
+#include <map>
+#include <string>
+
+/**
+	This class holds configuration that a probe has read and parsed, so that it is parsed once per 
+	run no matter how many objects ask about it.
+
+	A probe derives a class holding its parsed model from this one, adds every file and directory 
+	the model was built from as a source, and registers the snapshot under a name of its own. 
+	Before using a registered snapshot the probe asks for it again by name: if any of its sources 
+	was changed, added or removed since the snapshot was made, the snapshot is thrown away and the 
+	probe parses the configuration again. Directories are checked by their own modification time, 
+	which changes when entries are added to them or removed from them.
+
+	All snapshots are deleted when the data collector finishes.
+*/
+class ConfigSnapshot {
+public:
+	ConfigSnapshot();
+	virtual ~ConfigSnapshot();
+
+	/** Record the current state of a file or directory the snapshot is built from. 
+		A source that does not exist is recorded too, so that creating it later is noticed.
+	*/
+	void AddSource(const std::string &path);
+
+	/** Return true if none of the sources has changed since it was added. */
+	bool IsCurrent() const;
+
+	/** Return the snapshot registered under the specified name, or NULL if there is none or its 
+		sources have changed. A snapshot that is out of date is deleted.
+	*/
+	static ConfigSnapshot* Get(const std::string &name);
+
+	/** Register the snapshot under the specified name, deleting any snapshot registered under 
+		it before. The snapshot is owned by this class from then on.
+	*/
+	static void Put(const std::string &name, ConfigSnapshot *snapshot);
+
+	/** Delete all registered snapshots. */
+	static void ClearCache();
+
+private:
+	/** Return the key identifying the current state of the path, or an empty string if it does not exist. */
+	static std::string GetSourceKey(const std::string &path);
+
+	/** The key of each source at the time it was added, by path. */
+	std::map<std::string, std::string> sources;
+
+	static std::map<std::string, ConfigSnapshot*> snapshots;
+	static unsigned long hits;
+	static unsigned long misses;
+};
+
+#endif
@@ -28,6 +28,8 @@
 //
 //****************************************************************************************//
 
+#include <map>
+#include <vector>
 #include <xercesc/dom/DOMDocument.hpp>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
@@ -243,14 +245,47 @@ OvalEnum::ResultEnumeration Criteria::Analyze() {
 	//	applies operator 
 	//	applies negate attribute
 	//	saves and returns result
+	//
+	//	When short circuiting is enabled the remaining child criteria are
+	//	skipped as soon as the operator's result is decided, and optionally
+	//	the child criteria are analyzed cheapest first. The children keep 
+	//	their original order in the results document either way.
 	// -----------------------------------------------------------------------
 
+	AbsCriteriaVector* children = this->GetChildCriteria();
+
+	// determine the order to analyze the child criteria in
+	vector<unsigned int> order;
+	order.reserve(children->size());
+	if(Common::GetShortCircuitCriteria() && Common::GetOrderCriteriaByCost()) {
+		multimap<unsigned int, unsigned int> byCost;
+		for(unsigned int i = 0; i < children->size(); i++) {
+			byCost.insert(make_pair(children->at(i)->EstimateCost(), i));
+		}
+		multimap<unsigned int, unsigned int>::iterator costIterator;
+		for(costIterator = byCost.begin(); costIterator != byCost.end(); costIterator++) {
+			order.push_back(costIterator->second);
+		}
+	} else {
+		for(unsigned int i = 0; i < children->size(); i++) {
+			order.push_back(i);
+		}
+	}
+
 	IntVector results;
 
-	// loop through all childCriteria and call write method
-	AbsCriteriaVector::iterator iterator;
-	for(iterator = this->GetChildCriteria()->begin(); iterator != this->GetChildCriteria()->end(); iterator++) {
-		results.push_back((*iterator)->Analyze());
+	// loop through all childCriteria and call analyze method
+	vector<unsigned int>::iterator iterator;
+	for(iterator = order.begin(); iterator != order.end(); iterator++) {
+		results.push_back(children->at(*iterator)->Analyze());
+
+		if(Common::GetShortCircuitCriteria() && this->IsResultDecided(&results)) {
+			// the rest can not change the outcome
+			for(iterator++; iterator != order.end(); iterator++) {
+				results.push_back(children->at(*iterator)->SkipEvaluation());
+			}
+			break;
+		}
 	}
 
 	// apply the operator
@@ -288,3 +323,57 @@ OvalEnum::ResultEnumeration Criteria::NotEvaluated() {
 
 	return this->GetResult();
 }
+
+OvalEnum::ResultEnumeration Criteria::SkipEvaluation() {
+
+	AbsCriteriaVector::iterator iterator;
+	for(iterator = this->GetChildCriteria()->begin(); iterator != this->GetChildCriteria()->end(); iterator++) {
+		(*iterator)->SkipEvaluation();
+	}
+
+	// negating not evaluated is still not evaluated
+	this->SetResult(OvalEnum::RESULT_NOT_EVALUATED);
+
+	return this->GetResult();
+}
+
+unsigned int Criteria::EstimateCost() {
+
+	unsigned int cost = 0;
+
+	AbsCriteriaVector::iterator iterator;
+	for(iterator = this->GetChildCriteria()->begin(); iterator != this->GetChildCriteria()->end(); iterator++) {
+		cost += (*iterator)->EstimateCost();
+	}
+
+	return cost;
+}
+
+// ***************************************************************************************	//
+//								 Private members											//
+// ***************************************************************************************	//
+bool Criteria::IsResultDecided(IntVector* results) {
+
+	int trueCount = 0;
+	int falseCount = 0;
+	IntVector::iterator iterator;
+	for(iterator = results->begin(); iterator != results->end(); iterator++) {
+		if((*iterator) == OvalEnum::RESULT_TRUE) {
+			trueCount++;
+		} else if((*iterator) == OvalEnum::RESULT_FALSE) {
+			falseCount++;
+		}
+	}
+
+	// These match the cases in OvalEnum::CombineResultsByOperator that hold
+	// regardless of any other results. An xor always needs every result.
+	if(this->GetOperator() == OvalEnum::OPERATOR_AND) {
+		return falseCount > 0;
+	} else if(this->GetOperator() == OvalEnum::OPERATOR_OR) {
+		return trueCount > 0;
+	} else if(this->GetOperator() == OvalEnum::OPERATOR_ONE) {
+		return trueCount >= 2;
+	}
+
+	return false;
+}
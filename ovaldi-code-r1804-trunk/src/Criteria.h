@@ -57,6 +57,8 @@ public:
 	void Parse(xercesc::DOMElement* criteriaElm);
 	OvalEnum::ResultEnumeration Analyze();
 	OvalEnum::ResultEnumeration NotEvaluated();
+	OvalEnum::ResultEnumeration SkipEvaluation();
+	unsigned int EstimateCost();
 
 	std::string GetComment();
 	void SetComment(std::string comment);
@@ -69,6 +71,9 @@ public:
 	void AppendChildCriteria(AbsCriteria* childCriteria);
 
 private:
+	/** Return true if the operator result can no longer change no matter what the remaining children return. */
+	bool IsResultDecided(std::vector<int>* results);
+
 	std::string comment;
 	AbsCriteriaVector childCriteria;
 	OvalEnum::Operator op;
@@ -95,8 +95,12 @@ void Criterion::Write(DOMElement* parentElm) {
 		XmlCommon::AddAttribute(criterionElm, "applicability_check", "false");
 	// else, leave the attribute off
 
-	// write the test ref
-	this->GetTestRef()->Write(Analyzer::GetResultsSystemTestsElm());
+	// write the test ref. A test that was skipped by a short circuited criteria
+	// may still be analyzed for another definition, so it is written at the end
+	// of the analysis instead.
+	if(this->GetTestRef()->GetAnalyzed()) {
+		this->GetTestRef()->Write(Analyzer::GetResultsSystemTestsElm());
+	}
 }
 
 void Criterion::Parse(DOMElement* criterionElm) {
@@ -159,3 +163,16 @@ OvalEnum::ResultEnumeration Criterion::NotEvaluated() {
 
 	return this->GetResult();
 }
+
+OvalEnum::ResultEnumeration Criterion::SkipEvaluation() {
+
+	// negating not evaluated is still not evaluated
+	this->SetResult(OvalEnum::RESULT_NOT_EVALUATED);
+
+	return this->GetResult();
+}
+
+unsigned int Criterion::EstimateCost() {
+
+	return this->GetTestRef()->EstimateCost();
+}
@@ -64,6 +64,10 @@ public:
 	OvalEnum::ResultEnumeration Analyze();
 	/** Process the test as Not Evaluated. */
 	OvalEnum::ResultEnumeration NotEvaluated();
+	/** Mark the criterion as Not Evaluated without processing the referenced test. */
+	OvalEnum::ResultEnumeration SkipEvaluation();
+	/** Return the estimated cost of analyzing the referenced test. */
+	unsigned int EstimateCost();
 
 	/** Return the testRef field's value. */
 	Test* GetTestRef();
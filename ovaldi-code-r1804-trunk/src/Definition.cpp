@@ -188,6 +188,19 @@ void Definition::ClearCache() {
 	Definition::processedDefinitionsMap.clear();
 }
 
+void Definition::WriteNotEvaluated(DOMElement* parentElm) {
+
+	DefinitionMap::iterator iterator;
+	for(iterator = Definition::processedDefinitionsMap.begin(); iterator != Definition::processedDefinitionsMap.end(); iterator++) {
+		
+		Definition* def = iterator->second;
+		if(!def->GetWritten()) {
+			def->NotEvaluated();
+			def->Write(parentElm);
+		}
+	}
+}
+
 void Definition::Write(DOMElement* parentElm) {
 
 	if(!this->GetWritten()) {
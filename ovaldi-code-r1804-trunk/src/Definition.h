@@ -144,6 +144,12 @@ public:
 	/** Clear the cache of processed definitions. */
 	static void ClearCache();
 
+	/** Mark every cached definition that has not been written as not evaluated and write it.
+		Used at the end of the analysis to write out definitions that were only referenced 
+		by short circuited criteria.
+	*/
+	static void WriteNotEvaluated(xercesc::DOMElement* parent);
+
 	/** Return a definition object for the specified definition id.
 		First the cache of Definitions is checked. If the definition is
 		not found in the cache the definition is looked up in the
@@ -106,12 +106,14 @@ void Digest::Initialize() {
 	Digest::IsInitialized = true;
 }
 
-Digest::Digest() {
+Digest::Digest() : context(NULL) {
 	if (!Digest::IsInitialized)
 		Digest::Initialize();
 }
 
 Digest::~Digest(void) {
+	if (this->context != NULL)
+		freeDigest(this->context);
 }
 
 void Digest::initDigest(void **context, DigestType digestType) {
@@ -206,6 +208,33 @@ string Digest::digest(istream &in, DigestType digestType) {
 	return digestStr;
 }
 
+void Digest::start(DigestType digestType) {
+	if (this->context != NULL) {
+		freeDigest(this->context);
+		this->context = NULL;
+	}
+
+	initDigest(&this->context, digestType);
+}
+
+void Digest::update(const void *buf, size_t bufSize) {
+	if (this->context == NULL)
+		throw DigestException("A digest must be started before it can be updated");
+
+	updateDigest(this->context, const_cast<void*>(buf), bufSize);
+}
+
+string Digest::finish() {
+	if (this->context == NULL)
+		throw DigestException("A digest must be started before it can be finished");
+
+	string digestStr = getDigestResults(this->context);
+	freeDigest(this->context);
+	this->context = NULL;
+
+	return digestStr;
+}
+
 std::string Digest::hashBytesToString(unsigned char *bytes, size_t numBytes) {
 	ostringstream sstr;
 	sstr << setfill('0') << hex;
@@ -31,6 +31,7 @@
 #define DIGEST_H
 
 #include "Exception.h"
+#include "Noncopyable.h"
 #include <string>
 #include <iostream>
 
@@ -38,7 +39,7 @@
  * Encapsulates a message digest context.  Instances of this
  * class compute digests on any sort of data.
  */
-class Digest
+class Digest : private Noncopyable
 {
 public:
 	enum DigestType {
@@ -64,8 +65,29 @@ public:
 	 */
 	std::string digest(const std::string& fileName, DigestType digestType);
 
+	/**
+	 * Starts a digest that is fed piece by piece with update(), for data
+	 * that is being read for some other purpose anyway.  Any digest that
+	 * was started before and not finished is discarded.
+	 */
+	void start(DigestType digestType);
+
+	/**
+	 * Adds the given bytes to the digest started with start().
+	 */
+	void update(const void *buf, size_t bufSize);
+
+	/**
+	 * Finishes the digest started with start() and returns its value
+	 * as a hex string.
+	 */
+	std::string finish();
+
 private:
 
+	/** The context of the digest started with start(), NULL if there isn't one. */
+	void *context;
+
 	/**
 	 * libgcrypt requires a one-time initialization.
 	 */
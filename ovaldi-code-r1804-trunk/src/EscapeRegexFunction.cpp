@@ -50,8 +50,6 @@ using namespace xercesc;
 
 ComponentValue* EscapeRegexFunction::ComputeValue() {
 
-	StringVector* values = NULL;
-	
 	AbsComponent* component = this->GetComponents()->at(0);
 
 	ComponentValue* componentValue = component->ComputeValue();
@@ -63,15 +61,14 @@ ComponentValue* EscapeRegexFunction::ComputeValue() {
 
 	if(componentValue->GetFlag() == OvalEnum::FLAG_COMPLETE) {
 		REGEX regex;
-		values = new StringVector();;
+		const StringVector* inputValues = componentValue->GetValues();
+		StringVector* values = result->GetValues();
+		values->resize(inputValues->size());
 
-		StringVector::iterator iterator;
-		for(iterator = componentValue->GetValues()->begin(); iterator != componentValue->GetValues()->end(); iterator++) {
-			string currentValue = (*iterator);			
-			string newValue = regex.EscapeRegexChars(currentValue);
-			values->push_back(newValue);
+		// escape each value straight into its slot in the result
+		for(StringVector::size_type i = 0; i < inputValues->size(); i++) {
+			regex.EscapeRegexChars((*inputValues)[i], &(*values)[i]);
 		}
-		result->SetValues(values);
 	}
 
 	delete componentValue;
@@ -105,8 +105,12 @@ void ExtendedDefinition::Write(DOMElement* parentElm) {
 
 	XmlCommon::AddAttribute(extendedDefinitionElm, "result", OvalEnum::ResultToString(this->GetResult()));
 
-	// write the definition ref
-	this->GetDefinitionRef()->Write(Analyzer::GetResultsSystemDefinitionsElm());
+	// write the definition ref. A definition that was skipped by a short circuited
+	// criteria may still be analyzed later, so it is written at the end of the 
+	// analysis instead.
+	if(this->GetDefinitionRef()->GetAnalyzed()) {
+		this->GetDefinitionRef()->Write(Analyzer::GetResultsSystemDefinitionsElm());
+	}
 }
 
 void ExtendedDefinition::Parse(DOMElement* extendedDefinitionElm) {
@@ -165,3 +169,22 @@ OvalEnum::ResultEnumeration ExtendedDefinition::NotEvaluated() {
 	return this->GetResult();
 }
 
+OvalEnum::ResultEnumeration ExtendedDefinition::SkipEvaluation() {
+
+	// negating not evaluated is still not evaluated
+	this->SetResult(OvalEnum::RESULT_NOT_EVALUATED);
+
+	return this->GetResult();
+}
+
+unsigned int ExtendedDefinition::EstimateCost() {
+
+	Definition* definition = this->GetDefinitionRef();
+	if(definition->GetAnalyzed()) {
+		return 0;
+	} else if(definition->GetCriteria() == NULL) {
+		return 1;
+	} else {
+		return 1 + definition->GetCriteria()->EstimateCost();
+	}
+}
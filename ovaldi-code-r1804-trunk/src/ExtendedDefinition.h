@@ -66,6 +66,12 @@ public:
 	/** Mark this definition as not evaluated. */
 	OvalEnum::ResultEnumeration NotEvaluated();
 
+	/** Mark this extend_definition as not evaluated without processing the referenced definition. */
+	OvalEnum::ResultEnumeration SkipEvaluation();
+
+	/** Return the estimated cost of analyzing the referenced definition. */
+	unsigned int EstimateCost();
+
 	/** Return the definitionRef field's value. */
 	Definition* GetDefinitionRef();
 	/** Set the definitionRef field's value. */
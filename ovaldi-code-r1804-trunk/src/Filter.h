@@ -70,6 +70,12 @@ public:
 	 */
 	bool DoFilter(Item* item);	
 
+	/**
+	 * Returns the state this filter compares items to.
+	 */
+	State* GetState()
+	{ return state; }
+
 	/**
 	 * Get variable values used in the referenced state.
 	 */
@@ -0,0 +1,580 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#include <cstring>
+#include <fstream>
+
+#include <xercesc/dom/DOMNode.hpp>
+#include <xercesc/util/TransService.hpp>
+#include <xercesc/util/XMLString.hpp>
+
+#include "Log.h"
+
+#include "HtmlReport.h"
+
+using namespace std;
+using namespace xercesc;
+
+namespace {
+	/** The check and x symbols used for good and bad results. */
+	const char* RESULT_GOOD_SYMBOL = "&#x2713;";
+	const char* RESULT_BAD_SYMBOL = "&#x2715;";
+
+	const char* BAD_TITLE = "Non-Compliant/Vulnerable/Unpatched";
+	const char* GOOD_TITLE = "Compliant/Non-Vulnerable/Patched";
+	const char* OTHER_TITLE = "Inventory/Miscellaneous class, or Not Applicable/Not Evaluated result";
+
+	/** The base url of definitions in the oval repository. */
+	const char* REPOSITORY_ID_PREFIX = "oval:org.mitre.oval:def:";
+	const char* REPOSITORY_URL = "http://oval.mitre.org/repository/data/getDef?id=";
+}
+
+//****************************************************************************************//
+//									HtmlReport Class									  //	
+//****************************************************************************************//
+const char* HtmlReport::GROUP_CLASSES[HtmlReport::RESULT_GROUP_COUNT] = { "resultbad", "unknown", "error", "other", "resultgood" };
+
+void HtmlReport::Write(DOMDocument* resultsDoc, const string &outputFile) {
+
+	ofstream out(outputFile.c_str(), ios::out | ios::binary | ios::trunc);
+	if(!out) {
+		Log::Info("Unable to open " + outputFile + " to write the results html.");
+		return;
+	}
+
+	DOMElement* ovalResultsElm = resultsDoc->getDocumentElement();
+	DOMElement* ovalDefinitionsElm = HtmlReport::GetChild(ovalResultsElm, "oval_definitions");
+	DOMElement* definitionsElm = HtmlReport::GetChild(ovalDefinitionsElm, "definitions");
+
+	// index the definitions once so that each result can find its class, title and references
+	DefinitionIndex definitions;
+	vector<DOMElement*> definitionElms = HtmlReport::GetChildren(definitionsElm, "definition");
+	for(vector<DOMElement*>::iterator iterator = definitionElms.begin(); iterator != definitionElms.end(); iterator++)
+		definitions[HtmlReport::GetAttribute((*iterator), "id")] = (*iterator);
+
+	vector<DOMElement*> systemElms = HtmlReport::GetChildren(HtmlReport::GetChild(ovalResultsElm, "results"), "system");
+	SystemResultsVector systems(systemElms.size());
+	unsigned int totals[RESULT_GROUP_COUNT] = { 0, 0, 0, 0, 0 };
+	for(unsigned int i = 0; i < systemElms.size(); i++) {
+		HtmlReport::GroupResults(systemElms[i], definitions, systems[i]);
+		for(unsigned int group = 0; group < RESULT_GROUP_COUNT; group++)
+			totals[group] += systems[i].groups[group].size();
+	}
+
+	out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		<< "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Transitional//EN\" \"http://www.w3.org/TR/xhtml1/DTD/xhtml1-transitional.dtd\">\n"
+		<< "<!--\n"
+		<< "\t\tColor mapping\n"
+		<< "\t\tResult enumeration\n"
+		<< "\tClass       |t|f|u|e|na|ne|\n"
+		<< "\tcompliance  |G|R|B|Y|- |- |\n"
+		<< "\tinventory   |-|-|B|Y|- |- |\n"
+		<< "\tmisc        |-|-|B|Y|- |- |\n"
+		<< "\tpatch       |R|G|B|Y|- |- |\n"
+		<< "\tvuln        |R|G|B|Y|- |- |\n"
+		<< "\t\n"
+		<< "\tR = red\n"
+		<< "\tG = green\n"
+		<< "\tB = blue\n"
+		<< "\tY = yellow\n"
+		<< "\t- = grey\n"
+		<< "-->\n"
+		<< "<html>\n"
+		<< "<head>\n"
+		<< "<meta http-equiv=\"content-type\" content=\"text/html; charset=UTF-8\"/>\n"
+		<< "<title>OVAL Results</title>\n";
+	HtmlReport::WriteStyle(out);
+	out << "</head>\n"
+		<< "<body>\n";
+
+	// results and definition generator information
+	out << "<table class=\"noborder nomargin\">\n<tr>\n<td width=\"50%\">\n";
+	out << "<table border=\"1\">\n"
+		<< "<tr class=\"Title\">\n<td class=\"TitleLabel\" colspan=\"5\">OVAL Results Generator Information</td>\n</tr>\n";
+	HtmlReport::WriteGenerator(out, HtmlReport::GetChild(ovalResultsElm, "generator"));
+	out << "<tr class=\"DarkRow Center\">\n"
+		<< "<td class=\"SmallLabel\" style=\"width: 20%;\" title=\"" << BAD_TITLE << "\">#" << RESULT_BAD_SYMBOL << "</td>\n"
+		<< "<td class=\"SmallLabel\" style=\"width: 20%;\" title=\"" << GOOD_TITLE << "\">#" << RESULT_GOOD_SYMBOL << "</td>\n"
+		<< "<td class=\"SmallLabel\" style=\"width: 20%;\" title=\"Error\">#Error</td>\n"
+		<< "<td class=\"SmallLabel\" style=\"width: 20%;\" title=\"Unknown\">#Unknown</td>\n"
+		<< "<td class=\"SmallLabel\" style=\"width: 20%;\" title=\"" << OTHER_TITLE << "\">#Other</td>\n"
+		<< "</tr>\n"
+		<< "<tr class=\"LightRow Center\" style=\"height:auto;\">\n"
+		<< "<td class=\"SmallText resultbadB\" title=\"" << BAD_TITLE << "\" style=\"width:20%\">" << totals[RESULT_BAD] << "</td>\n"
+		<< "<td class=\"SmallText resultgoodB\" title=\"" << GOOD_TITLE << "\" style=\"width:20%\">" << totals[RESULT_GOOD] << "</td>\n"
+		<< "<td class=\"SmallText errorB\" title=\"Error\" style=\"width:20%\">" << totals[RESULT_ERROR] << "</td>\n"
+		<< "<td class=\"SmallText unknownB\" title=\"Unknown\" style=\"width:20%\">" << totals[RESULT_UNKNOWN] << "</td>\n"
+		<< "<td class=\"SmallText otherB\" title=\"" << OTHER_TITLE << "\" style=\"width:20%\">" << totals[RESULT_OTHER] << "</td>\n"
+		<< "</tr>\n"
+		<< "</table>\n";
+	out << "</td>\n<td width=\"50%\">\n";
+
+	out << "<table border=\"1\">\n"
+		<< "<tr class=\"Title\">\n<td class=\"TitleLabel\" colspan=\"5\">OVAL Definition Generator Information</td>\n</tr>\n";
+	HtmlReport::WriteGenerator(out, HtmlReport::GetChild(ovalDefinitionsElm, "generator"));
+	out << "<tr class=\"DarkRow Center\">\n"
+		<< "<td class=\"SmallLabel\" style=\"width: 20%;\">#Definitions</td>\n"
+		<< "<td class=\"SmallLabel\" style=\"width: 20%;\">#Tests</td>\n"
+		<< "<td class=\"SmallLabel\" style=\"width: 20%;\">#Objects</td>\n"
+		<< "<td class=\"SmallLabel\" style=\"width: 20%;\">#States</td>\n"
+		<< "<td class=\"SmallLabel\" style=\"width: 20%;\">#Variables</td>\n"
+		<< "</tr>\n"
+		<< "<tr class=\"LightRow Center\">\n"
+		<< "<td class=\"SmallText Center\">" << definitionElms.size() << " Total<br/>\n";
+	unsigned int classCounts[5] = { 0, 0, 0, 0, 0 };
+	const char* classes[5] = { "compliance", "inventory", "miscellaneous", "patch", "vulnerability" };
+	bool anyClass = false;
+	for(vector<DOMElement*>::iterator iterator = definitionElms.begin(); iterator != definitionElms.end(); iterator++) {
+		string definitionClass = HtmlReport::GetAttribute((*iterator), "class");
+		if(!definitionClass.empty())
+			anyClass = true;
+		for(unsigned int i = 0; i < 5; i++) {
+			if(definitionClass.compare(classes[i]) == 0)
+				classCounts[i]++;
+		}
+	}
+	if(anyClass) {
+		out << "<table class=\"noborder\">\n<tr class=\"Center\">\n";
+		for(unsigned int i = 0; i < 5; i++)
+			out << "<td class=\"SmallText Class" << classes[i] << "\" title=\"" << classes[i] << "\" style=\"width:20%\">" << classCounts[i] << "</td>\n";
+		out << "</tr>\n</table>\n";
+	}
+	out << "</td>\n"
+		<< "<td class=\"SmallText Center\">" << HtmlReport::CountChildren(HtmlReport::GetChild(ovalDefinitionsElm, "tests")) << "</td>\n"
+		<< "<td class=\"SmallText Center\">" << HtmlReport::CountChildren(HtmlReport::GetChild(ovalDefinitionsElm, "objects")) << "</td>\n"
+		<< "<td class=\"SmallText Center\">" << HtmlReport::CountChildren(HtmlReport::GetChild(ovalDefinitionsElm, "states")) << "</td>\n"
+		<< "<td class=\"SmallText Center\">" << HtmlReport::CountChildren(HtmlReport::GetChild(ovalDefinitionsElm, "variables")) << "</td>\n"
+		<< "</tr>\n"
+		<< "</table>\n";
+	out << "</td>\n</tr>\n</table>\n<hr/>\n";
+
+	// links to each system, only when there is more than one
+	if(systems.size() != 1) {
+		out << "<table border=\"1\">\n"
+			<< "<tr class=\"Title\">\n"
+			<< "<td class=\"TitleLabel\" align=\"center\">Systems Analyzed</td>\n"
+			<< "<td class=\"TitleLabel\" align=\"center\" title=\"" << BAD_TITLE << "\">" << RESULT_BAD_SYMBOL << "</td>\n"
+			<< "<td class=\"TitleLabel\" align=\"center\" title=\"" << GOOD_TITLE << "\">" << RESULT_GOOD_SYMBOL << "</td>\n"
+			<< "<td class=\"TitleLabel\" align=\"center\">Errors</td>\n"
+			<< "<td class=\"TitleLabel\" align=\"center\">Unknown</td>\n"
+			<< "<td class=\"TitleLabel\" align=\"center\" title=\"" << OTHER_TITLE << "\">Other</td>\n"
+			<< "</tr>\n";
+		for(unsigned int i = 0; i < systems.size(); i++) {
+			unsigned int position = i + 1;
+			string mod2 = (position % 2 == 1) ? "A" : "B";
+			DOMElement* sysInfoElm = HtmlReport::GetChild(HtmlReport::GetChild(systems[i].systemElm, "oval_system_characteristics"), "system_info");
+			out << "<tr class=\"" << ((position % 2 == 1) ? "DarkRow" : "LightRow") << "\">\n"
+				<< "<td class=\"Label\"><a class=\"Hover\" href=\"#a_" << position << "\">" << HtmlReport::Escape(HtmlReport::GetText(HtmlReport::GetChild(sysInfoElm, "primary_host_name"))) << "</a></td>\n"
+				<< "<td width=\"10\" class=\"resultbad" << mod2 << " Text\">" << systems[i].groups[RESULT_BAD].size() << "</td>\n"
+				<< "<td width=\"10\" class=\"resultgood" << mod2 << " Text\">" << systems[i].groups[RESULT_GOOD].size() << "</td>\n"
+				<< "<td width=\"10\" class=\"error" << mod2 << " Text\">" << systems[i].groups[RESULT_ERROR].size() << "</td>\n"
+				<< "<td width=\"10\" class=\"unknown" << mod2 << " Text\">" << systems[i].groups[RESULT_UNKNOWN].size() << "</td>\n"
+				<< "<td width=\"10\" class=\"other" << mod2 << " Text\">" << systems[i].groups[RESULT_OTHER].size() << "</td>\n"
+				<< "</tr>\n";
+		}
+		out << "</table>\n<br/>\n";
+	}
+
+	// the system information, the sc generator and the definition results of each system
+	for(unsigned int i = 0; i < systems.size(); i++) {
+		DOMElement* ovalScElm = HtmlReport::GetChild(systems[i].systemElm, "oval_system_characteristics");
+
+		HtmlReport::WriteSystemInfo(out, HtmlReport::GetChild(ovalScElm, "system_info"), i + 1);
+
+		out << "<table border=\"1\">\n"
+			<< "<tr class=\"Title\">\n<td class=\"TitleLabel\" colspan=\"5\">OVAL System Characteristics Generator Information</td>\n</tr>\n";
+		HtmlReport::WriteGenerator(out, HtmlReport::GetChild(ovalScElm, "generator"));
+		out << "</table>\n";
+
+		HtmlReport::WriteDefinitionResults(out, systems[i]);
+
+		if(i + 1 != systems.size())
+			out << "<hr/>\n";
+	}
+
+	out << "</body>\n"
+		<< "</html>\n";
+
+	out.close();
+	if(out.fail())
+		Log::Info("Error writing the results html to " + outputFile + ".");
+}
+
+void HtmlReport::GroupResults(DOMElement* systemElm, const DefinitionIndex &definitions, SystemResults &results) {
+
+	results.systemElm = systemElm;
+
+	// results are kept in document order within each group
+	vector<DOMElement*> resultElms = HtmlReport::GetChildren(HtmlReport::GetChild(systemElm, "definitions"), "definition");
+	for(vector<DOMElement*>::iterator iterator = resultElms.begin(); iterator != resultElms.end(); iterator++) {
+		DefinitionIndex::const_iterator definition = definitions.find(HtmlReport::GetAttribute((*iterator), "definition_id"));
+		DOMElement* definitionElm = (definition != definitions.end()) ? definition->second : NULL;
+
+		string definitionClass = (definitionElm != NULL) ? HtmlReport::GetAttribute(definitionElm, "class") : "";
+		ResultGroup group = HtmlReport::GetResultGroup(HtmlReport::GetAttribute((*iterator), "result"), definitionClass);
+		if(group != RESULT_NONE)
+			results.groups[group].push_back(DefinitionResult((*iterator), definitionElm));
+	}
+}
+
+HtmlReport::ResultGroup HtmlReport::GetResultGroup(const string &result, const string &definitionClass) {
+
+	bool patchOrVulnerability = (definitionClass.compare("patch") == 0 || definitionClass.compare("vulnerability") == 0);
+	bool compliance = (definitionClass.compare("compliance") == 0);
+	bool inventoryOrMisc = (definitionClass.compare("inventory") == 0 || definitionClass.compare("miscellaneous") == 0);
+
+	if(result.compare("true") == 0) {
+		if(patchOrVulnerability)
+			return RESULT_BAD;
+		if(compliance)
+			return RESULT_GOOD;
+		if(inventoryOrMisc)
+			return RESULT_OTHER;
+	} else if(result.compare("false") == 0) {
+		if(patchOrVulnerability)
+			return RESULT_GOOD;
+		if(compliance)
+			return RESULT_BAD;
+		if(inventoryOrMisc)
+			return RESULT_OTHER;
+	} else if(result.compare("unknown") == 0) {
+		return RESULT_UNKNOWN;
+	} else if(result.compare("error") == 0) {
+		return RESULT_ERROR;
+	} else if(result.compare("not applicable") == 0 || result.compare("not evaluated") == 0) {
+		return RESULT_OTHER;
+	}
+
+	// the xsl leaves out true and false results of definitions without a known class
+	return RESULT_NONE;
+}
+
+void HtmlReport::WriteStyle(ostream &out) {
+
+	out << "<style type=\"text/css\">\n"
+		<< "            table { border: 1px solid #000000; width: 100%; border-spacing: 0px; margin: 2px 0px;}\n"
+		<< "            .noborder {border: none;}\n"
+		<< "            .nomargin {margin: 0px;}\n"
+		<< "            td { padding: 0px 4px 1px 4px;}\n"
+		<< "            .SmallLabel { font-family: Geneva, Arial, Helvetica, sans-serif; color: #000000; font-size: 9pt; font-weight: bold; white-space: nowrap;}\n"
+		<< "            .SmallText { font-family: Geneva, Arial, Helvetica, sans-serif; color: #000000; font-size: 9pt;}\n"
+		<< "            .Label { font-family: Geneva, Arial, Helvetica, sans-serif; color: #000000; font-size: 10pt; font-weight: bold; white-space: nowrap;}\n"
+		<< "            .TitleLabel { font-family: Geneva, Arial, Helvetica, sans-serif; color: #ffffff; font-size: 10pt; font-weight: bold; white-space: nowrap;}\n"
+		<< "            .Text { font-family: Geneva, Arial, Helvetica, sans-serif; color: #000000; font-size: 10pt;}\n"
+		<< "            .Title { color: #FFFFFF; background-color: #706c60; padding: 0px 4px 1px 4px; font-size: 10pt; border-bottom: 1px solid #000000;}\n"
+		<< "            .Center { text-align: center;}\n"
+		<< "            \n"
+		<< "            a { color:#676c63;}\n"
+		<< "            a.Hover:hover { color:#7b0e0e; text-decoration:underline;}\n"
+		<< "            \n"
+		<< "            .LightRow { background-color: #FFFFFF;}\n"
+		<< "            .DarkRow { background-color: #DDDDD8;}\n"
+		<< "            \n"
+		<< "            .resultbadA{background-color: #FFBC8F;}\n"
+		<< "            .resultbadB{background-color: #FFE0CC;}\n"
+		<< "            .resultgoodA{background-color: #ACD685;}\n"
+		<< "            .resultgoodB{background-color: #CBE6B3;}\n"
+		<< "            .unknownA{background-color: #AEC8E0;}\n"
+		<< "            .unknownB{background-color: #DAE6F1;}\n"
+		<< "            .errorA{background-color: #FFDD75;}\n"
+		<< "            .errorB{background-color: #FFECB3;}\n"
+		<< "            .otherA{background-color: #EEEEEE;}\n"
+		<< "            .otherB{background-color: #FFFFFF;}\n"
+		<< "            \n"
+		<< "            .Classcompliance{background-color: #93C572;}\n"
+		<< "            .Classinventory{background-color: #AEC6CF;}\n"
+		<< "            .Classmiscellaneous{background-color: #9966CC;}\n"
+		<< "            .Classpatch{background-color: #FFDD75;}\n"
+		<< "            .Classvulnerability{background-color: #FF9966;}\n"
+		<< "            .ColorBox{width: 2px;}\n"
+		<< "\t\t</style>\n";
+}
+
+void HtmlReport::WriteResultColorTable(ostream &out) {
+
+	const char* labels[5] = { RESULT_BAD_SYMBOL, RESULT_GOOD_SYMBOL, "Error", "Unknown", "Other" };
+	const char* titles[5] = { BAD_TITLE, GOOD_TITLE, NULL, NULL, OTHER_TITLE };
+	const char* colorA[5] = { "resultbadA", "resultgoodA", "errorA", "unknownA", "DarkRow" };
+	const char* colorB[5] = { "resultbadB", "resultgoodB", "errorB", "unknownB", "LightRow" };
+
+	out << "<table class=\"noborder nomargin\" style=\"width:auto;\">\n<tr>\n";
+	for(unsigned int i = 0; i < 5; i++) {
+		out << "<td>\n<table border=\"1\">\n<tr class=\"LightRow\">\n"
+			<< "<td class=\"" << colorA[i] << " ColorBox\"/>\n"
+			<< "<td class=\"" << colorB[i] << " ColorBox\"/>\n"
+			<< "<td class=\"Text\"";
+		if(titles[i] != NULL)
+			out << " title=\"" << titles[i] << "\"";
+		out << ">" << labels[i] << "</td>\n"
+			<< "</tr>\n</table>\n</td>\n";
+	}
+	out << "</tr>\n</table>\n";
+}
+
+void HtmlReport::WriteGenerator(ostream &out, DOMElement* generatorElm) {
+
+	string timestamp = HtmlReport::GetText(HtmlReport::GetChild(generatorElm, "timestamp"));
+
+	out << "<tr class=\"DarkRow Center\">\n"
+		<< "<td class=\"SmallLabel\">Schema Version</td>\n"
+		<< "<td class=\"SmallLabel\">Product Name</td>\n"
+		<< "<td class=\"SmallLabel\">Product Version</td>\n"
+		<< "<td class=\"SmallLabel\">Date</td>\n"
+		<< "<td class=\"SmallLabel\">Time</td>\n"
+		<< "</tr>\n"
+		<< "<tr class=\"LightRow\">\n"
+		<< "<td class=\"SmallText\">" << HtmlReport::Escape(HtmlReport::GetText(HtmlReport::GetChild(generatorElm, "schema_version"))) << "</td>\n"
+		<< "<td class=\"SmallText\">" << HtmlReport::Escape(HtmlReport::GetText(HtmlReport::GetChild(generatorElm, "product_name"))) << "</td>\n"
+		<< "<td class=\"SmallText\">" << HtmlReport::Escape(HtmlReport::GetText(HtmlReport::GetChild(generatorElm, "product_version"))) << "</td>\n"
+		<< "<td class=\"SmallText\">" << HtmlReport::Escape(HtmlReport::Substring(timestamp, 1, 4) + "-" + HtmlReport::Substring(timestamp, 6, 2) + "-" + HtmlReport::Substring(timestamp, 9, 2)) << "</td>\n"
+		<< "<td class=\"SmallText\">" << HtmlReport::Escape(HtmlReport::Substring(timestamp, 12, 2) + ":" + HtmlReport::Substring(timestamp, 15, 2) + ":" + HtmlReport::Substring(timestamp, 18, 2)) << "</td>\n"
+		<< "</tr>\n";
+}
+
+void HtmlReport::WriteSystemInfo(ostream &out, DOMElement* sysInfoElm, unsigned int position) {
+
+	// anchor to this system, used when there is more than one system
+	out << "<a class=\"Hover\" name=\"a_" << position << "\" id=\"a_" << position << "\" style=\"text-decoration:none;\"/>\n"
+		<< "<table border=\"1\">\n"
+		<< "<tr class=\"Title\">\n<td class=\"TitleLabel\" colspan=\"2\">System Information</td>\n</tr>\n";
+
+	const char* labels[4] = { "Host Name", "Operating System", "Operating System Version", "Architecture" };
+	const char* elements[4] = { "primary_host_name", "os_name", "os_version", "architecture" };
+	for(unsigned int i = 0; i < 4; i++) {
+		out << "<tr class=\"" << ((i % 2 == 0) ? "DarkRow" : "LightRow") << "\">\n"
+			<< "<td class=\"Label\" width=\"20%\">" << labels[i] << "</td>\n"
+			<< "<td class=\"Text\" width=\"80%\">" << HtmlReport::Escape(HtmlReport::GetText(HtmlReport::GetChild(sysInfoElm, elements[i]))) << "</td>\n"
+			<< "</tr>\n";
+	}
+
+	out << "<tr class=\"DarkRow\">\n"
+		<< "<td class=\"Label\" width=\"20%\">Interfaces</td>\n"
+		<< "<td width=\"80%\">\n";
+	vector<DOMElement*> interfaceElms = HtmlReport::GetChildren(HtmlReport::GetChild(sysInfoElm, "interfaces"), "interface");
+	for(unsigned int i = 0; i < interfaceElms.size(); i++) {
+		const char* rowClass = (i % 2 == 0) ? "LightRow" : "DarkRow";
+		out << "<table border=\"1\">\n"
+			<< "<tr class=\"" << rowClass << "\">\n"
+			<< "<td class=\"Label\" width=\"20%\">Interface Name</td>\n"
+			<< "<td class=\"Text\" width=\"80%\">" << HtmlReport::Escape(HtmlReport::GetText(HtmlReport::GetChild(interfaceElms[i], "interface_name"))) << "</td>\n"
+			<< "</tr>\n"
+			<< "<tr class=\"" << rowClass << "\">\n"
+			<< "<td class=\"Label\" width=\"20%\">IP Address</td>\n"
+			<< "<td class=\"Text\" width=\"80%\">" << HtmlReport::Escape(HtmlReport::GetText(HtmlReport::GetChild(interfaceElms[i], "ip_address"))) << "</td>\n"
+			<< "</tr>\n"
+			<< "<tr class=\"" << rowClass << "\">\n"
+			<< "<td class=\"Label\" width=\"20%\">MAC Address</td>\n"
+			<< "<td class=\"Text\" width=\"80%\">" << HtmlReport::Escape(HtmlReport::GetText(HtmlReport::GetChild(interfaceElms[i], "mac_address"))) << "</td>\n"
+			<< "</tr>\n"
+			<< "</table>\n";
+	}
+	out << "</td>\n"
+		<< "</tr>\n"
+		<< "</table>\n";
+}
+
+void HtmlReport::WriteDefinitionResults(ostream &out, const SystemResults &results) {
+
+	out << "<table border=\"1\">\n"
+		<< "<tr class=\"Title\">\n<td class=\"TitleLabel\" colspan=\"5\">OVAL Definition Results</td>\n</tr>\n"
+		<< "<tr class=\"DarkRow\">\n<td colspan=\"5\">\n";
+	HtmlReport::WriteResultColorTable(out);
+	out << "</td>\n</tr>\n"
+		<< "<tr class=\"TitleLabel\">\n"
+		<< "<td class=\"Title\" align=\"center\">ID</td>\n"
+		<< "<td class=\"Title\" align=\"center\">Result</td>\n"
+		<< "<td class=\"Title\" align=\"center\">Class</td>\n"
+		<< "<td class=\"Title\" align=\"center\">Reference ID</td>\n"
+		<< "<td class=\"Title\" align=\"center\">Title</td>\n"
+		<< "</tr>\n";
+
+	for(unsigned int group = 0; group < RESULT_GROUP_COUNT; group++) {
+		const DefinitionResultVector &definitions = results.groups[group];
+		for(unsigned int i = 0; i < definitions.size(); i++)
+			HtmlReport::WriteDefinition(out, definitions[i], (ResultGroup)group, i + 1);
+	}
+
+	out << "</table>\n";
+}
+
+void HtmlReport::WriteDefinition(ostream &out, const DefinitionResult &definition, ResultGroup group, unsigned int position) {
+
+	DOMElement* resultElm = definition.first;
+	DOMElement* definitionElm = definition.second;
+	DOMElement* metadataElm = HtmlReport::GetChild(definitionElm, "metadata");
+
+	string definitionId = HtmlReport::GetAttribute(resultElm, "definition_id");
+
+	// set results to alternating colors
+	out << "<tr class=\"" << GROUP_CLASSES[group] << ((position % 2 == 1) ? "A" : "B") << "\">\n";
+
+	// id, with a link if it is an oval repository id
+	out << "<td class=\"Text\" align=\"center\">";
+	if(definitionId.compare(0, strlen(REPOSITORY_ID_PREFIX), REPOSITORY_ID_PREFIX) == 0)
+		out << "<a class=\"Hover\" target=\"_blank\" href=\"" << REPOSITORY_URL << HtmlReport::Escape(definitionId) << "\">" << HtmlReport::Escape(definitionId) << "</a>";
+	else
+		out << HtmlReport::Escape(definitionId);
+	out << "</td>\n";
+
+	out << "<td class=\"Text\" align=\"center\">" << HtmlReport::Escape(HtmlReport::GetAttribute(resultElm, "result")) << "</td>\n";
+	out << "<td class=\"Text\" align=\"center\">" << HtmlReport::Escape(HtmlReport::GetAttribute(definitionElm, "class")) << "</td>\n";
+
+	// references, only shown as links if they have a url
+	out << "<td class=\"Text\" align=\"center\">";
+	vector<DOMElement*> referenceElms = HtmlReport::GetChildren(metadataElm, "reference");
+	for(unsigned int i = 0; i < referenceElms.size(); i++) {
+		string refId = HtmlReport::Escape(HtmlReport::GetAttribute(referenceElms[i], "ref_id"));
+		XMLCh* refUrlName = XMLString::transcode("ref_url");
+		bool hasUrl = referenceElms[i]->hasAttribute(refUrlName);
+		XMLString::release(&refUrlName);
+		out << "[";
+		if(hasUrl)
+			out << "<a class=\"Hover\" target=\"_blank\" href=\"" << HtmlReport::Escape(HtmlReport::GetAttribute(referenceElms[i], "ref_url")) << "\">" << refId << "</a>";
+		else
+			out << refId;
+		out << "]";
+		if(i + 1 != referenceElms.size())
+			out << ", ";
+	}
+	out << "</td>\n";
+
+	out << "<td class=\"Text\">" << HtmlReport::Escape(HtmlReport::GetText(HtmlReport::GetChild(metadataElm, "title"))) << "</td>\n";
+	out << "</tr>\n";
+}
+
+DOMElement* HtmlReport::GetChild(DOMElement* parent, const char* localName) {
+
+	if(parent == NULL)
+		return NULL;
+
+	XMLCh* name = XMLString::transcode(localName);
+	DOMElement* found = NULL;
+	for(DOMNode* child = parent->getFirstChild(); child != NULL && found == NULL; child = child->getNextSibling()) {
+		if(child->getNodeType() == DOMNode::ELEMENT_NODE && XMLString::equals(HtmlReport::GetLocalName(child), name))
+			found = (DOMElement*)child;
+	}
+	XMLString::release(&name);
+
+	return found;
+}
+
+vector<DOMElement*> HtmlReport::GetChildren(DOMElement* parent, const char* localName) {
+
+	vector<DOMElement*> found;
+	if(parent == NULL)
+		return found;
+
+	XMLCh* name = XMLString::transcode(localName);
+	for(DOMNode* child = parent->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+		if(child->getNodeType() == DOMNode::ELEMENT_NODE && XMLString::equals(HtmlReport::GetLocalName(child), name))
+			found.push_back((DOMElement*)child);
+	}
+	XMLString::release(&name);
+
+	return found;
+}
+
+const XMLCh* HtmlReport::GetLocalName(DOMNode* node) {
+
+	// elements created without a namespace have no local name
+	const XMLCh* name = node->getLocalName();
+	if(name == NULL)
+		name = node->getNodeName();
+
+	return name;
+}
+
+unsigned int HtmlReport::CountChildren(DOMElement* parent) {
+
+	unsigned int count = 0;
+	if(parent == NULL)
+		return count;
+
+	for(DOMNode* child = parent->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+		if(child->getNodeType() == DOMNode::ELEMENT_NODE)
+			count++;
+	}
+
+	return count;
+}
+
+string HtmlReport::GetText(DOMElement* elm) {
+
+	if(elm == NULL)
+		return "";
+
+	return HtmlReport::ToUTF8(elm->getTextContent());
+}
+
+string HtmlReport::GetAttribute(DOMElement* elm, const char* name) {
+
+	if(elm == NULL)
+		return "";
+
+	XMLCh* attName = XMLString::transcode(name);
+	string value = HtmlReport::ToUTF8(elm->getAttribute(attName));
+	XMLString::release(&attName);
+
+	return value;
+}
+
+string HtmlReport::Substring(const string &str, string::size_type start, string::size_type length) {
+
+	if(start < 1 || start > str.length())
+		return "";
+
+	return str.substr(start - 1, length);
+}
+
+string HtmlReport::Escape(const string &str) {
+
+	string escaped;
+	escaped.reserve(str.length());
+	for(string::const_iterator iterator = str.begin(); iterator != str.end(); iterator++) {
+		switch(*iterator) {
+			case '&': escaped.append("&amp;"); break;
+			case '<': escaped.append("&lt;"); break;
+			case '>': escaped.append("&gt;"); break;
+			case '"': escaped.append("&quot;"); break;
+			default: escaped.push_back(*iterator); break;
+		}
+	}
+
+	return escaped;
+}
+
+string HtmlReport::ToUTF8(const XMLCh* str) {
+
+	if(str == NULL)
+		return "";
+
+	TranscodeToStr utf8(str, "UTF-8");
+	return string((const char*)utf8.str(), utf8.length());
+}
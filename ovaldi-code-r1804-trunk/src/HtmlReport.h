@@ -0,0 +1,115 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifndef HTMLREPORT_H
+#define HTMLREPORT_H
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+
+/**
+	This class writes the html summary of an OVAL Results document without going through
+	the results xsl.
+
+	The html is the same as results_to_html.xsl produces: the generator information, the
+	system information and a table of the definition results with the bad results first,
+	then unknown, error and other results and the good results last. It is written in a
+	single pass over the definition results, using an index of the definitions built up
+	front, so large results documents don't need an xsl processor or a second copy of 
+	the document in memory.
+*/
+class HtmlReport {
+public:
+
+	/** 
+		Write the html summary of the specified results document to the specified file.
+		Errors are logged and leave the report incomplete rather than stopping the run.
+	*/
+	static void Write(xercesc::DOMDocument* resultsDoc, const std::string &outputFile);
+
+private:
+
+	/** The groups the definition results are shown in, in the order they are shown. */
+	enum ResultGroup { RESULT_BAD = 0, RESULT_UNKNOWN, RESULT_ERROR, RESULT_OTHER, RESULT_GOOD, RESULT_GROUP_COUNT, RESULT_NONE };
+
+	/** A definition result element paired with the definition it is for. */
+	typedef std::pair<xercesc::DOMElement*, xercesc::DOMElement*> DefinitionResult;
+	typedef std::vector<DefinitionResult> DefinitionResultVector;
+	typedef std::map<std::string, xercesc::DOMElement*> DefinitionIndex;
+
+	/** The definition results of one system, sorted into their groups. */
+	struct SystemResults {
+		xercesc::DOMElement* systemElm;
+		DefinitionResultVector groups[RESULT_GROUP_COUNT];
+	};
+	typedef std::vector<SystemResults> SystemResultsVector;
+
+	/** Sort each definition result of the system into its group. */
+	static void GroupResults(xercesc::DOMElement* systemElm, const DefinitionIndex &definitions, SystemResults &results);
+
+	/** Return the group for a result of a definition of the specified class. */
+	static ResultGroup GetResultGroup(const std::string &result, const std::string &definitionClass);
+
+	static void WriteStyle(std::ostream &out);
+	static void WriteResultColorTable(std::ostream &out);
+	static void WriteGenerator(std::ostream &out, xercesc::DOMElement* generatorElm);
+	static void WriteSystemInfo(std::ostream &out, xercesc::DOMElement* sysInfoElm, unsigned int position);
+	static void WriteDefinitionResults(std::ostream &out, const SystemResults &results);
+	static void WriteDefinition(std::ostream &out, const DefinitionResult &definition, ResultGroup group, unsigned int position);
+
+	/** Return the first child element with the specified local name, or NULL. */
+	static xercesc::DOMElement* GetChild(xercesc::DOMElement* parent, const char* localName);
+	/** Return all child elements with the specified local name. */
+	static std::vector<xercesc::DOMElement*> GetChildren(xercesc::DOMElement* parent, const char* localName);
+	/** Return the local name of the node, or its name if it has no namespace. */
+	static const XMLCh* GetLocalName(xercesc::DOMNode* node);
+	/** Return the number of child elements. */
+	static unsigned int CountChildren(xercesc::DOMElement* parent);
+	/** Return the text of the element, as UTF-8. An empty string if the element is NULL. */
+	static std::string GetText(xercesc::DOMElement* elm);
+	/** Return the value of the attribute, as UTF-8. */
+	static std::string GetAttribute(xercesc::DOMElement* elm, const char* name);
+	/** Return the substring the xpath substring() function would, with a 1 based start. */
+	static std::string Substring(const std::string &str, std::string::size_type start, std::string::size_type length);
+	/** Escape the markup characters in text or an attribute value. */
+	static std::string Escape(const std::string &str);
+	/** Transcode to UTF-8. */
+	static std::string ToUTF8(const XMLCh* str);
+
+	static const char* GROUP_CLASSES[RESULT_GROUP_COUNT];
+};
+
+#endif
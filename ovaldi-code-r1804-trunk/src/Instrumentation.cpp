@@ -0,0 +1,332 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifdef WIN32
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/time.h>
+	#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "CollectionDeadline.h"
+#include "Common.h"
+#include "Exception.h"
+
+#include "Instrumentation.h"
+
+using namespace std;
+
+//****************************************************************************************//
+//								Instrumentation Class									  //	
+//****************************************************************************************//
+bool Instrumentation::enabled = false;
+Instrumentation::Sample Instrumentation::runStart;
+unsigned long long Instrumentation::fileSystemCalls = 0;
+Instrumentation::NamedMeasurementVector Instrumentation::phases;
+map<string, Instrumentation::Sample> Instrumentation::openPhases;
+Instrumentation::NamedMeasurementVector Instrumentation::probes;
+vector<pair<Instrumentation::NamedMeasurement, string> > Instrumentation::objects;
+vector<Instrumentation::OpenObject> Instrumentation::openObjects;
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  Public Members  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+void Instrumentation::Enable() {
+
+	if(!Instrumentation::enabled) {
+		Instrumentation::enabled = true;
+		Instrumentation::runStart = Instrumentation::TakeSample();
+	}
+}
+
+bool Instrumentation::IsEnabled() {
+	return Instrumentation::enabled;
+}
+
+Instrumentation::Phase::Phase(const string &name) : name(name) {
+	Instrumentation::StartPhase(this->name);
+}
+
+Instrumentation::Phase::~Phase() {
+	Instrumentation::StopPhase(this->name);
+}
+
+void Instrumentation::StartPhase(const string &phase) {
+
+	if(!Instrumentation::enabled)
+		return;
+
+	Instrumentation::openPhases[phase] = Instrumentation::TakeSample();
+}
+
+void Instrumentation::StopPhase(const string &phase) {
+
+	if(!Instrumentation::enabled)
+		return;
+
+	map<string, Sample>::iterator iterator = Instrumentation::openPhases.find(phase);
+	if(iterator == Instrumentation::openPhases.end())
+		return;
+
+	Instrumentation::Accumulate(Instrumentation::Find(&Instrumentation::phases, phase), iterator->second, Instrumentation::TakeSample(), 0);
+	Instrumentation::openPhases.erase(iterator);
+}
+
+void Instrumentation::StartObject(const string &objectId, const string &probe) {
+
+	if(!Instrumentation::enabled)
+		return;
+
+	OpenObject object;
+	object.id = objectId;
+	object.probe = probe;
+	object.start = Instrumentation::TakeSample();
+	Instrumentation::openObjects.push_back(object);
+}
+
+void Instrumentation::StopObject(unsigned int itemCount) {
+
+	if(!Instrumentation::enabled || Instrumentation::openObjects.empty())
+		return;
+
+	Sample end = Instrumentation::TakeSample();
+	OpenObject object = Instrumentation::openObjects.back();
+	Instrumentation::openObjects.pop_back();
+
+	Measurement measurement;
+	Instrumentation::Accumulate(&measurement, object.start, end, itemCount);
+	Instrumentation::objects.push_back(make_pair(make_pair(object.id, measurement), object.probe));
+
+	// the objects in a set are already counted under their own probe
+	Measurement own = measurement;
+	Instrumentation::Subtract(&own, object.nested);
+	Instrumentation::Add(Instrumentation::Find(&Instrumentation::probes, object.probe), own);
+
+	if(!Instrumentation::openObjects.empty())
+		Instrumentation::Add(&Instrumentation::openObjects.back().nested, measurement);
+}
+
+void Instrumentation::RecordFileSystemCall() {
+	Instrumentation::fileSystemCalls++;
+}
+
+void Instrumentation::WriteReport(const string &filename) {
+
+	if(!Instrumentation::enabled)
+		return;
+
+	ofstream out(filename.c_str());
+	if(!out)
+		throw Exception("Unable to open the instrumentation report file: " + filename);
+
+	Measurement total;
+	Instrumentation::Accumulate(&total, Instrumentation::runStart, Instrumentation::TakeSample(), 0);
+
+	out << "{" << endl;
+	out << "  \"total\": {";
+	Instrumentation::WriteMeasurement(out, total);
+	out << "}," << endl;
+
+	out << "  \"phases\": [";
+	for(NamedMeasurementVector::iterator iterator = Instrumentation::phases.begin(); iterator != Instrumentation::phases.end(); iterator++) {
+		out << (iterator == Instrumentation::phases.begin() ? "" : ",") << endl;
+		out << "    {\"name\": \"" << Instrumentation::Escape(iterator->first) << "\", ";
+		Instrumentation::WriteMeasurement(out, iterator->second);
+		out << "}";
+	}
+	out << endl << "  ]," << endl;
+
+	out << "  \"probes\": [";
+	for(NamedMeasurementVector::iterator iterator = Instrumentation::probes.begin(); iterator != Instrumentation::probes.end(); iterator++) {
+		out << (iterator == Instrumentation::probes.begin() ? "" : ",") << endl;
+		out << "    {\"name\": \"" << Instrumentation::Escape(iterator->first) << "\", ";
+		Instrumentation::WriteMeasurement(out, iterator->second);
+		out << "}";
+	}
+	out << endl << "  ]," << endl;
+
+	out << "  \"objects\": [";
+	for(vector<pair<NamedMeasurement, string> >::iterator iterator = Instrumentation::objects.begin(); iterator != Instrumentation::objects.end(); iterator++) {
+		out << (iterator == Instrumentation::objects.begin() ? "" : ",") << endl;
+		out << "    {\"id\": \"" << Instrumentation::Escape(iterator->first.first) << "\", \"probe\": \"" << Instrumentation::Escape(iterator->second) << "\", ";
+		Instrumentation::WriteMeasurement(out, iterator->first.second);
+		out << "}";
+	}
+	out << endl << "  ]" << endl;
+	out << "}" << endl;
+
+	out.close();
+	if(out.fail())
+		throw Exception("Unable to write the instrumentation report file: " + filename);
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  Private Members  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+Instrumentation::Sample Instrumentation::TakeSample() {
+
+	Sample sample;
+	sample.wallTime = CollectionDeadline::Now();
+	sample.cpuTime = Instrumentation::GetCpuTime();
+	sample.fileSystemCalls = Instrumentation::fileSystemCalls;
+	sample.peakMemory = Instrumentation::GetPeakMemory();
+	return sample;
+}
+
+void Instrumentation::Accumulate(Measurement *measurement, const Sample &start, const Sample &end, unsigned int items) {
+
+	measurement->count++;
+	measurement->wallTime += end.wallTime - start.wallTime;
+	measurement->cpuTime += end.cpuTime - start.cpuTime;
+	measurement->items += items;
+	measurement->fileSystemCalls += end.fileSystemCalls - start.fileSystemCalls;
+	if(end.peakMemory > measurement->peakMemory)
+		measurement->peakMemory = end.peakMemory;
+	if(end.peakMemory > start.peakMemory)
+		measurement->peakMemoryGrowth += end.peakMemory - start.peakMemory;
+}
+
+void Instrumentation::Add(Measurement *measurement, const Measurement &other) {
+
+	measurement->count += other.count;
+	measurement->wallTime += other.wallTime;
+	measurement->cpuTime += other.cpuTime;
+	measurement->items += other.items;
+	measurement->fileSystemCalls += other.fileSystemCalls;
+	if(other.peakMemory > measurement->peakMemory)
+		measurement->peakMemory = other.peakMemory;
+	measurement->peakMemoryGrowth += other.peakMemoryGrowth;
+}
+
+void Instrumentation::Subtract(Measurement *measurement, const Measurement &other) {
+
+	// the count, items and peak memory belong to the measurement alone
+	measurement->wallTime -= min(measurement->wallTime, other.wallTime);
+	measurement->cpuTime -= min(measurement->cpuTime, other.cpuTime);
+	measurement->fileSystemCalls -= min(measurement->fileSystemCalls, other.fileSystemCalls);
+	measurement->peakMemoryGrowth -= min(measurement->peakMemoryGrowth, other.peakMemoryGrowth);
+}
+
+Instrumentation::Measurement* Instrumentation::Find(NamedMeasurementVector *measurements, const string &name) {
+
+	// there are only a handful of phases and probe types, a linear search keeps them in order
+	for(NamedMeasurementVector::iterator iterator = measurements->begin(); iterator != measurements->end(); iterator++) {
+		if(iterator->first == name)
+			return &iterator->second;
+	}
+
+	measurements->push_back(make_pair(name, Measurement()));
+	return &measurements->back().second;
+}
+
+unsigned long long Instrumentation::GetCpuTime() {
+
+#ifdef WIN32
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if(!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+		return 0;
+
+	// FILETIMEs count 100 nanosecond intervals
+	unsigned long long kernel = ((unsigned long long)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
+	unsigned long long user = ((unsigned long long)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime;
+	return (kernel + user) / 10000;
+#else
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+	return (unsigned long long)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 
+		+ (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+#endif
+}
+
+unsigned long long Instrumentation::GetPeakMemory() {
+
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return counters.PeakWorkingSetSize / 1024;
+#else
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+	#ifdef DARWIN
+		// reported in bytes
+		return usage.ru_maxrss / 1024;
+	#else
+		// reported in kilobytes, solaris does not fill it in at all
+		return usage.ru_maxrss;
+	#endif
+#endif
+}
+
+void Instrumentation::WriteMeasurement(ostream &out, const Measurement &measurement) {
+
+	out << "\"count\": " << measurement.count 
+		<< ", \"wall_ms\": " << measurement.wallTime 
+		<< ", \"cpu_ms\": " << measurement.cpuTime 
+		<< ", \"items\": " << measurement.items 
+#ifndef WIN32
+		// only the unix probes go through TimedFileOps, which does the counting
+		<< ", \"file_system_calls\": " << measurement.fileSystemCalls 
+#endif
+		<< ", \"peak_memory_kb\": " << measurement.peakMemory 
+		<< ", \"peak_memory_growth_kb\": " << measurement.peakMemoryGrowth;
+}
+
+string Instrumentation::Escape(const string &str) {
+
+	string escaped;
+	escaped.reserve(str.length());
+	for(string::const_iterator iterator = str.begin(); iterator != str.end(); iterator++) {
+		unsigned char c = (unsigned char)(*iterator);
+		if(c == '"' || c == '\\') {
+			escaped += '\\';
+			escaped += (char)c;
+		} else if(c < 0x20) {
+			ostringstream code;
+			code << "\\u" << hex << setw(4) << setfill('0') << (int)c;
+			escaped += code.str();
+		} else {
+			escaped += (char)c;
+		}
+	}
+
+	return escaped;
+}
@@ -0,0 +1,172 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Noncopyable.h"
+
+/**
+	This class measures where the time and memory of a run go and writes them out as a 
+	JSON report.
+
+	Measurements are kept for each phase of the run (parsing, collection, writing the system 
+	characteristics, analysis, directives, xsl, ...), for each collected object and for each 
+	probe type, named after the object element the probe collects (file_object, ...). Each 
+	measurement holds the wall clock time, the cpu time of the process, the number of items 
+	collected, the number of file system calls made (unix only, the Windows probes do not go 
+	through TimedFileOps) and the peak memory of the process. The time spent collecting an 
+	object that is nested in a set object is counted under the nested object's probe, not 
+	under the probe of the object that holds the set.
+
+	Nothing is measured until Enable() has been called, so the calls sprinkled through the 
+	code cost next to nothing on a normal run.
+*/
+class Instrumentation {
+public:
+
+	/** Start measuring. Everything before this call is not part of the report. */
+	static void Enable();
+
+	/** Return true if measurements are being taken. */
+	static bool IsEnabled();
+
+	/**
+		Times the named phase for as long as it is in scope, so that the phase is still 
+		stopped when an exception is thrown out of it.
+	*/
+	class Phase : private Noncopyable {
+	public:
+		explicit Phase(const std::string &name);
+		~Phase();
+	private:
+		std::string name;
+	};
+
+	/** Start timing the named phase. Phases that are run more than once are added up. */
+	static void StartPhase(const std::string &phase);
+
+	/** Stop timing the named phase. */
+	static void StopPhase(const std::string &phase);
+
+	/** Start timing the collection of an object. The probe is named after the object's element. */
+	static void StartObject(const std::string &objectId, const std::string &probe);
+
+	/** Stop timing the object most recently started and record the number of items it produced. */
+	static void StopObject(unsigned int itemCount);
+
+	/** Count a file system call made on behalf of the current object and phase. */
+	static void RecordFileSystemCall();
+
+	/** Write the report to the specified file. An Exception is thrown if the file can't be written. */
+	static void WriteReport(const std::string &filename);
+
+private:
+
+	/** A point in time as seen by the process. */
+	struct Sample {
+		unsigned long long wallTime;
+		unsigned long long cpuTime;
+		unsigned long long fileSystemCalls;
+		unsigned long long peakMemory;
+	};
+
+	/** What was used between two samples, summed over every time it was measured. */
+	struct Measurement {
+		Measurement() : count(0), wallTime(0), cpuTime(0), items(0), fileSystemCalls(0), peakMemory(0), peakMemoryGrowth(0) {}
+		unsigned int count;
+		unsigned long long wallTime;
+		unsigned long long cpuTime;
+		unsigned long long items;
+		unsigned long long fileSystemCalls;
+		unsigned long long peakMemory;
+		unsigned long long peakMemoryGrowth;
+	};
+
+	typedef std::pair<std::string, Measurement> NamedMeasurement;
+	typedef std::vector<NamedMeasurement> NamedMeasurementVector;
+
+	/** An object whose collection has been started but not stopped yet. */
+	struct OpenObject {
+		std::string id;
+		std::string probe;
+		Sample start;
+		/** What the objects collected while this one was being collected used. */
+		Measurement nested;
+	};
+
+	/** Take a sample of the current state of the process. */
+	static Sample TakeSample();
+
+	/** Add what was used since start to the measurement. */
+	static void Accumulate(Measurement *measurement, const Sample &start, const Sample &end, unsigned int items);
+
+	/** Add one measurement to another. */
+	static void Add(Measurement *measurement, const Measurement &other);
+
+	/** Take what other used away from the measurement, stopping at 0. */
+	static void Subtract(Measurement *measurement, const Measurement &other);
+
+	/** Return the named measurement, adding it to the end of the list if it isn't there yet. */
+	static Measurement* Find(NamedMeasurementVector *measurements, const std::string &name);
+
+	/** Return the user plus system cpu time of the process in milliseconds. */
+	static unsigned long long GetCpuTime();
+
+	/** Return the peak memory of the process in kilobytes, 0 if it isn't known. */
+	static unsigned long long GetPeakMemory();
+
+	/** Write the fields of a measurement as the members of a JSON object. */
+	static void WriteMeasurement(std::ostream &out, const Measurement &measurement);
+
+	/** Escape a string for use in a JSON document. */
+	static std::string Escape(const std::string &str);
+
+	static bool enabled;
+	static Sample runStart;
+	static unsigned long long fileSystemCalls;
+
+	static NamedMeasurementVector phases;
+	static std::map<std::string, Sample> openPhases;
+
+	static NamedMeasurementVector probes;
+	/** Every collected object in the order it was collected, with the probe that collected it. */
+	static std::vector<std::pair<NamedMeasurement, std::string> > objects;
+	/** The objects being collected, innermost last. */
+	static std::vector<OpenObject> openObjects;
+};
+
+#endif
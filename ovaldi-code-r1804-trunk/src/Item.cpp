@@ -37,6 +37,7 @@
 #include "XmlCommon.h"
 #include "Common.h"
 #include "DocumentManager.h"
+#include "SystemCharacteristicsIndex.h"
 #include <StringEntityValue.h>
 #include <ItemFieldEntityValue.h>
 
@@ -511,8 +512,7 @@ Item* Item::GetItemById(string itemId) {
 	// if not found try to parse it.
 	if(item == NULL) {
 
-		DOMElement* systemDataElm = XmlCommon::FindElement(DocumentManager::GetSystemCharacteristicsDocument(), "system_data");
-		DOMElement* itemElm = XmlCommon::FindElementByAttribute(systemDataElm, "id", itemId); // TODO - is there a faster search method to use???
+		DOMElement* itemElm = SystemCharacteristicsIndex::GetItem(itemId);
 
 		if(itemElm == NULL) {
 			throw Exception("Unable to find specified item in system-characteristics document. Item id: " + itemId);
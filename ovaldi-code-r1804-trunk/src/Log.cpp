@@ -29,6 +29,8 @@
 //****************************************************************************************//
 
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
 
 #include "Common.h"
 #include "Exception.h"
@@ -42,19 +44,35 @@ int Log::level = Log::DEBUG;
 bool Log::toScreen = true;
 bool Log::initialized = false;
 string Log::logFilename = "";
-ofstream Log::logFile;
+FILE* Log::logFile = NULL;
+char Log::buffer[Log::BUFFER_SIZE];
+size_t Log::bufferLength = 0;
+time_t Log::timeStampTime = 0;
+string Log::timeStamp = "";
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  Public Members  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 void Log::Shutdown() {
 
-    if(Log::logFile.is_open())
-        Log::logFile.close();
+	if(Log::logFile != NULL) {
+		Log::Flush();
+		fclose(Log::logFile);
+		Log::logFile = NULL;
+	}
 
 	Log::initialized = false;
 }
 
+void Log::Flush() {
+
+	if(Log::logFile != NULL && Log::bufferLength > 0) {
+		fwrite(Log::buffer, 1, Log::bufferLength, Log::logFile);
+		fflush(Log::logFile);
+		Log::bufferLength = 0;
+	}
+}
+
 void Log::Init(int level, string logFile, bool toScreen) {
 
 	if(!Log::initialized) {
@@ -69,12 +87,22 @@ void Log::Init(int level, string logFile, bool toScreen) {
 		Log::toScreen = toScreen;
 
 		// Reset the log file
-		Log::logFile.open(logFilename.c_str(), ios::trunc | ios::out);
+		Log::logFile = fopen(logFilename.c_str(), "w");
 
-        if(!Log::logFile.is_open() || Log::logFile.fail()) {
-            Log::logFile.close();
-            throw Exception("Error initializing log system. Unable to clear log file.");
-        }
+		if(Log::logFile == NULL) {
+			throw Exception("Error initializing log system. Unable to clear log file.");
+		}
+
+		// messages are buffered here, so the stream itself does not need to be
+		setvbuf(Log::logFile, NULL, _IONBF, 0);
+		Log::bufferLength = 0;
+
+		// the exit() calls that skip Shutdown() must not lose the buffered messages
+		static bool flushAtExitRegistered = false;
+		if(!flushAtExitRegistered) {
+			atexit(Log::FlushAtExit);
+			flushAtExitRegistered = true;
+		}
 
 		Log::initialized = true;
 	}
@@ -84,10 +112,7 @@ void Log::UnalteredMessage(string msg) {
 	if(!Log::initialized)
 		throw Exception("The logging system must first be initialized.");
 
-	bool tmp = Log::toScreen;
-	Log::toScreen = false;
-    Log::logFile << msg << endl;
-	Log::toScreen = tmp;
+	Log::WriteLog(msg, true);
 }
 
 void Log::Debug(string msg, bool fileOnly) {
@@ -95,7 +120,7 @@ void Log::Debug(string msg, bool fileOnly) {
 		throw Exception("The logging system must first be initialized.");
 
 	if(Log::IsDebug()) {
-		msg = Common::GetTimeStamp() + " : DEBUG : " + msg;
+		msg = Log::GetTimeStamp() + " : DEBUG : " + msg;
 		Log::WriteLog(msg, fileOnly);
 	}
 }
@@ -105,7 +130,7 @@ void Log::Info(string msg) {
 		throw Exception("The logging system must first be initialized.");
 
 	if(Log::IsInfo()) {
-		msg = Common::GetTimeStamp() + " : INFO : " + msg;
+		msg = Log::GetTimeStamp() + " : INFO : " + msg;
 		Log::WriteLog(msg);
 	}
 }
@@ -115,7 +140,7 @@ void Log::Message(string msg) {
 		throw Exception("The logging system must first be initialized.");
 
 	if(Log::IsMessage()) {
-		msg = Common::GetTimeStamp() + " : MESSAGE : " + msg;
+		msg = Log::GetTimeStamp() + " : MESSAGE : " + msg;
 		Log::WriteLog(msg);
 	}
 }
@@ -125,8 +150,11 @@ void Log::Fatal(string msg) {
 		throw Exception("The logging system must first be initialized.");
 
 	if(Log::IsFatal()) {
-		msg = Common::GetTimeStamp() + " : FATAL : " + msg;
+		msg = Log::GetTimeStamp() + " : FATAL : " + msg;
 		Log::WriteLog(msg);
+
+		// the process is likely about to give up, don't keep the message waiting
+		Log::Flush();
 	}
 }
 
@@ -183,8 +211,22 @@ bool Log::WriteToScreen() {
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 void Log::WriteLog(string logMessageIn, bool fileOnly) {
 
-    Log::logFile << logMessageIn << endl;
-    Log::logFile.flush();
+	size_t needed = logMessageIn.length() + 1;
+	if(Log::bufferLength + needed > Log::BUFFER_SIZE)
+		Log::Flush();
+
+	if(needed > Log::BUFFER_SIZE) {
+		// too big to ever fit, write it straight out
+		if(Log::logFile != NULL) {
+			fwrite(logMessageIn.data(), 1, logMessageIn.length(), Log::logFile);
+			fputc('\n', Log::logFile);
+			fflush(Log::logFile);
+		}
+	} else {
+		memcpy(Log::buffer + Log::bufferLength, logMessageIn.data(), logMessageIn.length());
+		Log::buffer[Log::bufferLength + logMessageIn.length()] = '\n';
+		Log::bufferLength += needed;
+	}
 
 	if(Log::toScreen && !fileOnly) {
 		cout << logMessageIn << endl;
@@ -211,3 +253,19 @@ string Log::LevelToString(int level) {
 
 	return levelStr;
 }
+
+const string& Log::GetTimeStamp() {
+
+	// the stamp only has a resolution of seconds, so most messages can share it
+	time_t now = time(NULL);
+	if(now != Log::timeStampTime || Log::timeStamp.empty()) {
+		Log::timeStamp = Common::GetTimeStamp();
+		Log::timeStampTime = now;
+	}
+
+	return Log::timeStamp;
+}
+
+void Log::FlushAtExit() {
+	Log::Flush();
+}
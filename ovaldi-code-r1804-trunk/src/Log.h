@@ -31,7 +31,8 @@
 #ifndef LOG_H
 #define LOG_H
 
-#include <fstream>
+#include <cstdio>
+#include <ctime>
 #include <string>
 
 /** 
@@ -42,6 +43,13 @@
 	For example, if the log system is configured such that the current Logg::level
 	is Log::INFO then Log::INFO level messages and above will be displayed. This means
 	that Log::MESSAGE and Log::FATAL will be displayed, but not Log::DEBUG.
+
+	Messages bound for the log file are collected in a fixed size buffer and written 
+	out when the buffer fills, when a Log::FATAL message is logged, when Flush() or 
+	Shutdown() is called and when the process exits normally.
+
+	Callers that build a message in a loop should check the level first, for example 
+	with IsDebug(), so that no string is built for a message that will be dropped.
 */
 class Log {
 public:
@@ -58,9 +66,14 @@ public:
 	*/
 	static void Init(int level = DEBUG, std::string logFile = "", bool toScreen = false);
 
-	/** Shutdown the logger. Simply has to close the log file. */
+	/** Shutdown the logger. Writes out any buffered messages and closes the log file. */
 	static void Shutdown();
 
+	/** Write out any buffered messages. This must be called before forking so that a child 
+		process does not inherit, and later write, the parent's buffered messages.
+	*/
+	static void Flush();
+
 	/** Write the specified message at Log::DEBUG level.
 
 		@param msg The message to write
@@ -141,11 +154,25 @@ private:
 	/** Convert the level to a string. */
 	static std::string LevelToString(int level);
 
+	/** Return the current time stamp. It is only rebuilt when the time has changed. */
+	static const std::string& GetTimeStamp();
+
+	/** Called at exit to write out any buffered messages. */
+	static void FlushAtExit();
+
 	static std::string logFilename;
 	static int level;
 	static bool toScreen;
 	static bool initialized;
-    static std::ofstream logFile;
+	static FILE* logFile;
+
+	/** The number of bytes of messages held before they are written to the log file. */
+	static const size_t BUFFER_SIZE = 64 * 1024;
+	static char buffer[BUFFER_SIZE];
+	static size_t bufferLength;
+
+	static time_t timeStampTime;
+	static std::string timeStamp;
 
 };
 
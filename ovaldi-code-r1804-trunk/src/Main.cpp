@@ -32,6 +32,7 @@
 #include <time.h>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -40,6 +41,13 @@
 #ifdef WIN32
 	#include <comdef.h>
 	#include "WindowsCommon.h"
+#else
+	#include <cerrno>
+	#include <cstring>
+	#include <sys/types.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+	#include "TimedFileOps.h"
 #endif
 
 #include "Digest.h"
@@ -47,15 +55,22 @@
 #include "AbsDataCollector.h"
 #include "Version.h"
 #include "Analyzer.h"
+#include "Definition.h"
+#include "Test.h"
+#include "State.h"
 #include "DocumentManager.h"
 #include "DataCollector.h"
 #include "XslCommon.h"
+#include "HtmlReport.h"
 #include "XmlCommon.h"
 #include "EntityComparator.h"
 #include "OvalEnum.h"
 #include "Directive.h"
+#include "AbsVariable.h"
 #include "Log.h"
 #include "Noncopyable.h"
+#include "Instrumentation.h"
+#include "PreviousScan.h"
 
 #define EXIT_SUCCESS	0
 #define	EXIT_FAILURE	1
@@ -89,6 +104,51 @@ namespace {
 	 */
 	bool SchematronValidate(const string &fileToValidate, const string &schematronXSLFile);
 
+	/**
+	 * Same as SchematronValidate(const string&, const string&), but validates a document
+	 * that is already held in memory instead of reading it from a file.
+	 */
+	bool SchematronValidate(XslSource &sourceToValidate, const string &schematronXSLFile);
+
+	/**
+	 * Reports the output of a schematron validation.
+	 * \return true if there were no errors in the output.
+	 */
+	bool ReportSchematronResult(string result);
+
+	/**
+	 * Analyzes the definitions against the current system characteristics document, then
+	 * applies directives and writes the results to resultsFile. Results validation and the
+	 * results xsl are run as requested on the command line.
+	 * \return false if validation of the results failed.
+	 */
+	bool RunAnalysis(XmlProcessor* processor, StringVector* ids, const string &resultsFile, const string &xslOutputFile);
+
+	/**
+	 * Analyzes each system characteristics file listed in the batch file against the
+	 * definitions that were already parsed and validated. Each file gets its own results
+	 * file next to it. On unix the files are spread over the requested number of
+	 * worker processes; otherwise they are analyzed one after another.
+	 */
+	void RunBatchAnalysis(XmlProcessor* processor, StringVector* ids);
+
+	/**
+	 * Parse one system characteristics file, analyze it, and release its documents.
+	 * \return true if the file was analyzed and its results written.
+	 */
+	bool AnalyzeBatchFile(XmlProcessor* processor, StringVector* ids, const string &scFile);
+
+	/**
+	 * Parses every definition and test, and every state that does not reference a
+	 * variable, so that batch workers inherit them instead of each parsing them again.
+	 * States with a var_ref are left alone since their variables can be computed from
+	 * the items in a system characteristics file.
+	 */
+	void ParseSharedDefinitions();
+
+	/** \return true if elm or any element below it has a var_ref attribute. */
+	bool ReferencesVariable(DOMElement* elm);
+
 	/**
 	 * Enables exception-safe init/de-init of Xerces.
 	 */
@@ -98,6 +158,8 @@ namespace {
 			XMLPlatformUtils::Initialize();
 		}
 		~XercesInitializer() {
+			// the xsl processor holds xerces resources, so it has to go first
+			XslCommon::Shutdown();
 			XMLPlatformUtils::Terminate();
 		}
 	};
@@ -172,6 +234,10 @@ int main(int argc, char* argv[]) {
 	/////////  Parse Command-line Options  ///////////////
 	//////////////////////////////////////////////////////
 	ProcessCommandLine(argc, argv);
+
+	// start measuring right away so that the report covers the whole run
+	if(!Common::GetInstrumentationFile().empty())
+		Instrumentation::Enable();
 	
 	//////////////////////////////////////////////////////
 	/////////  Initialize the Log System  ////////////////
@@ -285,6 +351,9 @@ int main(int argc, char* argv[]) {
 	//////////////////////////////////////////////////////
 	string logMessage = "";
 
+	// The hash is computed from the same read of the file that the parser does, and
+	// checked as soon as the file has been parsed, before anything is done with it.
+	Digest* xmlfileDigest = NULL;
 	if (Common::GetVerifyXMLfile() == true) {
 
 		logMessage = " ** verifying the MD5 hash of '";
@@ -294,49 +363,8 @@ int main(int argc, char* argv[]) {
 		cout << logMessage;
 		Log::UnalteredMessage(logMessage);
 
-		// Open the xmlfile so we can pass it to the MD5 hash routine.  Make sure we open
-		// it in binary mode.  If not, ctrl+m characters will be stripped before computing
-		// the hash, resulting in the wrong hash being produced.
-
-		ifstream in(Common::GetXMLfile().c_str(), ios::in|ios::binary);
-		if (!in) {
-			string errorMessage = "";
-			errorMessage.append("Unable to open the '");
- 			errorMessage.append(Common::GetXMLfile());
-			errorMessage.append("' file to verify it.  The program will terminate.\n");
-			cerr << "\nERROR: " << errorMessage;
-			Log::Fatal(errorMessage);
-
-			exit( EXIT_FAILURE );
-		}
-
-		// Create the md5 hash.  This constructor creates a new md5 object, updates the
-		// hash, finalizes the hash, and closes the FILE object.
-		
-		Digest digest;
-
-		string hashBuf = digest.digest(in, Digest::MD5);
-
-		// Compare (without regard to case) the MD5 hash we just created with the one
-		// given by the user.  If the two do not match, then exit the application.  Make
-		// sure we compare in both directions.  _strnicmp only checks that the first X
-		// characters of string2 are the same as the first X characters of string1.
-		// This means that without the second check, if the supplied datafile hash is only
-		// the first character of the real hash, then the test will succeed.
-
-		if (!Common::EqualsIgnoreCase(hashBuf, Common::GetXMLfileMD5()))
-		{
-			string errorMessage = "";
-
-			errorMessage.append("The '");
-			errorMessage.append(Common::GetXMLfile());
-			errorMessage.append("' file is not match the provided MD5 hash.  The program will terminate.\n");
-
-			cerr << "ERROR: " << errorMessage;
-			Log::Fatal(errorMessage);
-
-			exit( EXIT_FAILURE );
-		}
+		xmlfileDigest = new Digest();
+		xmlfileDigest->start(Digest::MD5);
 	}
 
 	// Important: gotta initialize Xerces to do any XML processing!
@@ -361,11 +389,45 @@ int main(int argc, char* argv[]) {
 		#ifdef _DEBUG
 			parseStart = GetTickCount();
 		#endif
-		DocumentManager::SetDefinitionDocument(processor->ParseFile(Common::GetXMLfile()));
+		{
+			Instrumentation::Phase phase("parse definitions");
+			DocumentManager::SetDefinitionDocument(processor->ParseFile(Common::GetXMLfile(), xmlfileDigest));
+		}
 		#ifdef _DEBUG
 			parseEnd = GetTickCount();
 		#endif
 
+		//////////////////////////////////////////////////////
+		///////////////  Verify oval.xml file - MD5  /////////
+		//////////////////////////////////////////////////////
+		if (xmlfileDigest != NULL) {
+
+			string hashBuf = xmlfileDigest->finish();
+			delete xmlfileDigest;
+			xmlfileDigest = NULL;
+
+			// Compare (without regard to case) the MD5 hash we just created with the one
+			// given by the user.  If the two do not match, then exit the application.  Make
+			// sure we compare in both directions.  _strnicmp only checks that the first X
+			// characters of string2 are the same as the first X characters of string1.
+			// This means that without the second check, if the supplied datafile hash is only
+			// the first character of the real hash, then the test will succeed.
+
+			if (!Common::EqualsIgnoreCase(hashBuf, Common::GetXMLfileMD5()))
+			{
+				string errorMessage = "";
+
+				errorMessage.append("The '");
+				errorMessage.append(Common::GetXMLfile());
+				errorMessage.append("' file is not match the provided MD5 hash.  The program will terminate.\n");
+
+				cerr << "ERROR: " << errorMessage;
+				Log::Fatal(errorMessage);
+
+				exit( EXIT_FAILURE );
+			}
+		}
+
 		//////////////////////////////////////////////////////
 		///////  Check the version of the xml schema	//////
 		//////////////////////////////////////////////////////
@@ -421,8 +483,27 @@ int main(int argc, char* argv[]) {
 		//  Get a data file									//
 		//		- either run collector or parse input file	//
 		//////////////////////////////////////////////////////
+		// get the list of definitions to evaluate, if any. The same list limits both 
+		// the data collection and the analysis.
+		StringVector* ids = NULL;
+		if(Common::GetLimitEvaluationToDefinitionIds()) {
+			string idFile = Common::GetDefinitionIdsFile();
+			
+			if(idFile.compare("") != 0) {
+				ids = Common::ParseDefinitionIdsFile();	
+			} else {
+				ids = Common::ParseDefinitionIdsString();				
+			}
+		}
+
+		if(Common::GetBatchFile().compare("") != 0) {
+
+			// every listed system characteristics file is parsed and analyzed on its own
+			Instrumentation::Phase phase("batch analysis");
+			RunBatchAnalysis(processor, ids);
+
 		//	Run the collector if desired
-		if(!Common::GetUseProvidedData()) {
+		} else if(!Common::GetUseProvidedData()) {
 
 			//	Create a new data document
 			logMessage = " ** creating a new OVAL System Characteristics file.\n";
@@ -444,7 +525,21 @@ int main(int argc, char* argv[]) {
 				collectionStart = GetTickCount();
 			#endif
 
-			dataCollector->Run();
+			{
+				Instrumentation::Phase phase("collect");
+				if(ids != NULL && ids->size() != 0) {
+					dataCollector->Run(ids);
+				} else {
+					dataCollector->Run();
+				}
+			}
+
+			if(!Common::GetPreviousDatafile().empty()) {
+				logMessage = " ** reused the items of " + Common::ToString(PreviousScan::GetReusedCount()) + " objects from " + Common::GetPreviousDatafile() + ".\n";
+				cout << logMessage;
+				Log::UnalteredMessage(logMessage);
+				PreviousScan::Clear();
+			}
 
 			// DEBUG
 			#ifdef _DEBUG
@@ -457,17 +552,29 @@ int main(int argc, char* argv[]) {
 			logMessage = " ** saving data model to " + Common::GetDatafile() +".\n";
 			cout << logMessage;
 			Log::UnalteredMessage(logMessage);
-			processor->WriteDOMDocument(DocumentManager::GetSystemCharacteristicsDocument(), Common::GetDatafile());
+			auto_ptr<MemBufFormatTarget> systemCharacteristics;
+			{
+				Instrumentation::Phase phase("write system characteristics");
+				if (Common::GetDoSystemCharacteristicsSchematron()) {
+					systemCharacteristics.reset(new MemBufFormatTarget());
+					processor->WriteAndSerializeDOMDocument(DocumentManager::GetSystemCharacteristicsDocument(), Common::GetDatafile(), systemCharacteristics.get());
+				} else {
+					processor->WriteDOMDocument(DocumentManager::GetSystemCharacteristicsDocument(), Common::GetDatafile());
+				}
+			}
 
-			// Verify what we just wrote, if requested
+			// Verify what we just wrote, if requested. The xml that was written is
+			// validated from memory rather than read back from the file.
 			if (Common::GetDoSystemCharacteristicsSchematron()) {
 				logMessage = " ** running XML-Schema validation on "+Common::GetDatafile()+"\n";
 				cout << logMessage;
 				Log::UnalteredMessage(logMessage);
 				// create the DOM document and then immediately destroy it,
 				// for the purposes of generating validation errors
-				processor->ParseFile(Common::GetDatafile(), true)->release();
-				if (!SchematronValidate(Common::GetDatafile(), Common::GetSystemCharacteristicsSchematronPath()))
+				processor->ParseBuffer(*systemCharacteristics, Common::GetDatafile(), true)->release();
+				XslSource systemCharacteristicsSource(*systemCharacteristics, Common::GetDatafile());
+				systemCharacteristics.reset();
+				if (!SchematronValidate(systemCharacteristicsSource, Common::GetSystemCharacteristicsSchematronPath()))
 					exit(EXIT_FAILURE);
 			}
 
@@ -480,107 +587,32 @@ int main(int argc, char* argv[]) {
 			Log::UnalteredMessage(logMessage);
 
 			//	Parse the data file
+			Instrumentation::Phase phase("parse system characteristics");
 			DocumentManager::SetSystemCharacteristicsDocument(processor->ParseFile(Common::GetDatafile()));
 		}
 		
 		//////////////////////////////////////////////////////
 		///////////////		Run Analysis		//////////////
 		//////////////////////////////////////////////////////
+		if(Common::GetBatchFile().compare("") == 0) {
 
-		// create a results document
-		DocumentManager::SetResultDocument(processor->CreateDOMDocumentNS("http://oval.mitre.org/XMLSchema/oval-results-5", "oval_results"));
-
-		//	Create the analyzer
-		Analyzer* analyzer = new Analyzer();
-
-		//	Output status
-		logMessage = " ** running the OVAL Definition analysis.\n";
-		cout << logMessage;
-		Log::UnalteredMessage(logMessage);
-
-		#ifdef _DEBUG
-			analysisStart = GetTickCount();
-		#endif
-		
-		//	run the analyzer
-		if(Common::GetLimitEvaluationToDefinitionIds()){
-
-            logMessage = " ** running the OVAL Definition analysis.\n";
-		    cout << logMessage;
-		    Log::UnalteredMessage(logMessage);
-
-			string idFile = Common::GetDefinitionIdsFile();
-
-			StringVector* ids = NULL;
-			
-			if(idFile.compare("") != 0) {
-				ids = Common::ParseDefinitionIdsFile();	
-			} else {
-				ids = Common::ParseDefinitionIdsString();				
-			}
+			#ifdef _DEBUG
+				analysisStart = GetTickCount();
+			#endif
 
-            if(ids->size() == 0) {
-                delete ids;
-                string errorMessage = "The list of definition ids to evaluate was empty. Verify that the appropriate command line arguments were used.";
-                cout << errorMessage << endl;
-                Log::Info(errorMessage);
+			if(!RunAnalysis(processor, ids, Common::GetOutputFilename(), Common::GetXSLOutputFilename()))
+				exit(EXIT_FAILURE);
 
-            } else {
-			    analyzer->Run(ids);
-                delete ids;
-            }
-			
-		} else {
-			analyzer->Run();
+			#ifdef _DEBUG
+				analysisEnd = GetTickCount();
+			#endif
 		}
 
-		#ifdef _DEBUG
-			analysisEnd = GetTickCount();
-		#endif
-
-
-		// Apply Directives
-		logMessage = " ** applying directives to OVAL results.\n";
-		cout << logMessage;
-		Log::UnalteredMessage(logMessage);
-		Directive::ApplyAll(DocumentManager::GetResultDocument());
-
-		// print the results 
-		analyzer->PrintResults();
-
-		//	write the result document
-		logMessage = " ** saving OVAL results to " + Common::GetOutputFilename() + ".\n";
-		cout << logMessage;
-		Log::UnalteredMessage(logMessage);
-		processor->WriteDOMDocument(DocumentManager::GetResultDocument(), Common::GetOutputFilename());
-
-		delete analyzer;
-
-		if (Common::GetDoResultsSchematron()) {
-			logMessage = " ** running XML-Schema validation on "+Common::GetOutputFilename()+"\n";
-			cout << logMessage;
-			Log::UnalteredMessage(logMessage);
-			// create the DOM document and then immediately destroy it,
-			// for the purposes of generating validation errors
-			processor->ParseFile(Common::GetOutputFilename(), true)->release();
-			if (!SchematronValidate(Common::GetOutputFilename(), Common::GetResultsSchematronPath()))
-				exit(EXIT_FAILURE);
-		}
+		if(ids != NULL)
+			delete ids;
 
 		delete processor;
 
-		// run the xsl
-		if(!Common::GetNoXsl()) {
-			logMessage = " ** running OVAL Results xsl: " + Common::GetXSLFilename() + ".\n";
-			cout << logMessage;
-			Log::UnalteredMessage(logMessage);
-			XslCommon::ApplyXSL(Common::GetOutputFilename(), Common::GetXSLFilename(), Common::GetXSLOutputFilename());
-		} else {
-			logMessage = " ** skipping OVAL Results xsl\n";
-			cout << logMessage;
-			Log::UnalteredMessage(logMessage);
-		}
-
 	} catch(Exception ex) {
 		cout << ex.GetErrorMessage() << endl;
 		Log::Fatal(ex.GetErrorMessage());
@@ -589,6 +621,21 @@ int main(int argc, char* argv[]) {
 		}
 	}
 
+	//////////////////////////////////////////////////////
+	//////////////  Instrumentation Report  //////////////
+	//////////////////////////////////////////////////////
+	if(Instrumentation::IsEnabled()) {
+		string logMessage = " ** saving instrumentation report to " + Common::GetInstrumentationFile() + ".\n";
+		cout << logMessage;
+		Log::UnalteredMessage(logMessage);
+		try {
+			Instrumentation::WriteReport(Common::GetInstrumentationFile());
+		} catch(Exception ex) {
+			cout << ex.GetErrorMessage() << endl;
+			Log::Info(ex.GetErrorMessage());
+		}
+	}
+
 	//////////////////////////////////////////////////////
 	///////////////////  Print Footer  ///////////////////
 	//////////////////////////////////////////////////////
@@ -812,6 +859,13 @@ void ProcessCommandLine(int argc, char* argv[]) {
 					}
 
 					break;
+
+				// **********  write the results html without the xsl  ********** //
+				case 'H':
+
+					Common::SetNativeHtml(true);
+
+					break;
 				
 				// **********  write ovaldi.log to a specific location  ***************** //
 				case 'y':
@@ -925,6 +979,143 @@ void ProcessCommandLine(int argc, char* argv[]) {
 
 					break;
 
+				// **********  batch analysis of system characteristics files  ********** //
+				case 'b':
+
+					if ((argc < 3) || (argv[2][0] == '-')) {
+						Usage();
+						exit( EXIT_FAILURE );
+					} else {
+						Common::SetBatchFile(argv[2]);
+						Common::SetUseProvidedData(true);
+						++argv;
+						--argc;
+					}
+
+					break;
+
+				// **********  number of worker processes  ********** //
+				case 'w':
+
+					if ((argc < 3) || (argv[2][0] == '-')) {
+						Usage();
+						exit( EXIT_FAILURE );
+					} else {
+						unsigned int workers = 0;
+						if(!Common::FromString(argv[2], &workers) || workers == 0) {
+							Usage();
+							exit( EXIT_FAILURE );
+						}
+						Common::SetWorkerCount(workers);
+						++argv;
+						--argc;
+					}
+
+					break;
+
+				// **********  analyze definitions while collecting  ********** //
+				case 'A':
+
+					Common::SetPipelineAnalysis(true);
+
+					break;
+
+				// **********  xml document cache size  ********** //
+				case 'u':
+
+					if ((argc < 3) || (argv[2][0] == '-')) {
+						Usage();
+						exit( EXIT_FAILURE );
+					} else {
+						unsigned int megabytes = 0;
+						if(!Common::FromString(argv[2], &megabytes)) {
+							Usage();
+							exit( EXIT_FAILURE );
+						}
+						Common::SetXmlDocumentCacheSize(megabytes);
+						++argv;
+						--argc;
+					}
+
+					break;
+
+				// **********  file system call timeout  ********** //
+				case 'n':
+
+					if ((argc < 3) || (argv[2][0] == '-')) {
+						Usage();
+						exit( EXIT_FAILURE );
+					} else {
+						unsigned int seconds = 0;
+						if(!Common::FromString(argv[2], &seconds)) {
+							Usage();
+							exit( EXIT_FAILURE );
+						}
+						Common::SetCallTimeout(seconds);
+						++argv;
+						--argc;
+					}
+
+					break;
+
+				// **********  object collection timeout  ********** //
+				case 'N':
+
+					if ((argc < 3) || (argv[2][0] == '-')) {
+						Usage();
+						exit( EXIT_FAILURE );
+					} else {
+						unsigned int seconds = 0;
+						if(!Common::FromString(argv[2], &seconds)) {
+							Usage();
+							exit( EXIT_FAILURE );
+						}
+						Common::SetObjectTimeout(seconds);
+						++argv;
+						--argc;
+					}
+
+					break;
+
+				// **********  previous system characteristics file  ********** //
+				case 'I':
+
+					if ((argc < 3) || (argv[2][0] == '-')) {
+						Usage();
+						exit( EXIT_FAILURE );
+					} else {
+						Common::SetPreviousDatafile(argv[2]);
+						++argv;
+						--argc;
+					}
+
+					break;
+
+				// **********  instrumentation report  ********** //
+				case 'P':
+
+					if ((argc < 3) || (argv[2][0] == '-')) {
+						Usage();
+						exit( EXIT_FAILURE );
+					} else {
+						Common::SetInstrumentationFile(argv[2]);
+						++argv;
+						--argc;
+					}
+
+					break;
+
+				// **********  short circuit criteria evaluation  ********** //
+				case 'q':
+					Common::SetShortCircuitCriteria(true);
+					if ( argc > 2 && string(argv[2]).compare("cost") == 0 ) { //also analyze the cheapest criteria first
+						Common::SetOrderCriteriaByCost(true);
+						++argv;
+						--argc;
+					}
+
+					break;
+
 				// **********  Default  ********** //
 				default:
 
@@ -993,6 +1184,9 @@ void ProcessCommandLine(int argc, char* argv[]) {
 	outputs.push_back(Common::GetFullPath(Common::GetOutputFilename()));
 	outputs.push_back(Common::GetFullPath(Common::GetXSLOutputFilename()));
 	outputs.push_back(Common::GetFullPath(Common::GetLogFileLocation()));
+	if (!Common::GetInstrumentationFile().empty()) {
+		outputs.push_back(Common::GetFullPath(Common::GetInstrumentationFile()));
+	}
 
 	if (Common::GetDoDefinitionSchematron()) {
 		inputs.push_back(Common::GetFullPath(Common::GetDefinitionSchematronPath()));
@@ -1048,6 +1242,7 @@ void Usage() {
 	cout << "   -v <string>  = path to external variable values file. DEFAULT=\"external-variables.xml\"" << endl;
 	cout << "   -e <string>  = evaluate the specified list of definitions. Supply definition ids as a comma separated list like: oval:com.example:def:123" << endl;
 	cout << "   -f <string>  = path to a file containing a list of definitions to be evaluated. The file must comply with the evaluation-id schema." << endl;
+	cout << "   -q [cost]    = stop analyzing a criteria once its result is decided and mark the remaining criteria as not evaluated. With \"cost\", the cheapest criteria are also analyzed first." << endl;
 	cout << "\n";
 	
 	cout << "Input Validation Options:" << endl;
@@ -1058,6 +1253,13 @@ void Usage() {
 	cout << "Data Collection Options:" << endl;
 	cout << "   -a <string>  = path to the directory that contains the OVAL schema. DEFAULT=\"" << defaultSchemaPath << "\"" << endl;
 	cout << "   -i <string>  = path to input System Characteristics file. Evaluation will be based on the contents of the file." << endl;
+	cout << "   -b <string>  = path to a file listing input System Characteristics files, one per line. Each file is evaluated and its results are saved next to it as <name>-results.xml." << endl;
+	cout << "   -w <integer> = number of worker processes to use for a batch, or for the analysis of a single file. Unix only. DEFAULT=1" << endl;
+	cout << "   -A           = analyze each definition in a worker process as soon as its objects are collected, while collection continues. Uses up to -w workers. Unix only." << endl;
+	cout << "   -u <integer> = megabytes of parsed xml files to keep in memory for xmlfilecontent objects. 0 disables the cache. DEFAULT=64" << endl;
+	cout << "   -n <integer> = seconds a single file system call may block before it is abandoned. Unix only. 0 means no limit. DEFAULT=0" << endl;
+	cout << "   -N <integer> = seconds the file system calls for a single object may take in total. Unix only. 0 means no limit. DEFAULT=0" << endl;
+	cout << "   -I <string>  = path to the System Characteristics file of a previous scan of this system. Objects whose inputs have not changed since then reuse its items. May be the same file as -d. Unix only." << endl;
 	cout << "\n";
 
 	cout << "Result Output Options:" << endl;	
@@ -1067,6 +1269,8 @@ void Usage() {
 	cout << "   -s           = do not apply a stylesheet to the results xml." << endl;
 	cout << "   -t <string>  = apply the specified xsl to the results xml. DEFAULT=\"" << defaultSchemaPath << Common::fileSeperatorStr << DEFAULT_RESULTS_XFORM_FILENAME<<'\"' << endl;
 	cout << "   -x <string>  = output xsl transform results to the specified file. DEFAULT=\"results.html\"" << endl;
+	cout << "   -H           = write the html summary of the results directly instead of applying the xsl. Much faster on large results." << endl;
+	cout << "   -P <string>  = save a JSON report of the time, items, file system calls and memory used by each phase, probe and object to the specified file." << endl;
 	cout << "   -j <string>  = perform schema/schematron validation on the output OVAL System Characteristics. Path to an xsl may optionally be specified. DEFAULT=\"" << defaultSchemaPath<<Common::fileSeperator<<DEFAULT_SYSTEM_CHARACTERISTICS_SCHEMATRON_FILENAME << '\"' << endl;
 	cout << "   -k <string>  = perform schema/schematron validation on the output OVAL Results. Path to an xsl may optionally be specified. DEFAULT=\"" << defaultSchemaPath<<Common::fileSeperator<<DEFAULT_RESULTS_SCHEMATRON_FILENAME << '\"' << endl;
 	cout << "\n";
@@ -1093,7 +1297,31 @@ void Usage() {
 		cout << logMessage;
 		Log::UnalteredMessage(logMessage);
 
-		string result = XslCommon::ApplyXSL(fileToValidate, schematronXSLFile);
+		string result;
+		{
+			Instrumentation::Phase phase("schematron");
+			result = XslCommon::ApplyXSL(fileToValidate, schematronXSLFile);
+		}
+
+		return ReportSchematronResult(result);
+	}
+
+	bool SchematronValidate(XslSource &sourceToValidate, const string &schematronXSLFile) {
+		string logMessage = " ** running Schematron validation on " + sourceToValidate.GetSystemId() + "\n";
+		cout << logMessage;
+		Log::UnalteredMessage(logMessage);
+
+		string result;
+		{
+			Instrumentation::Phase phase("schematron");
+			result = sourceToValidate.ApplyXSL(schematronXSLFile);
+		}
+
+		return ReportSchematronResult(result);
+	}
+
+	bool ReportSchematronResult(string result) {
+		string logMessage;
 		// strip the xml declaration
 		if(result.compare("") != 0) {
 			size_t pos = result.rfind(">");
@@ -1115,4 +1343,295 @@ void Usage() {
 			return true;
 		}
 	}
+
+	bool RunAnalysis(XmlProcessor* processor, StringVector* ids, const string &resultsFile, const string &xslOutputFile) {
+
+		string logMessage = "";
+
+		// create a results document
+		DocumentManager::SetResultDocument(processor->CreateDOMDocumentNS("http://oval.mitre.org/XMLSchema/oval-results-5", "oval_results"));
+
+		//	Create the analyzer, it is deleted even if the analysis fails
+		auto_ptr<Analyzer> analyzer(new Analyzer());
+
+		//	Output status
+		logMessage = " ** running the OVAL Definition analysis.\n";
+		cout << logMessage;
+		Log::UnalteredMessage(logMessage);
+
+		//	run the analyzer
+		if(ids != NULL){
+
+			if(ids->size() == 0) {
+				string errorMessage = "The list of definition ids to evaluate was empty. Verify that the appropriate command line arguments were used.";
+				cout << errorMessage << endl;
+				Log::Info(errorMessage);
+
+			} else {
+				Instrumentation::Phase phase("analyze");
+				analyzer->Run(ids);
+			}
+			
+		} else {
+			Instrumentation::Phase phase("analyze");
+			analyzer->Run();
+		}
+
+		// Apply Directives
+		logMessage = " ** applying directives to OVAL results.\n";
+		cout << logMessage;
+		Log::UnalteredMessage(logMessage);
+		{
+			Instrumentation::Phase phase("directives");
+			Directive::ApplyAll(DocumentManager::GetResultDocument());
+		}
+
+		// print the results 
+		analyzer->PrintResults();
+
+		//	write the result document
+		logMessage = " ** saving OVAL results to " + resultsFile + ".\n";
+		cout << logMessage;
+		Log::UnalteredMessage(logMessage);
+		// When the results are validated or transformed, they are serialized once and
+		// the xml that was written is reused below instead of reading the file back.
+		bool runXsl = !Common::GetNoXsl() && !Common::GetNativeHtml();
+		bool reuseResults = Common::GetDoResultsSchematron() || runXsl;
+		auto_ptr<MemBufFormatTarget> results;
+		{
+			Instrumentation::Phase phase("write results");
+			if(reuseResults) {
+				results.reset(new MemBufFormatTarget());
+				processor->WriteAndSerializeDOMDocument(DocumentManager::GetResultDocument(), resultsFile, results.get());
+			} else {
+				processor->WriteDOMDocument(DocumentManager::GetResultDocument(), resultsFile);
+			}
+		}
+
+		analyzer.reset();
+
+		if (Common::GetDoResultsSchematron()) {
+			logMessage = " ** running XML-Schema validation on "+resultsFile+"\n";
+			cout << logMessage;
+			Log::UnalteredMessage(logMessage);
+			// create the DOM document and then immediately destroy it,
+			// for the purposes of generating validation errors
+			processor->ParseBuffer(*results, resultsFile, true)->release();
+		}
+
+		// the schematron and the results xsl share one parse of the results. The
+		// results are already written, so like any other transform error a failure
+		// here is logged and the transforms are skipped.
+		auto_ptr<XslSource> resultsSource;
+		if(reuseResults) {
+			try {
+				resultsSource.reset(new XslSource(*results, resultsFile));
+			} catch(Exception ex) {
+				Log::Info("Skipping the Schematron validation and xsl of the OVAL Results. " + ex.GetErrorMessage());
+			}
+			results.reset();
+		}
+
+		if (Common::GetDoResultsSchematron() && resultsSource.get() != NULL) {
+			if (!SchematronValidate(*resultsSource, Common::GetResultsSchematronPath()))
+				return false;
+		}
+
+		// run the xsl, or write the same html directly
+		if(!Common::GetNoXsl() && Common::GetNativeHtml()) {
+			logMessage = " ** writing OVAL Results html: " + xslOutputFile + ".\n";
+			cout << logMessage;
+			Log::UnalteredMessage(logMessage);
+			Instrumentation::Phase phase("html");
+			HtmlReport::Write(DocumentManager::GetResultDocument(), xslOutputFile);
+		} else if(runXsl && resultsSource.get() != NULL) {
+			logMessage = " ** running OVAL Results xsl: " + Common::GetXSLFilename() + ".\n";
+			cout << logMessage;
+			Log::UnalteredMessage(logMessage);
+			Instrumentation::Phase phase("xsl");
+			resultsSource->ApplyXSL(Common::GetXSLFilename(), xslOutputFile);
+		} else {
+			logMessage = " ** skipping OVAL Results xsl\n";
+			cout << logMessage;
+			Log::UnalteredMessage(logMessage);
+		}
+
+		return true;
+	}
+
+	void RunBatchAnalysis(XmlProcessor* processor, StringVector* ids) {
+
+		// read the list of files, one per line. Blank lines and lines starting with # are ignored.
+		ifstream batchFile(Common::GetBatchFile().c_str());
+		if(!batchFile) {
+			throw Exception("Unable to open the batch file: " + Common::GetBatchFile());
+		}
+
+		StringVector scFiles;
+		string line;
+		while(getline(batchFile, line)) {
+			string::size_type start = line.find_first_not_of(" \t\r\n");
+			if(start == string::npos || line[start] == '#')
+				continue;
+			string::size_type end = line.find_last_not_of(" \t\r\n");
+			scFiles.push_back(line.substr(start, end - start + 1));
+		}
+		batchFile.close();
+
+		string logMessage = " ** analyzing " + Common::ToString(scFiles.size()) + " system characteristics files listed in " + Common::GetBatchFile() + ".\n";
+		cout << logMessage;
+		Log::UnalteredMessage(logMessage);
+
+		// Make sure everything that is shared between the files is loaded before
+		// any work starts so that each worker inherits it instead of loading it again.
+		if(Common::GetUseVariableFile() && Common::FileExists(Common::GetExternalVariableFile()))
+			DocumentManager::GetExternalVariableDocument();
+		if(Common::GetDoResultsSchematron())
+			XslCommon::CompileXSL(Common::GetResultsSchematronPath());
+		if(!Common::GetNoXsl() && !Common::GetNativeHtml())
+			XslCommon::CompileXSL(Common::GetXSLFilename());
+		ParseSharedDefinitions();
+
+		unsigned int failures = 0;
+
+#ifdef WIN32
+		for(StringVector::iterator iterator = scFiles.begin(); iterator != scFiles.end(); iterator++) {
+			if(!AnalyzeBatchFile(processor, ids, (*iterator)))
+				failures++;
+		}
+#else
+		// Analysis relies on a lot of process wide state, so each file is handled in its
+		// own forked child which inherits the parsed definitions. At most the requested
+		// number of workers are running at any time.
+		unsigned int workers = Common::GetWorkerCount();
+		unsigned int running = 0;
+		StringVector::iterator iterator = scFiles.begin();
+		while(iterator != scFiles.end() || running > 0) {
+
+			if(iterator != scFiles.end() && running < workers) {
+				cout.flush();
+				Log::Flush();
+				pid_t pid = fork();
+				if(pid == 0) {
+					TimedFileOps::ForgetHelper();
+					bool analyzed = false;
+					try {
+						analyzed = AnalyzeBatchFile(processor, ids, (*iterator));
+					} catch(...) {
+						analyzed = false;
+					}
+					cout.flush();
+					Log::Flush();
+					_exit(analyzed ? EXIT_SUCCESS : EXIT_FAILURE);
+				} else if(pid < 0) {
+					// unable to start a worker, do this one here instead
+					Log::Info("Unable to start a worker process for " + (*iterator) + ": " + strerror(errno));
+					if(!AnalyzeBatchFile(processor, ids, (*iterator)))
+						failures++;
+				} else {
+					running++;
+				}
+				iterator++;
+
+			} else {
+				int status = 0;
+				if(waitpid(-1, &status, 0) > 0) {
+					running--;
+					if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+						failures++;
+				} else if(errno != EINTR) {
+					break;
+				}
+			}
+		}
+#endif
+
+		logMessage = " ** batch analysis complete. " + Common::ToString(scFiles.size() - failures) + " of " + Common::ToString(scFiles.size()) + " system characteristics files analyzed.\n";
+		cout << logMessage;
+		Log::UnalteredMessage(logMessage);
+	}
+
+	bool AnalyzeBatchFile(XmlProcessor* processor, StringVector* ids, const string &scFile) {
+
+		// results are written next to the system characteristics file
+		string baseName = scFile;
+		if(baseName.length() > 4 && Common::EqualsIgnoreCase(baseName.substr(baseName.length() - 4), ".xml"))
+			baseName = baseName.substr(0, baseName.length() - 4);
+		string resultsFile = baseName + "-results.xml";
+		string xslOutputFile = baseName + "-results.html";
+
+		// Nothing computed from another file may be used for this one. The definitions and
+		// tests parsed before the workers started are kept, they hold nothing from any file.
+		Analyzer::ClearItemCaches();
+		AbsVariable::ClearCache();
+
+		bool analyzed = false;
+		DOMDocument* scDoc = NULL;
+		try {
+			string logMessage = " ** parsing " + scFile + " for analysis.\n";
+			logMessage.append("    - validating xml schema.\n");
+			cout << logMessage;
+			Log::UnalteredMessage(logMessage);
+
+			scDoc = processor->ParseFile(scFile);
+			DocumentManager::SetSystemCharacteristicsDocument(scDoc);
+
+			analyzed = RunAnalysis(processor, ids, resultsFile, xslOutputFile);
+
+		} catch(Exception ex) {
+			string errorMessage = "Error while analyzing " + scFile + ": " + ex.GetErrorMessage();
+			cout << errorMessage << endl;
+			Log::Fatal(errorMessage);
+		}
+
+		// Nothing computed from this file may leak into the next one, even when its
+		// analysis failed half way. Variables can be computed from the items in the
+		// system characteristics, so they go too.
+		Analyzer::ClearCaches();
+		AbsVariable::ClearCache();
+		if(DocumentManager::GetResultDocument() != NULL) {
+			DocumentManager::GetResultDocument()->release();
+			DocumentManager::SetResultDocument(NULL);
+		}
+		if(scDoc != NULL) {
+			scDoc->release();
+			DocumentManager::SetSystemCharacteristicsDocument(NULL);
+		}
+
+		return analyzed;
+	}
+
+	void ParseSharedDefinitions() {
+
+		DOMDocument* definitionDoc = DocumentManager::GetDefinitionDocument();
+
+		// parsing a definition parses all of the tests in its criteria
+		DOMElement* definitionsElm = XmlCommon::FindElementNS(definitionDoc, "definitions");
+		if(definitionsElm != NULL) {
+			for(DOMNode* node = definitionsElm->getFirstChild(); node != NULL; node = node->getNextSibling()) {
+				if(node->getNodeType() == DOMNode::ELEMENT_NODE)
+					Definition::GetDefinitionById(XmlCommon::GetAttributeByName((DOMElement*)node, "id"));
+			}
+		}
+
+		DOMElement* statesElm = XmlCommon::FindElementNS(definitionDoc, "states");
+		if(statesElm != NULL) {
+			for(DOMNode* node = statesElm->getFirstChild(); node != NULL; node = node->getNextSibling()) {
+				if(node->getNodeType() == DOMNode::ELEMENT_NODE && !ReferencesVariable((DOMElement*)node))
+					State::GetStateById(XmlCommon::GetAttributeByName((DOMElement*)node, "id"));
+			}
+		}
+	}
+
+	bool ReferencesVariable(DOMElement* elm) {
+
+		if(!XmlCommon::GetAttributeByName(elm, "var_ref").empty())
+			return true;
+
+		for(DOMNode* node = elm->getFirstChild(); node != NULL; node = node->getNextSibling()) {
+			if(node->getNodeType() == DOMNode::ELEMENT_NODE && ReferencesVariable((DOMElement*)node))
+				return true;
+		}
+		return false;
+	}
 }
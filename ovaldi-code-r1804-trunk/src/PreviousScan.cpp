@@ -0,0 +1,346 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <xercesc/dom/DOMNode.hpp>
+
+#include "Behavior.h"
+#include "Common.h"
+#include "Log.h"
+#include "XmlCommon.h"
+#include "XmlProcessor.h"
+
+#include "PreviousScan.h"
+
+using namespace std;
+using namespace xercesc;
+
+namespace {
+	/** 
+		Seconds to move the previous scan's start back by when only its time stamp is known, for 
+		files saved without a scan_start_time. The time stamp is local time without
+		an offset, so it can read up to an hour late across a daylight saving change, and up to 
+		26 hours late if the previous scan ran with a different time zone.
+	*/
+	const time_t SCAN_TIME_MARGIN = 26 * 60 * 60;
+}
+
+//****************************************************************************************//
+//								PreviousScan Class										  //	
+//****************************************************************************************//
+bool PreviousScan::loaded = false;
+DOMDocument* PreviousScan::document = NULL;
+time_t PreviousScan::scanTime = 0;
+map<string, DOMElement*> PreviousScan::objects;
+map<string, DOMElement*> PreviousScan::items;
+map<string, string> PreviousScan::schemaLocations;
+unsigned int PreviousScan::reusedCount = 0;
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  Public Members  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+ItemVector* PreviousScan::GetItems(Object* object) {
+
+	if(Common::GetPreviousDatafile().empty())
+		return NULL;
+
+	if(!PreviousScan::loaded)
+		PreviousScan::Load();
+
+	if(PreviousScan::document == NULL)
+		return NULL;
+
+	// the object must have been collected completely by the previous scan
+	map<string, DOMElement*>::iterator objectIt = PreviousScan::objects.find(object->GetId());
+	if(objectIt == PreviousScan::objects.end())
+		return NULL;
+
+	DOMElement* objectElm = objectIt->second;
+	if(XmlCommon::GetAttributeByName(objectElm, "version") != Common::ToString(object->GetVersion()))
+		return NULL;
+
+	string flag = XmlCommon::GetAttributeByName(objectElm, "flag");
+	if(flag != "complete" && flag != "does not exist")
+		return NULL;
+
+	// what a filter or variable resolves to isn't known until the object is collected
+	if(!object->GetFilters()->empty())
+		return NULL;
+
+	AbsEntityVector* entities = object->GetElements();
+	for(AbsEntityVector::iterator iterator = entities->begin(); iterator != entities->end(); iterator++) {
+		if((*iterator)->GetVarRef() != NULL)
+			return NULL;
+	}
+
+	SignalVector signals;
+	if(!PreviousScan::GetSignals(object, &signals))
+		return NULL;
+
+	for(SignalVector::iterator iterator = signals.begin(); iterator != signals.end(); iterator++) {
+		if(!PreviousScan::IsUnchanged(iterator->first, iterator->second))
+			return NULL;
+	}
+
+	// gather all the referenced items before handing any of them out
+	vector<DOMElement*> itemElms;
+	for(DOMNode* child = objectElm->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+		if(child->getNodeType() != DOMNode::ELEMENT_NODE || XmlCommon::GetElementName((DOMElement*)child) != "reference")
+			continue;
+
+		map<string, DOMElement*>::iterator itemIt = PreviousScan::items.find(XmlCommon::GetAttributeByName((DOMElement*)child, "item_ref"));
+		if(itemIt == PreviousScan::items.end())
+			return NULL;
+		itemElms.push_back(itemIt->second);
+	}
+
+	ItemVector* previousItems = new ItemVector();
+	for(vector<DOMElement*>::iterator iterator = itemElms.begin(); iterator != itemElms.end(); iterator++) {
+		Item* item = new Item();
+		item->Parse(*iterator);
+		item->SetId(0);
+		item->SetXmlnsAlias(XmlCommon::GetElementPrefix(*iterator));
+		item->SetSchemaLocation(PreviousScan::schemaLocations[item->GetXmlns()]);
+		previousItems->push_back(item);
+	}
+
+	if(Log::IsDebug())
+		Log::Debug("Reusing the previously collected items for object: " + object->GetId());
+	PreviousScan::reusedCount++;
+
+	return previousItems;
+}
+
+unsigned int PreviousScan::GetReusedCount() {
+	return PreviousScan::reusedCount;
+}
+
+void PreviousScan::Clear() {
+
+	if(PreviousScan::document != NULL) {
+		PreviousScan::document->release();
+		PreviousScan::document = NULL;
+	}
+
+	PreviousScan::objects.clear();
+	PreviousScan::items.clear();
+	PreviousScan::schemaLocations.clear();
+	PreviousScan::scanTime = 0;
+	PreviousScan::reusedCount = 0;
+	PreviousScan::loaded = false;
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  Private Members  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+void PreviousScan::Load() {
+
+	PreviousScan::loaded = true;
+
+	try {
+		PreviousScan::document = XmlProcessor::Instance()->ParseFile(Common::GetPreviousDatafile(), true);
+	} catch(Exception ex) {
+		Log::Info("Unable to read the previous system characteristics file, all objects will be collected. " + ex.GetErrorMessage());
+		PreviousScan::document = NULL;
+		return;
+	}
+
+	// anything that changed after the previous scan started may not be in it
+	DOMElement* startTimeElm = XmlCommon::FindElement(PreviousScan::document, "scan_start_time");
+	DOMElement* timeStampElm = XmlCommon::FindElementNS(PreviousScan::document, "timestamp");
+	if(startTimeElm != NULL) {
+		unsigned long startTime = 0;
+		if(Common::FromString(XmlCommon::GetDataNodeValue(startTimeElm), &startTime))
+			PreviousScan::scanTime = (time_t)startTime;
+	} else if(timeStampElm != NULL) {
+		PreviousScan::scanTime = PreviousScan::ParseTimeStamp(XmlCommon::GetDataNodeValue(timeStampElm));
+	}
+
+	if(PreviousScan::scanTime == 0) {
+		Log::Info("Unable to read the time stamp of the previous system characteristics file, all objects will be collected.");
+		PreviousScan::Clear();
+		PreviousScan::loaded = true;
+		return;
+	}
+
+	DOMElement* collectedObjectsElm = XmlCommon::FindElementNS(PreviousScan::document, "collected_objects");
+	if(collectedObjectsElm != NULL) {
+		for(DOMNode* child = collectedObjectsElm->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+			if(child->getNodeType() == DOMNode::ELEMENT_NODE)
+				PreviousScan::objects[XmlCommon::GetAttributeByName((DOMElement*)child, "id")] = (DOMElement*)child;
+		}
+	}
+
+	DOMElement* systemDataElm = XmlCommon::FindElementNS(PreviousScan::document, "system_data");
+	if(systemDataElm != NULL) {
+		for(DOMNode* child = systemDataElm->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+			if(child->getNodeType() == DOMNode::ELEMENT_NODE)
+				PreviousScan::items[XmlCommon::GetAttributeByName((DOMElement*)child, "id")] = (DOMElement*)child;
+		}
+	}
+
+	// the schema location is a list of namespace and schema file pairs
+	string schemaLocation = XmlCommon::GetAttributeByName(PreviousScan::document->getDocumentElement(), "xsi:schemaLocation");
+	StringVector tokens;
+	string::size_type start = schemaLocation.find_first_not_of(" \t\r\n");
+	while(start != string::npos) {
+		string::size_type end = schemaLocation.find_first_of(" \t\r\n", start);
+		tokens.push_back(schemaLocation.substr(start, end == string::npos ? string::npos : end - start));
+		start = schemaLocation.find_first_not_of(" \t\r\n", end);
+	}
+	for(StringVector::size_type index = 0; index + 1 < tokens.size(); index += 2)
+		PreviousScan::schemaLocations[tokens[index]] = tokens[index] + " " + tokens[index + 1];
+}
+
+bool PreviousScan::GetSignals(Object* object, SignalVector* signals) {
+
+	string name = object->GetName();
+
+	if(name == "rpminfo_object") {
+
+		// the database has moved around between rpm versions, and a system that was converted
+		// can keep the old one, so any of them that is there has to be unchanged
+		const char* databases[] = { "/var/lib/rpm/Packages", "/var/lib/rpm/rpmdb.sqlite", "/usr/lib/sysimage/rpm/rpmdb.sqlite" };
+		for(unsigned int index = 0; index < sizeof(databases) / sizeof(databases[0]); index++) {
+			struct stat info;
+			if(stat(databases[index], &info) == 0)
+				signals->push_back(Signal(databases[index], true));
+		}
+		return !signals->empty();
+
+	} else if(name == "dpkginfo_object") {
+
+		signals->push_back(Signal("/var/lib/dpkg/status", true));
+		return true;
+
+	} else if(name == "file_object" || name == "textfilecontent54_object") {
+
+		return PreviousScan::GetFileSignals(object, signals);
+	}
+
+	return false;
+}
+
+bool PreviousScan::GetFileSignals(Object* object, SignalVector* signals) {
+
+	// only a single, literally named file can be checked without searching for it
+	string recurseDirection = Behavior::GetBehaviorValue(object->GetBehaviors(), "recurse_direction");
+	if(!recurseDirection.empty() && recurseDirection != "none")
+		return false;
+
+	string filePath;
+	if(!PreviousScan::GetLiteralValue(object, "filepath", &filePath)) {
+		string path;
+		string fileName;
+		if(!PreviousScan::GetLiteralValue(object, "path", &path) || !PreviousScan::GetLiteralValue(object, "filename", &fileName))
+			return false;
+		if(!path.empty() && path[path.length() - 1] == Common::fileSeperator)
+			filePath = path + fileName;
+		else
+			filePath = path + Common::fileSeperatorStr + fileName;
+	}
+
+	string::size_type separator = filePath.find_last_of(Common::fileSeperator);
+	if(separator == string::npos)
+		return false;
+
+	// the directory changes when the file is created, removed or renamed
+	signals->push_back(Signal(filePath, false));
+	signals->push_back(Signal(separator == 0 ? Common::fileSeperatorStr : filePath.substr(0, separator), true));
+	return true;
+}
+
+bool PreviousScan::GetLiteralValue(Object* object, const string &name, string* value) {
+
+	AbsEntityVector* entities = object->GetElements();
+	for(AbsEntityVector::iterator iterator = entities->begin(); iterator != entities->end(); iterator++) {
+		AbsEntity* entity = *iterator;
+		if(entity->GetName() != name)
+			continue;
+
+		if(entity->GetNil() || entity->GetVarRef() != NULL || entity->GetOperation() != OvalEnum::OPERATION_EQUALS)
+			return false;
+
+		*value = entity->GetValue();
+		return !value->empty();
+	}
+
+	return false;
+}
+
+bool PreviousScan::IsUnchanged(const string &path, bool mustExist) {
+
+#ifdef WIN32
+	// a file copied or moved into place keeps its old times on windows
+	return false;
+#else
+	struct stat info;
+	if(lstat(path.c_str(), &info) != 0)
+		return !mustExist && errno == ENOENT;
+
+	if(info.st_mtime >= PreviousScan::scanTime || info.st_ctime >= PreviousScan::scanTime)
+		return false;
+
+	// a link is only as unchanged as the file it points to
+	if(S_ISLNK(info.st_mode)) {
+		if(stat(path.c_str(), &info) != 0)
+			return false;
+		if(info.st_mtime >= PreviousScan::scanTime || info.st_ctime >= PreviousScan::scanTime)
+			return false;
+	}
+
+	return true;
+#endif
+}
+
+time_t PreviousScan::ParseTimeStamp(const string &timeStamp) {
+
+	// written by Common::GetTimeStamp() in local time, in whatever time zone that run had
+	struct tm parsed;
+	memset(&parsed, 0, sizeof(parsed));
+	if(sscanf(timeStamp.c_str(), "%d-%d-%dT%d:%d:%d", &parsed.tm_year, &parsed.tm_mon, &parsed.tm_mday, &parsed.tm_hour, &parsed.tm_min, &parsed.tm_sec) != 6)
+		return 0;
+
+	parsed.tm_year -= 1900;
+	parsed.tm_mon -= 1;
+	parsed.tm_isdst = -1;
+
+	time_t parsedTime = mktime(&parsed);
+	if(parsedTime == (time_t)-1 || parsedTime <= SCAN_TIME_MARGIN)
+		return 0;
+
+	// err on the side of treating a file as changed
+	return parsedTime - SCAN_TIME_MARGIN;
+}
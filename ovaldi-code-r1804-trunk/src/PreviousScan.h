@@ -0,0 +1,123 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifndef PREVIOUSSCAN_H
+#define PREVIOUSSCAN_H
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+
+#include "Item.h"
+#include "Object.h"
+
+/**
+	This class lets a scan reuse what an earlier scan of the same system collected.
+
+	When the system characteristics file of a previous scan is specified, each object is 
+	looked up in that file before its probe is run. If the object was collected completely 
+	and nothing it depends on has changed since the previous scan started, the items the 
+	previous scan collected for it are used instead of collecting them again.
+
+	Only objects whose inputs can be checked cheaply are considered:
+	- rpminfo_object items depend on every rpm database that is present.
+	- dpkginfo_object items depend on the dpkg status file.
+	- file_object and textfilecontent54_object items depend on the file, when the file is 
+	  named literally, and on the directory holding it.
+	An input is unchanged if its modification and inode change times are both before the 
+	previous scan started. Writing to a file changes its size and modification time, and 
+	replacing it with another inode changes the directory, so these two times cover the 
+	inode, modification time and size of a file. Objects that use variables or filters are 
+	always collected again, as are objects whose version differs from the one in the 
+	previous file.
+
+	The previous scan's start is read from the scan_start_time this interpreter writes into 
+	the generator, in seconds since the epoch. Files written without it only have a local time 
+	stamp, so for those anything changed in the 26 hours before it is treated as changed.
+
+	Reusing a previous scan is not supported on Windows, where a replaced file can keep its 
+	old times.
+*/
+class PreviousScan {
+public:
+
+	/** Return the items the previous scan collected for the object, or NULL if the object has to be collected again. 
+		The caller owns the returned vector and the items in it. The items have no id yet.
+	*/
+	static ItemVector* GetItems(Object* object);
+
+	/** Return the number of objects that reused the previous scan's items. */
+	static unsigned int GetReusedCount();
+
+	/** Release the previous scan's document and reset the counts. */
+	static void Clear();
+
+private:
+
+	/** A file or directory an object depends on and whether it has to exist. */
+	typedef std::pair<std::string, bool> Signal;
+	typedef std::vector<Signal> SignalVector;
+
+	/** Parse the previous system characteristics file and index its objects and items. */
+	static void Load();
+
+	/** Add the inputs of the object to signals. Return false if the object's inputs can't be determined. */
+	static bool GetSignals(Object* object, SignalVector* signals);
+
+	/** Add the literally named file the object reads, and its directory, to signals. Return false if there is no such file. */
+	static bool GetFileSignals(Object* object, SignalVector* signals);
+
+	/** Get the value of the named entity if it is a literal equals value. Return false otherwise. */
+	static bool GetLiteralValue(Object* object, const std::string &name, std::string* value);
+
+	/** Return true if the file has not changed since the previous scan started. */
+	static bool IsUnchanged(const std::string &path, bool mustExist);
+
+	/** Parse the previous scan's time stamp and return a time no later than the scan's start. 
+		Return 0 if it can't be read.
+	*/
+	static time_t ParseTimeStamp(const std::string &timeStamp);
+
+	static bool loaded;
+	static xercesc::DOMDocument* document;
+	static time_t scanTime;
+	static std::map<std::string, xercesc::DOMElement*> objects;
+	static std::map<std::string, xercesc::DOMElement*> items;
+	/** The schema location of each item namespace in the previous file. */
+	static std::map<std::string, std::string> schemaLocations;
+	static unsigned int reusedCount;
+};
+
+#endif
@@ -28,10 +28,82 @@
 //
 //****************************************************************************************//
 
+#include <cctype>
+
 #include "REGEX.h"
 
 using namespace std;
 
+namespace {
+	/** Return the position just past the character class that starts at the specified position. */
+	string::size_type SkipClass(const string &pattern, string::size_type start) {
+		string::size_type i = start + 1;
+		if(i < pattern.size() && pattern[i] == '^')
+			i++;
+		// a ] right at the start is part of the class
+		if(i < pattern.size() && pattern[i] == ']')
+			i++;
+		while(i < pattern.size() && pattern[i] != ']') {
+			if(pattern[i] == '\\')
+				i++;
+			i++;
+		}
+		return i + 1;
+	}
+
+	/** Return the position just past the group that starts at the specified position. */
+	string::size_type SkipGroup(const string &pattern, string::size_type start) {
+		int depth = 0;
+		string::size_type i = start;
+		while(i < pattern.size()) {
+			if(pattern[i] == '\\') {
+				i += 2;
+			} else if(pattern[i] == '[') {
+				i = SkipClass(pattern, i);
+			} else {
+				if(pattern[i] == '(')
+					depth++;
+				else if(pattern[i] == ')' && --depth == 0)
+					return i + 1;
+				i++;
+			}
+		}
+		return i;
+	}
+
+	/**
+	 * Return the position just past the {n}, {n,} or {n,m} quantifier that starts at the
+	 * specified position, or string::npos if the brace does not start a quantifier.
+	 */
+	string::size_type SkipQuantifier(const string &pattern, string::size_type start) {
+		string::size_type i = start + 1;
+		string::size_type digits = i;
+		while(i < pattern.size() && isdigit((unsigned char)pattern[i]))
+			i++;
+		if(i == digits)
+			return string::npos;
+		if(i < pattern.size() && pattern[i] == ',') {
+			i++;
+			while(i < pattern.size() && isdigit((unsigned char)pattern[i]))
+				i++;
+		}
+		if(i >= pattern.size() || pattern[i] != '}')
+			return string::npos;
+		return i + 1;
+	}
+
+	/** Free the result of pcre_study(). pcre_free_study() only exists from PCRE 8.20 on. */
+	void FreeStudy(pcre_extra *extra) {
+		if(extra == NULL)
+			return;
+#if PCRE_MAJOR > 8 || (PCRE_MAJOR == 8 && PCRE_MINOR >= 20)
+		pcre_free_study(extra);
+#else
+		pcre_free(extra);
+#endif
+	}
+}
+
 REGEX::REGEX() {
 	this->matchCount = 0;
 }
@@ -50,7 +122,23 @@ string REGEX::EscapeRegexChars(string stringIn) {
 		pos = fixedString.find_first_of(Common::REGEX_CHARS, pos+2);			
 	}
 
-	return fixedString;	
+	return fixedString;
+}
+
+void REGEX::EscapeRegexChars(const string& stringIn, string* out) {
+
+	out->reserve(out->size() + stringIn.size() + 8);
+
+	size_t start = 0;
+	size_t pos = stringIn.find_first_of(Common::REGEX_CHARS, 0);
+	while (pos != string::npos) {
+		out->append(stringIn, start, pos - start);
+		out->push_back('\\');
+		out->push_back(stringIn[pos]);
+		start = pos + 1;
+		pos = stringIn.find_first_of(Common::REGEX_CHARS, start);
+	}
+	out->append(stringIn, start, string::npos);
 }
 
 int REGEX::FindFirstRegexChar(const string stringIn) {
@@ -460,6 +548,70 @@ void REGEX::GetAllMatchingSubstrings(const string& pattern, const string& search
 	delete[] ovector;
 }
 
+void REGEX::GetFirstCaptures(const string& pattern, const StringVector& searchStrings, StringVector* captures) {
+
+	const char *error;
+	int erroffset = -1;
+
+	//	Compile the pattern once for all of the search strings
+	pcre *re = pcre_compile(pattern.c_str(), 0, &error, &erroffset, NULL);
+	if(re == NULL) {
+		string errMsg = "Error: Failed to compile the specified regular expression pattern.";
+		errMsg += "\n\tPattern: " + pattern;
+		errMsg += "\n\tOffset: " + Common::ToString(erroffset);
+		errMsg += "\n\tMessage: " + string(error);
+		throw REGEXException(errMsg);
+	}
+
+	// The pattern is going to be run many times so it is worth studying.
+	// A NULL result without an error just means nothing useful was found.
+	const char *studyError = NULL;
+	pcre_extra *extra = pcre_study(re, 0, &studyError);
+
+	captures->reserve(captures->size() + searchStrings.size());
+
+	int ovector[60];
+	for(StringVector::const_iterator iterator = searchStrings.begin(); iterator != searchStrings.end(); iterator++) {
+
+		//	Test the match count
+		if(this->matchCount >= MAXMATCHES) {
+			FreeStudy(extra);
+			pcre_free(re);
+			string errMsg = "Warning: The specified pattern has matched more than the supported number of items.";
+			errMsg.append("\nPattern: ");
+			errMsg.append(pattern);
+			throw REGEXException(errMsg, ERROR_WARN);
+		}
+
+		int rc = pcre_exec(re, extra, iterator->c_str(), iterator->length(), 0, 0, ovector, 60);
+
+		if(rc < -1) {
+			FreeStudy(extra);
+			pcre_free(re);
+
+			string errMsg = "Error: PCRE returned error code (" + Common::ToString(rc);
+			errMsg.append(") While evaluating the following regex: ");
+			errMsg.append(pattern);
+			errMsg.append(" against this string: ");
+			errMsg.append(*iterator);
+			throw REGEXException(errMsg);
+		}
+
+		if(rc > 0)
+			this->matchCount++;
+
+		// add the first capture, ignore any others
+		if(rc > 1 && ovector[2] > -1) {
+			captures->push_back(iterator->substr(ovector[2], ovector[3] - ovector[2]));
+		} else {
+			captures->push_back("");
+		}
+	}
+
+	FreeStudy(extra);
+	pcre_free(re);
+}
+
 string REGEX::RemoveExtraSlashes(string strIn) {
 	// This code works on the "constant portion" of a regex.
 	// It *assumes* that the value passed in is a valid regex
@@ -479,6 +631,75 @@ string REGEX::RemoveExtraSlashes(string strIn) {
 	return strIn;	
 }
 
+string REGEX::GetRequiredLiteral(const string &pattern) {
+
+	if(pattern.find('|') != string::npos || pattern.find("(?") != string::npos || pattern.find("\\Q") != string::npos)
+		return "";
+
+	// escapes that stand for a single character class or assertion and take no arguments
+	static const string singleEscapes = "dDsSwWbBhHvVAzZGRXKntrfe";
+
+	string longest = "";
+	string run = "";
+	string::size_type i = 0;
+	while(i < pattern.size()) {
+		char c = pattern[i];
+		bool literal = false;
+		string::size_type next = i + 1;
+
+		if(c == '\\') {
+			if(i + 1 >= pattern.size())
+				break;
+			c = pattern[i + 1];
+			if((unsigned char)c >= 128)
+				return "";
+			if(isalnum((unsigned char)c)) {
+				// other letters and digits (\x41, \p{Lu}, \cA, \012, \k<name>, ...) take
+				// arguments that are not parsed here and would be mistaken for literal text
+				if(singleEscapes.find(c) == string::npos)
+					return "";
+			} else {
+				// escaped punctuation stands for itself
+				literal = true;
+			}
+			next = i + 2;
+		} else if(c == '[') {
+			next = SkipClass(pattern, i);
+		} else if(c == '(') {
+			next = SkipGroup(pattern, i);
+		} else if(c == '{') {
+			// quantifiers are skipped below, so this brace is not one
+			return "";
+		} else {
+			literal = (unsigned char)c < 128 && string(".^$)*+?{}").find(c) == string::npos;
+		}
+
+		// a quantifier makes the character optional, or lets it repeat
+		char quantifier = next < pattern.size() ? pattern[next] : '\0';
+		bool optional = quantifier == '?' || quantifier == '*' || quantifier == '{';
+		if(quantifier == '{') {
+			// the counts inside the braces are not text to match
+			next = SkipQuantifier(pattern, next);
+			if(next == string::npos)
+				return "";
+		}
+
+		if(literal && !optional)
+			run += c;
+		if(!literal || optional || quantifier == '+') {
+			if(run.size() > longest.size())
+				longest = run;
+			run = "";
+		}
+
+		i = next;
+	}
+	if(run.size() > longest.size())
+		longest = run;
+
+	return longest;
+}
+
 void REGEX::Reset() {
 
 	this->matchCount = 0;
@@ -72,6 +72,12 @@ public:
 	*/
 	std::string EscapeRegexChars(std::string);
 
+	/**
+		Same as EscapeRegexChars(std::string), but appends the escaped form of stringIn to
+		the caller's buffer instead of building a new string for each value.
+	*/
+	void EscapeRegexChars(const std::string& stringIn, std::string* out);
+
 	/**
 		This function takes a string and searches for the first regular	expression character that is not escaped. 
 		If one is found its location is returned. If none are found -1 is returned. Only 
@@ -116,6 +122,25 @@ public:
 	 */
 	void GetAllMatchingSubstrings(const std::string& pattern, const std::string& searchString, std::vector<StringVector> &matches, int matchOptions=0);
 
+	/**
+	 * Batched form of GetMatchingSubstrings(const char*,const char*,StringVector*) for callers
+	 * that apply one pattern to many values.  The pattern is compiled and studied once, then
+	 * run against each of the search strings.  For every search string exactly one value is
+	 * appended to 'captures': the first captured substring, or "" if the string did not match
+	 * or the first subexpression did not participate.  The output is grown once up front, so
+	 * captures[n] lines up with searchStrings[n] when 'captures' starts out empty.
+	 */
+	void GetFirstCaptures(const std::string& pattern, const StringVector& searchStrings, StringVector* captures);
+
+	/**
+	 * Return the longest run of literal characters that every match of the pattern contains,
+	 * or "" if there is none that can be found simply.  Groups are skipped, since they may be
+	 * optional, and patterns with alternatives, inline options or quoting are not looked at.
+	 * Escapes that take arguments (\x, \p, \c, octal, back references and the like) make
+	 * the whole pattern be treated as having no required literal.
+	 */
+	static std::string GetRequiredLiteral(const std::string& pattern);
+
 	/** 
 		This function takes a string and searches for all the double '\'s. 
 		Each double '\' //	is converted to a single '\'
@@ -67,21 +67,9 @@ ComponentValue* RegexCaptureFunction::ComputeValue() {
         return result;
     }
 
-    StringVector matches;
-    StringVector *valueValues = value->GetValues();
+    // compile the pattern once and capture from every value in one pass
     this->reUtil.Reset();
-    for(StringVector::iterator valueIter = valueValues->begin(); valueIter != valueValues->end(); ++valueIter) {
-        matches.clear();
-        bool matchSucceeded = this->reUtil.GetMatchingSubstrings(regex.c_str(), valueIter->c_str(), &matches);
-        if (matchSucceeded) {
-            if (matches.empty())
-                result->AppendValue("");
-            else
-                result->AppendValue(matches[0]); // add the first capture, ignore any others.
-        }
-        else
-            result->AppendValue("");
-    }
+    this->reUtil.GetFirstCaptures(regex, *value->GetValues(), result->GetValues());
 
     delete value;
     return result;	
@@ -64,23 +64,32 @@ ComponentValue* SplitFunction::ComputeValue() {
 		return result;
 	}
 
-	string delim = this->GetDelimiter();
-	StringVector *argValVals = argVal->GetValues();
+	const string delim = this->GetDelimiter();
+	const StringVector *argValVals = argVal->GetValues();
+	StringVector *resultVals = result->GetValues();
+	resultVals->reserve(argValVals->size());
 
-	for (StringVector::iterator iter = argValVals->begin();
+	for (StringVector::const_iterator iter = argValVals->begin();
 		iter != argValVals->end();
 		++iter) {
 
-		string::iterator endOfLastDelim = iter->begin();
-		string::iterator matchBeg = search(iter->begin(), iter->end(), delim.begin(), delim.end());
-		while (matchBeg != iter->end()) {
-			result->AppendValue(string(endOfLastDelim, matchBeg));
+		// an empty delimiter can not split anything, and searching for
+		// it would never advance
+		if (delim.empty()) {
+			resultVals->push_back(*iter);
+			continue;
+		}
+
+		string::size_type endOfLastDelim = 0;
+		string::size_type matchBeg = iter->find(delim);
+		while (matchBeg != string::npos) {
+			resultVals->push_back(iter->substr(endOfLastDelim, matchBeg - endOfLastDelim));
 
 			endOfLastDelim = matchBeg + delim.size();
-			matchBeg = search(endOfLastDelim, iter->end(), delim.begin(), delim.end());
+			matchBeg = iter->find(delim, endOfLastDelim);
 		}
 
-		result->AppendValue(string(endOfLastDelim, iter->end()));
+		resultVals->push_back(iter->substr(endOfLastDelim));
 	}
 
 	delete argVal;
@@ -37,6 +37,7 @@
 #include "StateEntity.h"
 #include "DocumentManager.h"
 #include "Common.h"
+#include "AbsDataCollector.h"
 
 #include "State.h"
 
@@ -44,6 +45,8 @@ using namespace std;
 using namespace xercesc;
 
 AbsStateMap State::processedStatesMap;
+unsigned long State::resultHits = 0;
+unsigned long State::resultMisses = 0;
 
 //****************************************************************************************//
 //									State Class											  //	
@@ -61,84 +64,24 @@ State::~State() {
 //								 Public members												//
 // ***************************************************************************************	//
 
-OvalEnum::ResultEnumeration State::Analyze(Item* item) {
+OvalEnum::ResultEnumeration State::Analyze(Item* item, int variableInstance) {
 
-	// Check the status of the Item
-	if(item->GetStatus() == OvalEnum::STATUS_ERROR) {
-		return OvalEnum::RESULT_ERROR;
-	} else if(item->GetStatus() == OvalEnum::STATUS_NOT_COLLECTED) {
-		return OvalEnum::RESULT_ERROR;
-	} else if(item->GetStatus() == OvalEnum::STATUS_DOES_NOT_EXIST) {
-		return OvalEnum::RESULT_FALSE;
-	}
+	// while collecting, filtered items don't have their final id yet
+	if(AbsDataCollector::GetIsRunning() || item->GetId() <= 0)
+		return this->AnalyzeItem(item);
 
-	// check data before analysis
-	if(this->GetElements()->size() == 0) {
-		return OvalEnum::RESULT_TRUE;
+	pair<int, int> key(variableInstance, item->GetId());
+	map<pair<int, int>, OvalEnum::ResultEnumeration>::iterator found = this->itemResults.find(key);
+	if(found != this->itemResults.end()) {
+		State::resultHits++;
+		return found->second;
 	}
+	State::resultMisses++;
 
-	// vector of result values before the state operator is applied
-	IntVector stateResults;
-
-	// Loop through all elements in the state
-	AbsEntityVector::iterator stateElements;
-	for(stateElements = this->GetElements()->begin(); stateElements != this->GetElements()->end(); stateElements++) {
-		StateEntity* stateElm = (StateEntity*)(*stateElements);
+	OvalEnum::ResultEnumeration result = this->AnalyzeItem(item);
+	this->itemResults.insert(make_pair(key, result));
 
-		/*******************************************************
-		 Ugly hackage to make user_sid states match their items.
-		 This is done by checking for a particular entity of a
-		 particular state, and if found, we replace it with a
-		 dupe state entity with a changed name, for the purposes
-		 of the subsequent analysis.
-		 *******************************************************/
-		auto_ptr<StateEntity> fakedSidStateEntity;
-		if (GetXmlns() == "http://oval.mitre.org/XMLSchema/oval-definitions-5#windows" &&
-			GetName() == "user_sid_state") {
-		  if (stateElm->GetName() == "user") {
-			fakedSidStateEntity.reset(new StateEntity(*stateElm));
-			fakedSidStateEntity->SetName("user_sid");
-			stateElm = fakedSidStateEntity.get();
-		  } else if (stateElm->GetName() == "group") {
-			fakedSidStateEntity.reset(new StateEntity(*stateElm));
-			fakedSidStateEntity->SetName("group_sid");
-			stateElm = fakedSidStateEntity.get();
-		  }
-		}
-		/******************************************************
-		 End ugly hackage
-		 ******************************************************/
-
-		// locate matching elements in the item
-		string stateElmName = stateElm->GetName();
-		// i think the vector needs deleting, but the item retains ownership
-		// of the vector's contents.
-		auto_ptr<ItemEntityVector> scElements(item->GetElementsByName(stateElmName));
-		IntVector stateElmResults;
-
-		if (scElements->empty())
-			Log::Debug("Warning: can't find match in item, for state entity named: \""+stateElmName+"\"");
-		else {
-
-			// Analyze each matching element
-			ItemEntityVector::iterator scIterator;
-			for(scIterator = scElements->begin(); scIterator != scElements->end(); scIterator++) {
-				ItemEntity* scElm = (ItemEntity*)(*scIterator);
-				// call StateEntity->analyze method
-				stateElmResults.push_back(stateElm->Analyze(scElm));
-			}
-		}
-
-		// compute the overall state result
-		OvalEnum::ResultEnumeration stateResult = OvalEnum::CombineResultsByCheck(&stateElmResults, stateElm->GetEntityCheck());
-
-		// store the result for the current state element
-		stateResults.push_back(stateResult);
-	}
-	
-	OvalEnum::ResultEnumeration overallResult = OvalEnum::CombineResultsByOperator(&stateResults, this->GetOperator());
-
-	return overallResult;
+	return result;
 }
 
 void State::Parse(DOMElement* stateElm) {
@@ -201,6 +144,12 @@ State* State::SearchCache(string id) {
 
 void State::ClearCache() {
 
+	if(State::resultHits > 0 || State::resultMisses > 0)
+		Log::Debug("State results: " + Common::ToString(State::resultHits) + " reused, " + 
+				   Common::ToString(State::resultMisses) + " analyzed.");
+	State::resultHits = 0;
+	State::resultMisses = 0;
+
 	AbsStateMap::iterator iterator;
 	for(iterator = State::processedStatesMap.begin(); iterator != State::processedStatesMap.end(); iterator++) {
 		AbsState* state = iterator->second;
@@ -210,6 +159,12 @@ void State::ClearCache() {
 	State::processedStatesMap.clear();
 }
 
+void State::ClearResults() {
+
+	for(AbsStateMap::iterator iterator = State::processedStatesMap.begin(); iterator != State::processedStatesMap.end(); iterator++)
+		((State*)iterator->second)->itemResults.clear();
+}
+
 void State::Cache(State* state) {
 
 	State::processedStatesMap.insert(AbsStatePair(state->GetId(), state));
@@ -238,3 +193,86 @@ State* State::GetStateById(string stateId) {
 	
 	return state;
 }
+
+// ***************************************************************************************	//
+//								Private members												//
+// ***************************************************************************************	//
+OvalEnum::ResultEnumeration State::AnalyzeItem(Item* item) {
+
+	// Check the status of the Item
+	if(item->GetStatus() == OvalEnum::STATUS_ERROR) {
+		return OvalEnum::RESULT_ERROR;
+	} else if(item->GetStatus() == OvalEnum::STATUS_NOT_COLLECTED) {
+		return OvalEnum::RESULT_ERROR;
+	} else if(item->GetStatus() == OvalEnum::STATUS_DOES_NOT_EXIST) {
+		return OvalEnum::RESULT_FALSE;
+	}
+
+	// check data before analysis
+	if(this->GetElements()->size() == 0) {
+		return OvalEnum::RESULT_TRUE;
+	}
+
+	// vector of result values before the state operator is applied
+	IntVector stateResults;
+
+	// Loop through all elements in the state
+	AbsEntityVector::iterator stateElements;
+	for(stateElements = this->GetElements()->begin(); stateElements != this->GetElements()->end(); stateElements++) {
+		StateEntity* stateElm = (StateEntity*)(*stateElements);
+
+		/*******************************************************
+		 Ugly hackage to make user_sid states match their items.
+		 This is done by checking for a particular entity of a
+		 particular state, and if found, we replace it with a
+		 dupe state entity with a changed name, for the purposes
+		 of the subsequent analysis.
+		 *******************************************************/
+		auto_ptr<StateEntity> fakedSidStateEntity;
+		if (GetXmlns() == "http://oval.mitre.org/XMLSchema/oval-definitions-5#windows" &&
+			GetName() == "user_sid_state") {
+		  if (stateElm->GetName() == "user") {
+			fakedSidStateEntity.reset(new StateEntity(*stateElm));
+			fakedSidStateEntity->SetName("user_sid");
+			stateElm = fakedSidStateEntity.get();
+		  } else if (stateElm->GetName() == "group") {
+			fakedSidStateEntity.reset(new StateEntity(*stateElm));
+			fakedSidStateEntity->SetName("group_sid");
+			stateElm = fakedSidStateEntity.get();
+		  }
+		}
+		/******************************************************
+		 End ugly hackage
+		 ******************************************************/
+
+		// locate matching elements in the item
+		string stateElmName = stateElm->GetName();
+		// i think the vector needs deleting, but the item retains ownership
+		// of the vector's contents.
+		auto_ptr<ItemEntityVector> scElements(item->GetElementsByName(stateElmName));
+		IntVector stateElmResults;
+
+		if (scElements->empty())
+			Log::Debug("Warning: can't find match in item, for state entity named: \""+stateElmName+"\"");
+		else {
+
+			// Analyze each matching element
+			ItemEntityVector::iterator scIterator;
+			for(scIterator = scElements->begin(); scIterator != scElements->end(); scIterator++) {
+				ItemEntity* scElm = (ItemEntity*)(*scIterator);
+				// call StateEntity->analyze method
+				stateElmResults.push_back(stateElm->Analyze(scElm));
+			}
+		}
+
+		// compute the overall state result
+		OvalEnum::ResultEnumeration stateResult = OvalEnum::CombineResultsByCheck(&stateElmResults, stateElm->GetEntityCheck());
+
+		// store the result for the current state element
+		stateResults.push_back(stateResult);
+	}
+	
+	OvalEnum::ResultEnumeration overallResult = OvalEnum::CombineResultsByOperator(&stateResults, this->GetOperator());
+
+	return overallResult;
+}
@@ -31,7 +31,9 @@
 #ifndef STATE_H
 #define STATE_H
 
+#include <map>
 #include <string>
+#include <utility>
 #include <xercesc/dom/DOMElement.hpp>
 
 #include "Item.h"
@@ -55,8 +57,14 @@ public:
 		2 - pass the vector to the StateEntity analyze method
 		3 - build a vector of results for each element in the state.
 		4 - combine the results to a single value based on the states operator
+
+		Once collection is over the result for each item and variable instance is 
+		remembered, so tests that share the state don't analyze the same item against 
+		it again. Item ids are only unique within one system characteristics document, 
+		so the remembered results have to be cleared with ClearResults() whenever the 
+		document changes.
 	*/
-	OvalEnum::ResultEnumeration Analyze(Item* item);
+	OvalEnum::ResultEnumeration Analyze(Item* item, int variableInstance = 1);
 
 	/** Parse the provided state element from a oval definition file into a State object. */
 	virtual void Parse(xercesc::DOMElement* stateElm);
@@ -66,12 +74,17 @@ public:
 	*/
 	static State* SearchCache(std::string id);
 
-	/** Delete all items in the cache. */
+	/** Delete all items in the cache. 
+		The remembered item results go with the states.
+	*/
 	static void ClearCache();
 
 	/** Cache the specified state. */
 	static void Cache(State* state);
 
+	/** Forget the item results remembered by every cached state. */
+	static void ClearResults();
+
 	/** Return a state object for the specified state id.
 		First the cache of States is checked. If the state is
 		not found in the cache the state is looked up in the
@@ -89,6 +102,14 @@ private:
 	*/
 	State(OvalEnum::Operator myOperator = OvalEnum::OPERATOR_AND, int version = 1);
 	
+	/** Analyze the specified Item without looking for a remembered result. */
+	OvalEnum::ResultEnumeration AnalyzeItem(Item* item);
+
+	/** The result of each item analyzed against this state, by variable instance and item id. */
+	std::map<std::pair<int, int>, OvalEnum::ResultEnumeration> itemResults;
+
+	static unsigned long resultHits;
+	static unsigned long resultMisses;
 
 	static AbsStateMap processedStatesMap;
 };
@@ -51,8 +51,6 @@ using namespace xercesc;
 
 ComponentValue* SubstringFunction::ComputeValue() {
 
-	StringVector* values = NULL;
-	
 	AbsComponent* component = this->GetComponents()->at(0);
 
 	ComponentValue* componentValue = component->ComputeValue();
@@ -63,12 +61,13 @@ ComponentValue* SubstringFunction::ComputeValue() {
 	result->AppendMessages(componentValue->GetMessages());
 
 	if(componentValue->GetFlag() == OvalEnum::FLAG_COMPLETE) {
-		values = new StringVector();;
+		const StringVector* inputValues = componentValue->GetValues();
+		StringVector* values = result->GetValues();
+		values->reserve(inputValues->size());
 
-		StringVector::iterator iterator;
-		for(iterator = componentValue->GetValues()->begin(); iterator != componentValue->GetValues()->end(); iterator++) {
-			string currentValue = (*iterator);
-			string newValue = "";
+		StringVector::const_iterator iterator;
+		for(iterator = inputValues->begin(); iterator != inputValues->end(); iterator++) {
+			const string& currentValue = (*iterator);
 			
 			// Initialize substring_start to the first character in the string.  This case applies if substring_start is less than or equal to 1.
 			int start = 0;
@@ -81,8 +80,12 @@ ComponentValue* SubstringFunction::ComputeValue() {
 			int len = currentValue.length();
 			
 			// If start is larger than the length of the string, throw exception
-			if ( this->GetStart() > len)
-				throw Exception("Substring start index too large ("+Common::ToString(this->GetStart())+") for string value:\n"+currentValue, OvalEnum::LEVEL_ERROR);
+			if ( this->GetStart() > len) {
+				string msg = "Substring start index too large ("+Common::ToString(this->GetStart())+") for string value:\n"+currentValue;
+				delete componentValue;
+				delete result;
+				throw Exception(msg, OvalEnum::LEVEL_ERROR);
+			}
 			// otherwise, if substring_start is greater than 1 use the specified value.
 			else if ( this->GetStart() > 1 )
 				start = this->GetStart() - 1;
@@ -90,10 +93,8 @@ ComponentValue* SubstringFunction::ComputeValue() {
 			// If substring_length is greater than -1 and less than the the length of the string use the specified value.
 			if ( ( this->GetLength() > -1 ) && ( this->GetLength() < len ) ) len = this->GetLength(); 
 
-			newValue = currentValue.substr(start,len);		
-			values->push_back(newValue);
+			values->push_back(currentValue.substr(start,len));
 		}
-		result->SetValues(values);
 	}
 
 	delete componentValue;
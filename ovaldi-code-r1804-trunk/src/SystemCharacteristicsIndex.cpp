@@ -0,0 +1,133 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#include <xercesc/dom/DOMNode.hpp>
+
+#include "DocumentManager.h"
+
+#include "SystemCharacteristicsIndex.h"
+
+using namespace std;
+using namespace xercesc;
+
+//****************************************************************************************//
+//								SystemCharacteristicsIndex Class						  //	
+//****************************************************************************************//
+DOMDocument* SystemCharacteristicsIndex::indexedDoc = NULL;
+map<string, DOMElement*> SystemCharacteristicsIndex::collectedObjectsById;
+map<string, DOMElement*> SystemCharacteristicsIndex::itemsById;
+map<string, ElementVector> SystemCharacteristicsIndex::itemsByName;
+
+// ***************************************************************************************	//
+//								 Public members												//
+// ***************************************************************************************	//
+DOMElement* SystemCharacteristicsIndex::GetCollectedObject(string objectId) {
+
+	SystemCharacteristicsIndex::Build();
+
+	map<string, DOMElement*>::iterator iterator = SystemCharacteristicsIndex::collectedObjectsById.find(objectId);
+	if(iterator == SystemCharacteristicsIndex::collectedObjectsById.end())
+		return NULL;
+
+	return iterator->second;
+}
+
+DOMElement* SystemCharacteristicsIndex::GetItem(string itemId) {
+
+	SystemCharacteristicsIndex::Build();
+
+	map<string, DOMElement*>::iterator iterator = SystemCharacteristicsIndex::itemsById.find(itemId);
+	if(iterator == SystemCharacteristicsIndex::itemsById.end())
+		return NULL;
+
+	return iterator->second;
+}
+
+const ElementVector* SystemCharacteristicsIndex::GetItemsByName(string itemName) {
+
+	static const ElementVector noItems;
+
+	SystemCharacteristicsIndex::Build();
+
+	map<string, ElementVector>::iterator iterator = SystemCharacteristicsIndex::itemsByName.find(itemName);
+	if(iterator == SystemCharacteristicsIndex::itemsByName.end())
+		return &noItems;
+
+	return &iterator->second;
+}
+
+void SystemCharacteristicsIndex::Clear() {
+
+	SystemCharacteristicsIndex::collectedObjectsById.clear();
+	SystemCharacteristicsIndex::itemsById.clear();
+	SystemCharacteristicsIndex::itemsByName.clear();
+	SystemCharacteristicsIndex::indexedDoc = NULL;
+}
+
+// ***************************************************************************************	//
+//								 Private members											//
+// ***************************************************************************************	//
+void SystemCharacteristicsIndex::Build() {
+
+	DOMDocument* scDoc = DocumentManager::GetSystemCharacteristicsDocument();
+	if(scDoc == SystemCharacteristicsIndex::indexedDoc)
+		return;
+
+	SystemCharacteristicsIndex::Clear();
+	if(scDoc == NULL)
+		return;
+
+	DOMElement* collectedObjectsElm = XmlCommon::FindElement(scDoc, "collected_objects");
+	if(collectedObjectsElm != NULL)
+		SystemCharacteristicsIndex::IndexChildren(collectedObjectsElm, &SystemCharacteristicsIndex::collectedObjectsById, NULL);
+
+	DOMElement* systemDataElm = XmlCommon::FindElement(scDoc, "system_data");
+	if(systemDataElm != NULL)
+		SystemCharacteristicsIndex::IndexChildren(systemDataElm, &SystemCharacteristicsIndex::itemsById, &SystemCharacteristicsIndex::itemsByName);
+
+	SystemCharacteristicsIndex::indexedDoc = scDoc;
+}
+
+void SystemCharacteristicsIndex::IndexChildren(DOMElement* parentElm, map<string, DOMElement*>* byId, map<string, ElementVector>* byName) {
+
+	for(DOMNode* child = parentElm->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+		if(child->getNodeType() != DOMNode::ELEMENT_NODE)
+			continue;
+
+		DOMElement* childElm = (DOMElement*)child;
+		// like a search of the document, the first element with an id wins
+		byId->insert(make_pair(XmlCommon::GetAttributeByName(childElm, "id"), childElm));
+
+		if(byName != NULL) {
+			// group by the tag name, the same name the document would be searched by
+			(*byName)[XmlCommon::ToString(childElm->getTagName())].push_back(childElm);
+		}
+	}
+}
@@ -0,0 +1,84 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifndef SYSTEMCHARACTERISTICSINDEX_H
+#define SYSTEMCHARACTERISTICSINDEX_H
+
+#include <map>
+#include <string>
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+
+#include "XmlCommon.h"
+
+/**
+	This class provides fast lookups into the system characteristics document during analysis.
+	The collected objects and the items in the system data are indexed by id, and the items are 
+	also grouped by element name, in a single pass over the document the first time any lookup 
+	is made. Without the index every test would search the whole document for its collected 
+	object and every item reference would search the system data for its item.
+
+	The index is rebuilt automatically if the system characteristics document is replaced, and 
+	should be cleared once the analysis is complete.
+*/
+class SystemCharacteristicsIndex {
+public:
+
+	/** Return the collected object element with the specified id, or NULL if there is no such object. */
+	static xercesc::DOMElement* GetCollectedObject(std::string objectId);
+
+	/** Return the item element with the specified id, or NULL if there is no such item. */
+	static xercesc::DOMElement* GetItem(std::string itemId);
+
+	/** Return all item elements with the specified element name, such as 'file_item', in document order.
+		The returned vector is owned by the index and must not be deleted.
+	*/
+	static const ElementVector* GetItemsByName(std::string itemName);
+
+	/** Release the index. */
+	static void Clear();
+
+private:
+
+	/** Make sure the index reflects the current system characteristics document. */
+	static void Build();
+
+	/** Add every child element of the specified element to the id map. Optionally group them by element name. */
+	static void IndexChildren(xercesc::DOMElement* parentElm, std::map<std::string, xercesc::DOMElement*>* byId, std::map<std::string, ElementVector>* byName);
+
+	/** The document that the index was built from. */
+	static xercesc::DOMDocument* indexedDoc;
+
+	static std::map<std::string, xercesc::DOMElement*> collectedObjectsById;
+	static std::map<std::string, xercesc::DOMElement*> itemsById;
+	static std::map<std::string, ElementVector> itemsByName;
+};
+
+#endif
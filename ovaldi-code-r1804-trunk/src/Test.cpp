@@ -34,6 +34,7 @@
 
 #include "Log.h"
 #include "DocumentManager.h"
+#include "SystemCharacteristicsIndex.h"
 #include "XmlCommon.h"
 #include "Common.h"
 
@@ -270,6 +271,32 @@ void Test::ClearCache() {
 	Test::processedTestsMap.clear();
 }
 
+void Test::WriteNotEvaluated(DOMElement* parentElm) {
+
+	TestMap::iterator iterator;
+	for(iterator = Test::processedTestsMap.begin(); iterator != Test::processedTestsMap.end(); iterator++) {
+		
+		Test* test = iterator->second;
+		if(!test->GetWritten()) {
+			test->NotEvaluated();
+			test->Write(parentElm);
+		}
+	}
+}
+
+unsigned int Test::EstimateCost() {
+
+	if(this->GetAnalyzed()) {
+		return 0;
+	} else if(this->GetObjectId().compare("") == 0) {
+		// unknown tests are never looked up
+		return 1;
+	} else {
+		// finding the collected object and its items, plus comparing each state
+		return 2 + 2 * this->GetStateIds()->size();
+	}
+}
+
 void Test::Write(DOMElement* parentElm) {
 
 	if(!this->GetWritten()) {
@@ -397,7 +424,7 @@ OvalEnum::ResultEnumeration Test::Analyze() {
 			this->SetResult(OvalEnum::RESULT_UNKNOWN);
 		} else {
 			// get the collected object from the sc file
-			DOMElement* collectedObjElm = XmlCommon::FindElement(DocumentManager::GetSystemCharacteristicsDocument(), "object", "id", this->GetObjectId());
+			DOMElement* collectedObjElm = SystemCharacteristicsIndex::GetCollectedObject(this->GetObjectId());
 			OvalEnum::Flag collectedObjFlag = OvalEnum::FLAG_NOT_COLLECTED;
 
 			if(collectedObjElm == NULL) {
@@ -416,7 +443,7 @@ OvalEnum::ResultEnumeration Test::Analyze() {
 				}
 
 				// Find potential matching items in the system_data section
-				ElementVector* dataElems = XmlCommon::FindAllElements(DocumentManager::GetSystemCharacteristicsDocument(), componentName + "_item");
+				const ElementVector* dataElems = SystemCharacteristicsIndex::GetItemsByName(componentName + "_item");
                 if(dataElems->size() == 0) {
 					
                     // No potential matching items found
@@ -439,7 +466,7 @@ OvalEnum::ResultEnumeration Test::Analyze() {
                     // get the object referenced by the test.
                     Object* referencedObject = this->GetReferencedObject();
                     
-				    ElementVector::iterator iterator;
+				    ElementVector::const_iterator iterator;
                     for(iterator = dataElems->begin(); iterator != dataElems->end(); iterator++) {
                         DOMElement *itemElm = (*iterator);
                         string itemId = XmlCommon::GetAttributeByName(itemElm, "id");
@@ -822,7 +849,7 @@ OvalEnum::ResultEnumeration Test::EvaluateCheckState() {
                 for(StringSet::iterator it = this->GetStateIds()->begin(); it != this->GetStateIds()->end(); it++) {
                     currentStateId = (*it);
 		            State* state =  State::GetStateById(currentStateId);
-			        OvalEnum::ResultEnumeration stateResult = state->Analyze((*iterator)->GetItem());				        
+			        OvalEnum::ResultEnumeration stateResult = state->Analyze((*iterator)->GetItem(), this->GetVariableInstance());				        
 			        stateResults.push_back(stateResult);
                 }
                 
@@ -186,8 +186,16 @@ public:
     /** mark all the tested items as not evaluated. **/
     void MarkTestedItemsNotEvaluated();
 
+	/** Return a rough estimate of the work needed to analyze this test. Tests that are already analyzed cost nothing. */
+	unsigned int EstimateCost();
+
 	/** Delete all items in the cache. **/
 	static void ClearCache();
+	/** Mark every cached test that has not been written as not evaluated and write it.
+		Used at the end of the analysis to write out tests that were only referenced 
+		by short circuited criteria.
+	*/
+	static void WriteNotEvaluated(xercesc::DOMElement* parent);
 	/** Cache the specified Test. */
 	static void Cache(Test* test);
 
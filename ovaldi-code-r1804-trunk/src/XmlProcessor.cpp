@@ -42,11 +42,13 @@
 #include <xercesc/dom/DOMLocator.hpp>
 #include <xercesc/framework/StdOutFormatTarget.hpp>
 #include <xercesc/framework/LocalFileFormatTarget.hpp>
+#include <xercesc/framework/MemBufFormatTarget.hpp>
 #include <xercesc/util/XMLUni.hpp>
 
 // for entity resolver
 #include <xercesc/framework/LocalFileInputSource.hpp>
 #include <xercesc/framework/Wrapper4InputSource.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
 
 #include "XmlCommon.h"
 #include "Common.h"
@@ -92,6 +94,60 @@ DOMLSInput* DataDirResolver::resolveResource(const XMLCh *const /*resourceType*/
 	return new Wrapper4InputSource (lfis);	
 }
 
+//****************************************************************************************//
+//			HashingInputStream Class                                					  //	
+//****************************************************************************************//
+
+HashingInputStream::HashingInputStream(BinInputStream* stream, Digest* digest) : stream(stream), digest(digest) {
+}
+
+HashingInputStream::~HashingInputStream() {
+
+	// the parser may stop before the end of the file, the digest must cover all of it
+	XMLByte buffer[4096];
+	XMLSize_t read = 0;
+	try {
+		while((read = this->stream->readBytes(buffer, sizeof(buffer))) > 0)
+			this->digest->update(buffer, read);
+	} catch(...) {
+		// nothing more can be read, the digest won't match
+	}
+
+	delete this->stream;
+}
+
+XMLFilePos HashingInputStream::curPos() const {
+	return this->stream->curPos();
+}
+
+XMLSize_t HashingInputStream::readBytes(XMLByte* const toFill, const XMLSize_t maxToRead) {
+
+	XMLSize_t read = this->stream->readBytes(toFill, maxToRead);
+	if(read > 0)
+		this->digest->update(toFill, read);
+	return read;
+}
+
+const XMLCh* HashingInputStream::getContentType() const {
+	return this->stream->getContentType();
+}
+
+//****************************************************************************************//
+//			HashingInputSource Class                                					  //	
+//****************************************************************************************//
+
+HashingInputSource::HashingInputSource(const XMLCh* const filePath, Digest* digest) : LocalFileInputSource(filePath), digest(digest) {
+}
+
+BinInputStream* HashingInputSource::makeStream() const {
+
+	BinInputStream* stream = LocalFileInputSource::makeStream();
+	if(stream == NULL)
+		return NULL;
+
+	return new HashingInputStream(stream, this->digest);
+}
+
 //****************************************************************************************//
 //																						  //	
 //****************************************************************************************//
@@ -212,33 +268,78 @@ DOMLSParser *XmlProcessor::makeParser(const string &schemaLocation) {
 }
 
 DOMDocument* XmlProcessor::ParseFile(string filePathIn, bool callerAdopts) {
+
+	return this->ParseFile(filePathIn, (Digest*)NULL, callerAdopts);
+}
+
+DOMDocument* XmlProcessor::ParseFile(string filePathIn, Digest* digest, bool callerAdopts) {
+
+	if (digest == NULL)
+		return this->Parse(filePathIn, NULL, callerAdopts);
+
+	XMLCh* filePath = XMLString::transcode(filePathIn.c_str());
+	HashingInputSource source(filePath, digest);
+	//Free memory allocated by XMLString::transcode(char*)
+	XMLString::release(&filePath);
+
+	return this->Parse(filePathIn, &source, callerAdopts);
+}
+
+DOMDocument* XmlProcessor::ParseBuffer(const MemBufFormatTarget &xml, const string &systemId, bool callerAdopts) {
+
+	MemBufInputSource source(xml.getRawBuffer(), xml.getLen(), systemId.c_str(), false);
+
+	return this->Parse(systemId, &source, callerAdopts);
+}
+
+DOMDocument* XmlProcessor::ParseFileWithoutValidation(string filePathIn) {
+
+	DOMConfiguration *domCfg = parserWithCallerAdoption->getDomConfig();
+	domCfg->setParameter(XMLUni::fgDOMValidate, false);
+
+	DOMDocument *resultDocument = NULL;
+	try {
+		resultDocument = this->Parse(filePathIn, NULL, true);
+	} catch(...) {
+		domCfg->setParameter(XMLUni::fgDOMValidate, true);
+		throw;
+	}
+	domCfg->setParameter(XMLUni::fgDOMValidate, true);
+
+	return resultDocument;
+}
+
+DOMDocument* XmlProcessor::Parse(const string &name, InputSource *source, bool callerAdopts) {
 	
     DOMDocument *resultDocument = NULL;
 
     try  {
 		errHandler.resetErrors();
-		if (callerAdopts)
-			resultDocument = parserWithCallerAdoption->parseURI(filePathIn.c_str());
-		else
-			resultDocument = parser->parseURI(filePathIn.c_str());
+		DOMLSParser *selectedParser = callerAdopts ? parserWithCallerAdoption : parser;
+		if (source == NULL) {
+			resultDocument = selectedParser->parseURI(name.c_str());
+		} else {
+			Wrapper4InputSource input(source, false);
+			resultDocument = selectedParser->parse(&input);
+		}
 
     } catch (const XMLException& toCatch) {
 		string error = "Error while parsing xml file:";
-		error.append(filePathIn);
+		error.append(name);
 		error.append("\n\tMessage: \n\t");
 		error.append(XmlCommon::ToString(toCatch.getMessage()));
 		throw XmlProcessorException(error);
 
     } catch (const DOMException& toCatch) {
 		string error = "Error while parsing xml file:";
-		error.append(filePathIn);
+		error.append(name);
 		error.append("\n\tMessage: \n\t");
 		error.append(XmlCommon::ToString(toCatch.msg));
 		throw XmlProcessorException(error);
 
 	} catch (...) {
         string error = "Error while parsing xml file:";
-		error.append(filePathIn);
+		error.append(name);
 		error.append("\n\tMessage: \n\tUnknown message");
 		throw XmlProcessorException(error);
     }
@@ -280,8 +381,65 @@ DOMDocument* XmlProcessor::CreateDOMDocumentNS(string namespaceURI, string quali
 
 void XmlProcessor::WriteDOMDocument(DOMDocument* doc,  string filePath, bool writeToFile) {
 
-	DOMLSOutput *out = NULL;
 	XMLFormatTarget *myFormTarget = NULL;
+
+	try
+	{
+		//
+		// Plug in a format target to receive the resultant
+		// XML stream from the serializer.
+		//
+		// StdOutFormatTarget prints the resultant XML stream
+		// to stdout once it receives any thing from the serializer.
+		//
+		if (writeToFile)
+			myFormTarget = new LocalFileFormatTarget(filePath.c_str());
+		else
+			myFormTarget = new StdOutFormatTarget();
+
+		this->Serialize(doc, myFormTarget);
+
+		delete myFormTarget;
+	}
+	catch(...)
+	{
+		string error;
+		if(writeToFile)
+		{
+			error.append("Error while writing Document to XML file: ");
+			error.append(filePath);
+		}else
+		{
+			error.append("Error while writing Document to screen");
+		}
+
+		if (myFormTarget) delete myFormTarget;
+
+		throw XmlProcessorException(error);
+	}
+}
+
+void XmlProcessor::WriteAndSerializeDOMDocument(DOMDocument* doc, string filePath, MemBufFormatTarget* xml) {
+
+	try
+	{
+		this->Serialize(doc, xml);
+	}
+	catch(...)
+	{
+		throw XmlProcessorException("Error while writing Document to XML file: " + filePath);
+	}
+
+	ofstream out(filePath.c_str(), ios::out | ios::binary | ios::trunc);
+	out.write((const char*)xml->getRawBuffer(), xml->getLen());
+	out.close();
+	if(out.fail())
+		throw XmlProcessorException("Error while writing Document to XML file: " + filePath);
+}
+
+void XmlProcessor::Serialize(DOMDocument* doc, XMLFormatTarget *target) {
+
+	DOMLSOutput *out = NULL;
 	DOMLSSerializer *theSerializer = NULL;
 
 	try
@@ -305,20 +463,8 @@ void XmlProcessor::WriteDOMDocument(DOMDocument* doc,  string filePath, bool wri
 		if (domCfg->canSetParameter(XMLUni::fgDOMWRTBOM, false))
 			domCfg->setParameter(XMLUni::fgDOMWRTBOM, false);
 
-		//
-		// Plug in a format target to receive the resultant
-		// XML stream from the serializer.
-		//
-		// StdOutFormatTarget prints the resultant XML stream
-		// to stdout once it receives any thing from the serializer.
-		//
-		if (writeToFile)
-			myFormTarget = new LocalFileFormatTarget(filePath.c_str());
-		else
-			myFormTarget = new StdOutFormatTarget();
-
-		DOMLSOutput *out = impl->createLSOutput();
-		out->setByteStream(myFormTarget);
+		out = impl->createLSOutput();
+		out->setByteStream(target);
 
 		//
 		// do the serialization through DOMWriter::writeNode();
@@ -327,25 +473,13 @@ void XmlProcessor::WriteDOMDocument(DOMDocument* doc,  string filePath, bool wri
 
 		out->release();
 		theSerializer->release();
-		delete myFormTarget;
 	}
 	catch(...)
 	{
-		string error;
-		if(writeToFile)
-		{
-			error.append("Error while writing Document to XML file: ");
-			error.append(filePath);
-		}else
-		{
-			error.append("Error while writing Document to screen");
-		}
-
-		if (myFormTarget) delete myFormTarget;
 		if (out) out->release();
 		if (theSerializer) theSerializer->release();
 
-		throw XmlProcessorException(error);
+		throw XmlProcessorException("Error while serializing Document");
 	}
 }
 
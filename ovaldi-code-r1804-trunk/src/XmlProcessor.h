@@ -41,7 +41,14 @@
 
 // for entity resolver
 #include <xercesc/dom/DOMLSResourceResolver.hpp>
+#include <xercesc/framework/LocalFileInputSource.hpp>
+#include <xercesc/framework/MemBufFormatTarget.hpp>
+#include <xercesc/util/BinInputStream.hpp>
 
+// for dom Writer
+#include <xercesc/framework/XMLFormatter.hpp>
+
+#include "Digest.h"
 #include "Exception.h"
 
 /** 
@@ -58,6 +65,45 @@ public:
 												const XMLCh *const baseURI);
 };
 
+/**
+ * An input stream that adds every byte read through it to a digest.
+ * Whatever the parser leaves unread is added when the stream is deleted,
+ * so the digest always covers the whole file.
+ */
+class HashingInputStream : public xercesc::BinInputStream {
+public:
+	/** Takes ownership of the wrapped stream. */
+	HashingInputStream(xercesc::BinInputStream* stream, Digest* digest);
+	virtual ~HashingInputStream();
+
+	virtual XMLFilePos curPos() const;
+	virtual XMLSize_t readBytes(XMLByte* const toFill, const XMLSize_t maxToRead);
+	virtual const XMLCh* getContentType() const;
+
+private:
+	/** Unimplemented constructor */
+	HashingInputStream(const HashingInputStream&);
+	/** Unimplemented operators */
+	void operator=(const HashingInputStream&);
+
+	xercesc::BinInputStream* stream;
+	Digest* digest;
+};
+
+/**
+ * A local file input source whose stream adds the file's bytes to a digest
+ * as the parser reads them.
+ */
+class HashingInputSource : public xercesc::LocalFileInputSource {
+public:
+	HashingInputSource(const XMLCh* const filePath, Digest* digest);
+
+	virtual xercesc::BinInputStream* makeStream() const;
+
+private:
+	Digest* digest;
+};
+
 /**
 	Simple error handler deriviative to	install	on parser.
 */
@@ -118,10 +164,35 @@ public:
 	 * \return the DOM document
 	 */
 	xercesc::DOMDocument*	ParseFile(std::string filePathIn, bool callerAdopts = false);
+	/**
+	 * Same as ParseFile(std::string, bool), but the file's bytes are also added
+	 * to the specified digest as they are read, so a file that must be both
+	 * hashed and parsed is only read once.  The digest must have been started
+	 * and is finished by the caller.  If digest is NULL the file is just parsed.
+	 */
+	xercesc::DOMDocument*	ParseFile(std::string filePathIn, Digest* digest, bool callerAdopts = false);
+	/**
+	 * Same as ParseFile(std::string, bool), but the xml is taken from the
+	 * specified buffer rather than read from a file.  The buffer is not copied.
+	 * The systemId names the document in error messages and is used to resolve
+	 * relative references, so it should be the path the xml was written to.
+	 */
+	xercesc::DOMDocument*	ParseBuffer(const xercesc::MemBufFormatTarget &xml, const std::string &systemId, bool callerAdopts = false);
+	/**
+	 * Parse the specified file without validating it.  Only for files this
+	 * process wrote itself, such as the partial documents of worker processes,
+	 * which aren't complete enough to be valid.  The caller adopts the document.
+	 */
+	xercesc::DOMDocument*	ParseFileWithoutValidation(std::string filePathIn);
 	/** Write the DOMDocument to the specified XML file.
 		filePath is the filename and path to the file that will be written
 	*/
 	void WriteDOMDocument(xercesc::DOMDocument* doc, std::string filePath,	bool writeToFile=true);
+	/** Write the DOMDocument to the specified XML file, serializing it into the caller's buffer.
+		The document is only serialized once and the buffer then holds the xml that was written,
+		so it can be parsed or transformed again without reading the file back or copying it.
+	*/
+	void WriteAndSerializeDOMDocument(xercesc::DOMDocument* doc, std::string filePath, xercesc::MemBufFormatTarget* xml);
 
 private:
 	/** Init the XmlProcessor
@@ -134,6 +205,19 @@ private:
 	 */
 	xercesc::DOMLSParser *makeParser(const std::string &schemaLocation = "");
 
+	/**
+	 * Has the common code for parsing a document and reporting errors.  If
+	 * source is NULL, name is parsed as a uri, otherwise name is only used
+	 * in error messages.
+	 */
+	xercesc::DOMDocument* Parse(const std::string &name, xercesc::InputSource *source, bool callerAdopts);
+
+	/**
+	 * Has the common code for serializing a document to a format target.
+	 * Throws an XmlProcessorException if there is an error.
+	 */
+	void Serialize(xercesc::DOMDocument* doc, xercesc::XMLFormatTarget *target);
+
 	static XmlProcessor* instance;
 
 	/**
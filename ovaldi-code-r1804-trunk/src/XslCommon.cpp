@@ -29,24 +29,29 @@
 //****************************************************************************************//
 
 #include <sstream>
+#include <streambuf>
+#include <xercesc/framework/MemBufFormatTarget.hpp>
 #include <xalanc/XalanTransformer/XalanTransformer.hpp>
+#include <xalanc/XalanTransformer/XalanCompiledStylesheet.hpp>
+#include <xalanc/XalanTransformer/XalanParsedSource.hpp>
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
 
-#include "Noncopyable.h"
+#include "Exception.h"
+#include "Log.h"
 
 #include "XslCommon.h"
 
 using namespace std;
 using namespace xalanc;
+using xercesc::MemBufFormatTarget;
 
 namespace {
-	/** Enables exception-safe init and shutdown of xalanc::XalanTransformer. */
-	class TransformerInitializer : private Noncopyable {
+	/** A read only stream buffer over memory owned by someone else, so it can be read without a copy. */
+	class MemoryStreamBuffer : public streambuf {
 	public:
-		TransformerInitializer() {
-			XalanTransformer::initialize();
-		}
-		~TransformerInitializer() {
-			XalanTransformer::terminate();
+		MemoryStreamBuffer(const char* data, size_t length) {
+			char* start = const_cast<char*>(data);
+			this->setg(start, start, start + length);
 		}
 	};
 }
@@ -54,20 +59,124 @@ namespace {
 //****************************************************************************************//
 //										XslCommon Class									  //	
 //****************************************************************************************//
+XalanTransformer* XslCommon::transformer = NULL;
+map<string, const XalanCompiledStylesheet*> XslCommon::stylesheets;
 
 void XslCommon::ApplyXSL(string xmlIn, string xslIn, string xmlOut) {
-	TransformerInitializer init;
-	XalanTransformer xform;
 
-	xform.transform(xmlIn.c_str(), xslIn.c_str(), xmlOut.c_str());
+	const XalanCompiledStylesheet* stylesheet = XslCommon::GetStylesheet(xslIn);
+	if(stylesheet == NULL)
+		return;
+
+	if(XslCommon::GetTransformer()->transform(XSLTInputSource(xmlIn.c_str()), stylesheet, XSLTResultTarget(xmlOut.c_str())) != 0)
+		Log::Info("Error applying " + xslIn + " to " + xmlIn + ": " + XslCommon::GetTransformer()->getLastError());
 }
 
 string XslCommon::ApplyXSL(string xmlIn, string xslIn) {
-	TransformerInitializer init;
-	XalanTransformer xform;
+
+	const XalanCompiledStylesheet* stylesheet = XslCommon::GetStylesheet(xslIn);
+	if(stylesheet == NULL)
+		return "";
+
 	ostringstream out;
+	if(XslCommon::GetTransformer()->transform(XSLTInputSource(xmlIn.c_str()), stylesheet, XSLTResultTarget(out)) != 0)
+		Log::Info("Error applying " + xslIn + " to " + xmlIn + ": " + XslCommon::GetTransformer()->getLastError());
+
+	return out.str();
+}
+
+void XslCommon::CompileXSL(string xslIn) {
+	XslCommon::GetStylesheet(xslIn);
+}
+
+void XslCommon::Shutdown() {
+
+	if(XslCommon::transformer == NULL)
+		return;
 
-	xform.transform(xmlIn.c_str(), xslIn.c_str(), out);
+	for(map<string, const XalanCompiledStylesheet*>::iterator iterator = XslCommon::stylesheets.begin(); iterator != XslCommon::stylesheets.end(); iterator++) {
+		if(iterator->second != NULL)
+			XslCommon::transformer->destroyStylesheet(iterator->second);
+	}
+	XslCommon::stylesheets.clear();
+
+	delete XslCommon::transformer;
+	XslCommon::transformer = NULL;
+	XalanTransformer::terminate();
+}
+
+XalanTransformer* XslCommon::GetTransformer() {
+
+	if(XslCommon::transformer == NULL) {
+		XalanTransformer::initialize();
+		XslCommon::transformer = new XalanTransformer();
+	}
+
+	return XslCommon::transformer;
+}
+
+const XalanCompiledStylesheet* XslCommon::GetStylesheet(const string &xslIn) {
+
+	map<string, const XalanCompiledStylesheet*>::iterator iterator = XslCommon::stylesheets.find(xslIn);
+	if(iterator != XslCommon::stylesheets.end())
+		return iterator->second;
+
+	// a stylesheet that failed to compile is remembered too, so it is only reported once
+	const XalanCompiledStylesheet* stylesheet = NULL;
+	if(XslCommon::GetTransformer()->compileStylesheet(XSLTInputSource(xslIn.c_str()), stylesheet) != 0) {
+		Log::Info("Error compiling " + xslIn + ": " + XslCommon::GetTransformer()->getLastError());
+		stylesheet = NULL;
+	}
+
+	XslCommon::stylesheets[xslIn] = stylesheet;
+	return stylesheet;
+}
+
+//****************************************************************************************//
+//										XslSource Class									  //	
+//****************************************************************************************//
+XslSource::XslSource(const MemBufFormatTarget &xml, const string &systemId) : parsedSource(NULL), systemId(systemId) {
+
+	MemoryStreamBuffer buffer((const char*)xml.getRawBuffer(), xml.getLen());
+	istream in(&buffer);
+	XSLTInputSource input(&in);
+	input.setSystemId(XalanDOMString(systemId.c_str()).c_str());
+
+	if(XslCommon::GetTransformer()->parseSource(input, this->parsedSource) != 0) {
+		this->parsedSource = NULL;
+		throw Exception("Error parsing " + systemId + " for xsl processing: " + XslCommon::GetTransformer()->getLastError());
+	}
+}
+
+XslSource::~XslSource() {
+
+	if(this->parsedSource != NULL && XslCommon::transformer != NULL)
+		XslCommon::transformer->destroyParsedSource(this->parsedSource);
+}
+
+void XslSource::ApplyXSL(const string &xslIn, const string &xmlOut) {
+
+	const XalanCompiledStylesheet* stylesheet = XslCommon::GetStylesheet(xslIn);
+	if(stylesheet == NULL)
+		return;
+
+	if(XslCommon::GetTransformer()->transform(*this->parsedSource, stylesheet, XSLTResultTarget(xmlOut.c_str())) != 0)
+		Log::Info("Error applying " + xslIn + " to " + this->systemId + ": " + XslCommon::GetTransformer()->getLastError());
+}
+
+string XslSource::ApplyXSL(const string &xslIn) {
+
+	const XalanCompiledStylesheet* stylesheet = XslCommon::GetStylesheet(xslIn);
+	if(stylesheet == NULL)
+		return "";
+
+	ostringstream out;
+	if(XslCommon::GetTransformer()->transform(*this->parsedSource, stylesheet, XSLTResultTarget(out)) != 0)
+		Log::Info("Error applying " + xslIn + " to " + this->systemId + ": " + XslCommon::GetTransformer()->getLastError());
 
 	return out.str();
 }
+
+string XslSource::GetSystemId() const {
+	return this->systemId;
+}
@@ -31,10 +31,30 @@
 #ifndef XSLCOMMON_H
 #define XSLCOMMON_H
 
+#include <map>
 #include <string>
 
+#include <xercesc/util/XercesDefs.hpp>
+#include <xalanc/Include/PlatformDefinitions.hpp>
+
+#include "Noncopyable.h"
+
+XERCES_CPP_NAMESPACE_BEGIN
+class MemBufFormatTarget;
+XERCES_CPP_NAMESPACE_END
+
+XALAN_CPP_NAMESPACE_BEGIN
+class XalanCompiledStylesheet;
+class XalanParsedSource;
+class XalanTransformer;
+XALAN_CPP_NAMESPACE_END
+
 /**
 	This class encapsulates a set of static methods for applying an xsl to an xml file
+
+	The xsl processor is started the first time it is needed and stays up until Shutdown() 
+	is called. Each stylesheet is compiled once and reused for every later transform, so 
+	a batch of files, or a schematron and a results xsl, don't pay for compiling it again.
 */
 class XslCommon {
 public:
@@ -48,7 +68,59 @@ public:
 		Apply the specified xsl to the specified xml and output the reuslt as a string.
 	*/
 	static std::string ApplyXSL(std::string xmlFilePath, std::string xslFilePath);
+
+	/**
+		Compile the specified xsl now rather than when it is first applied. Used before
+		forking workers so that they all share the compiled stylesheet.
+	*/
+	static void CompileXSL(std::string xslFilePath);
+
+	/**
+		Release all compiled stylesheets and shut down the xsl processor.
+		Must be called before xerces is terminated.
+	*/
+	static void Shutdown();
+
+private:
+	friend class XslSource;
+
+	/** Return the xsl processor, starting it if needed. */
+	static xalanc::XalanTransformer* GetTransformer();
+
+	/** Return the compiled form of the specified xsl, compiling it if needed. NULL if it can't be compiled. */
+	static const xalanc::XalanCompiledStylesheet* GetStylesheet(const std::string &xslFilePath);
+
+	static xalanc::XalanTransformer* transformer;
+	static std::map<std::string, const xalanc::XalanCompiledStylesheet*> stylesheets;
 };
 
+/**
+	An xml document held in memory, parsed once by the xsl processor so that any 
+	number of stylesheets can be applied to it without reading or parsing it again.
+*/
+class XslSource : private Noncopyable {
+public:
+	/** 
+		Parse the xml in the buffer, which is read in place rather than copied. The systemId 
+		names the document in messages and is used to resolve relative references. An 
+		Exception is thrown if the xml can't be parsed.
+	*/
+	XslSource(const xercesc::MemBufFormatTarget &xml, const std::string &systemId);
+
+	~XslSource();
+
+	/** Apply the specified xsl and output to the specified file. */
+	void ApplyXSL(const std::string &xslFilePath, const std::string &outputFilePath);
+
+	/** Apply the specified xsl and output the result as a string. */
+	std::string ApplyXSL(const std::string &xslFilePath);
+
+	/** Return the name of the document. */
+	std::string GetSystemId() const;
+
+private:
+	const xalanc::XalanParsedSource* parsedSource;
+	std::string systemId;
+};
 
 #endif
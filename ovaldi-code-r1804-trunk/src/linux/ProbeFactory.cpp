@@ -70,6 +70,9 @@
 #include "SelinuxBooleanProbe.h"
 #include "IfListenersProbe.h"
 #include "SysctlProbe.h"
+#include "ProcessTable.h"
+#include "AccountTable.h"
+#include "TimedFileOps.h"
 
 #include "ProbeFactory.h"
 
@@ -176,4 +179,13 @@ void ProbeFactory::Shutdown() {
     delete (*iter);  // the probe better set it's instance pointer to NULL inside of its destructor
     _probes.erase( iter++ );
   }
+
+  // the process table snapshot only lives as long as the probes that share it
+  ProcessTable::Clear();
+
+  // the account snapshot is shared by the probes as well
+  AccountTable::Clear();
+
+  // no more file system calls will be made
+  TimedFileOps::Shutdown();
 } 
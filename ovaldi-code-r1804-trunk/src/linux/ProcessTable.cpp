@@ -0,0 +1,492 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+#include "Common.h"
+#include "AbsProbe.h"
+#include "DirGuard.h"
+
+#include "ProcessTable.h"
+
+using namespace std;
+
+//****************************************************************************************//
+//								ProcessTable Class										  //	
+//****************************************************************************************//
+int ProcessTable::procFd = -1;
+time_t ProcessTable::snapshotTime = 0;
+unsigned long ProcessTable::uptime = 0;
+bool ProcessTable::uptimeRead = false;
+string ProcessTable::uptimeErr;
+ProcessTable::CommandLineVector ProcessTable::commandLines;
+multimap<string, string> ProcessTable::pidsByCommandLine;
+map<string, string*> ProcessTable::commandLineByPid;
+map<string, ProcessTable::ProcessData> ProcessTable::processData;
+vector<char> ProcessTable::readBuffer;
+
+// ***************************************************************************************	//
+//								 Public members												//
+// ***************************************************************************************	//
+const ProcessTable::CommandLineVector& ProcessTable::GetCommandLines() {
+
+	ProcessTable::Capture();
+	return ProcessTable::commandLines;
+}
+
+StringVector ProcessTable::GetPids() {
+
+	ProcessTable::Capture();
+
+	StringVector pids;
+	pids.reserve(ProcessTable::commandLines.size());
+	for(CommandLineVector::iterator iterator = ProcessTable::commandLines.begin(); iterator != ProcessTable::commandLines.end(); iterator++) {
+		pids.push_back(iterator->first);
+	}
+	return pids;
+}
+
+const string* ProcessTable::GetCommandLine(const string &pid) {
+
+	ProcessTable::Capture();
+
+	map<string, string*>::iterator iterator = ProcessTable::commandLineByPid.find(pid);
+	if(iterator == ProcessTable::commandLineByPid.end())
+		return NULL;
+	return iterator->second;
+}
+
+bool ProcessTable::FindByCommandLine(const string &cmdline, StringVector *pids) {
+
+	ProcessTable::Capture();
+
+	bool found = false;
+	pair<multimap<string, string>::iterator, multimap<string, string>::iterator> range = ProcessTable::pidsByCommandLine.equal_range(cmdline);
+	for(multimap<string, string>::iterator iterator = range.first; iterator != range.second; iterator++) {
+		pids->push_back(iterator->second);
+		found = true;
+	}
+	return found;
+}
+
+bool ProcessTable::GetUptime(unsigned long *uptimeOut, time_t *snapshotTimeOut, string *errMsg) {
+
+	ProcessTable::Capture();
+
+	if(!ProcessTable::uptimeRead) {
+		*errMsg = ProcessTable::uptimeErr;
+		return false;
+	}
+
+	*uptimeOut = ProcessTable::uptime;
+	*snapshotTimeOut = ProcessTable::snapshotTime;
+	return true;
+}
+
+ProcessTable::ProcStatus ProcessTable::GetStat(const string &pid, StatInfo *info, string *errMsg) {
+
+	ProcessData* data = ProcessTable::GetData(pid);
+	if(!data->statRead) {
+		size_t len = 0;
+		data->statResult = ProcessTable::ReadFile(pid + "/stat", 0, &len, &data->statErr);
+		if(data->statResult == PROC_OK && !ProcessTable::ParseStat(&ProcessTable::readBuffer[0], len, &data->stat)) {
+			data->statResult = PROC_ERROR;
+			data->statErr = "Could not parse /proc/" + pid + "/stat";
+		}
+		data->statRead = true;
+	}
+
+	if(data->statResult == PROC_OK)
+		*info = data->stat;
+	else if(data->statResult == PROC_ERROR)
+		*errMsg = data->statErr;
+	return data->statResult;
+}
+
+ProcessTable::ProcStatus ProcessTable::GetStatus(const string &pid, StatusInfo *info, string *errMsg) {
+
+	ProcessData* data = ProcessTable::GetData(pid);
+	if(!data->statusRead) {
+		size_t len = 0;
+		data->statusResult = ProcessTable::ReadFile(pid + "/status", 0, &len, &data->statusErr);
+		if(data->statusResult == PROC_OK) {
+			string label;
+			if(!ProcessTable::ParseStatus(&ProcessTable::readBuffer[0], len, &data->status, &label)) {
+				data->statusResult = PROC_ERROR;
+				data->statusErr = "Premature end-of-line while reading " + label + " from /proc/" + pid + "/status";
+			}
+		}
+		data->statusRead = true;
+	}
+
+	if(data->statusResult == PROC_OK)
+		*info = data->status;
+	else if(data->statusResult == PROC_ERROR)
+		*errMsg = data->statusErr;
+	return data->statusResult;
+}
+
+ProcessTable::ProcStatus ProcessTable::GetTTY(const string &pid, string *tty, string *errMsg) {
+
+	ProcessData* data = ProcessTable::GetData(pid);
+	if(!data->ttyRead) {
+		// We can retrieve a value for the tty from the 'stat' file, but it's unclear
+		// how you convert that to a device name.  Therefore, we ignore that value
+		// and grab the device stdin(fd/0) is attached to.
+		char ttyName[PATH_MAX + 1];
+		string ttyPath = pid + "/fd/0";
+		ssize_t bytes = readlinkat(ProcessTable::procFd, ttyPath.c_str(), ttyName, PATH_MAX);
+
+		data->ttyResult = PROC_OK;
+		if(bytes < 0) {
+			// Not every process has a /proc/<pid>/fd/0 symlink, so a missing
+			// link just means the process has no stdin.
+			if(errno != ENOENT) {
+				data->ttyErr = "readlink(/proc/" + ttyPath + "): " + strerror(errno);
+				data->ttyResult = PROC_ERROR;
+			}
+			data->tty = "?";
+		} else {
+			ttyName[bytes] = '\0';
+			data->tty = (strncmp(ttyName, "/dev", 4) == 0) ? ttyName : "?";
+		}
+		data->ttyRead = true;
+	}
+
+	*tty = data->tty;
+	if(data->ttyResult == PROC_ERROR)
+		*errMsg = data->ttyErr;
+	return data->ttyResult;
+}
+
+ProcessTable::ProcStatus ProcessTable::GetLoginUid(const string &pid, uid_t *loginUid, string *errMsg) {
+
+	ProcessData* data = ProcessTable::GetData(pid);
+	if(!data->loginUidRead) {
+		size_t len = 0;
+		data->loginUidResult = ProcessTable::ReadFile(pid + "/loginuid", 0, &len, &data->loginUidErr);
+		if(data->loginUidResult == PROC_OK) {
+			const char* buf = &ProcessTable::readBuffer[0];
+			char* end = NULL;
+			errno = 0;
+			unsigned long value = strtoul(buf, &end, 10);
+			if(end == buf || errno != 0) {
+				data->loginUidResult = PROC_ERROR;
+				data->loginUidErr = "Couldn't interpret contents of /proc/" + pid + "/loginuid as a uid";
+			} else {
+				data->loginUid = (uid_t)value;
+			}
+		}
+		data->loginUidRead = true;
+	}
+
+	if(data->loginUidResult == PROC_OK)
+		*loginUid = data->loginUid;
+	else if(data->loginUidResult == PROC_ERROR)
+		*errMsg = data->loginUidErr;
+	return data->loginUidResult;
+}
+
+ProcessTable::ProcStatus ProcessTable::GetEnvironment(const string &pid, map<string, string> *env, string *errMsg) {
+
+	ProcessTable::Capture();
+
+	// The format of the environ file is:
+	// <entry>\0<entry>\0 ... <entry>\0
+	// Normally formatted entries look like <name>=<val>.  Values are not
+	// assumed to be text, so the raw bytes are kept.
+	size_t len = 0;
+	ProcStatus status = ProcessTable::ReadFile(pid + "/environ", 0, &len, errMsg);
+	if(status != PROC_OK)
+		return status;
+
+	const char* entry = &ProcessTable::readBuffer[0];
+	const char* end = entry + len;
+	while(entry < end) {
+		const char* entryEnd = (const char*)memchr(entry, '\0', end - entry);
+		if(entryEnd == NULL)
+			entryEnd = end;
+
+		// There are a lot of environ files with entries that do not conform
+		// to the normal rules for environment variables, so entries without
+		// an '=' are silently skipped.
+		const char* eq = (const char*)memchr(entry, '=', entryEnd - entry);
+		if(eq != NULL)
+			(*env)[string(entry, eq)] = string(eq + 1, entryEnd);
+
+		entry = entryEnd + 1;
+	}
+
+	return PROC_OK;
+}
+
+void ProcessTable::Clear() {
+
+	if(ProcessTable::procFd != -1) {
+		close(ProcessTable::procFd);
+		ProcessTable::procFd = -1;
+	}
+
+	ProcessTable::snapshotTime = 0;
+	ProcessTable::uptime = 0;
+	ProcessTable::uptimeRead = false;
+	ProcessTable::uptimeErr.clear();
+	ProcessTable::commandLines.clear();
+	ProcessTable::pidsByCommandLine.clear();
+	ProcessTable::commandLineByPid.clear();
+	ProcessTable::processData.clear();
+	vector<char>().swap(ProcessTable::readBuffer);
+}
+
+// ***************************************************************************************	//
+//								 Private members											//
+// ***************************************************************************************	//
+void ProcessTable::Capture() {
+
+	if(ProcessTable::procFd != -1)
+		return;
+
+	DirGuard procDir("/proc", false);
+	if(procDir.isClosed())
+		throw ProbeException(string("Could not open /proc: ") + strerror(errno));
+
+	ProcessTable::procFd = open("/proc", O_RDONLY | O_DIRECTORY);
+	if(ProcessTable::procFd == -1)
+		throw ProbeException(string("Could not open /proc: ") + strerror(errno));
+
+	// Grab the current time and uptime together so that start and exec times
+	// calculated from them are the same for every object in the run.
+	size_t len = 0;
+	ProcessTable::snapshotTime = time(NULL);
+	if(ProcessTable::ReadFile("uptime", 0, &len, &ProcessTable::uptimeErr) == PROC_OK) {
+		// The second value in this file represents idle time - we're not concerned with this.
+		ProcessTable::uptime = strtoul(&ProcessTable::readBuffer[0], NULL, 10);
+		ProcessTable::uptimeRead = true;
+	} else if(ProcessTable::uptimeErr.empty()) {
+		ProcessTable::uptimeErr = "Could not open /proc/uptime";
+	}
+
+	// Loop through all of the entries - we're only concerned with those that
+	// are made up of digits
+	dirent* entry = NULL;
+	while((entry = readdir(procDir)) != NULL) {
+		const char* name = entry->d_name;
+		const char* c = name;
+		while(isdigit(*c))
+			c++;
+		if(c == name || *c != '\0')
+			continue;
+
+		string pid = name;
+		string errMsg;
+		ProcStatus status = ProcessTable::ReadFile(pid + "/cmdline", MAX_CMDLINE_LEN, &len, &errMsg);
+		if(status == PROC_TERMINATED) {
+			continue;
+		} else if(status == PROC_ERROR) {
+			ProcessTable::Clear();
+			throw ProbeException("Unable to obtain command line for pid: " + pid + ". " + errMsg);
+		}
+
+		// Convert the NULs separating the args to spaces and clean up any
+		// trailing spaces.
+		char* buf = &ProcessTable::readBuffer[0];
+		for(size_t i = 0; i < len; i++) {
+			if(buf[i] == '\0')
+				buf[i] = ' ';
+		}
+		string cmdline(buf, len);
+		Common::TrimEnd(cmdline);
+
+		ProcessTable::commandLines.push_back(make_pair(pid, cmdline));
+	}
+
+	// index the snapshot once the vector has stopped growing
+	for(CommandLineVector::iterator iterator = ProcessTable::commandLines.begin(); iterator != ProcessTable::commandLines.end(); iterator++) {
+		ProcessTable::pidsByCommandLine.insert(make_pair(iterator->second, iterator->first));
+		ProcessTable::commandLineByPid[iterator->first] = &iterator->second;
+	}
+}
+
+ProcessTable::ProcessData* ProcessTable::GetData(const string &pid) {
+
+	ProcessTable::Capture();
+	return &ProcessTable::processData[pid];
+}
+
+ProcessTable::ProcStatus ProcessTable::ReadFile(const string &path, size_t maxLen, size_t *len, string *errMsg) {
+
+	int fd = openat(ProcessTable::procFd, path.c_str(), O_RDONLY);
+	if(fd == -1) {
+		// Processes come and go; if it went away, that's ok.
+		if(errno == ENOENT || errno == ESRCH)
+			return PROC_TERMINATED;
+
+		*errMsg = "Error opening /proc/" + path + ": " + strerror(errno);
+		return PROC_ERROR;
+	}
+
+	// Files in /proc report a size of zero, so read until end of file,
+	// growing the shared buffer as needed.  One byte is always kept free
+	// for the terminating NUL.
+	size_t total = 0;
+	while(maxLen == 0 || total < maxLen) {
+		if(ProcessTable::readBuffer.size() - total < 4097)
+			ProcessTable::readBuffer.resize(ProcessTable::readBuffer.size() * 2 + 4097);
+
+		size_t toRead = ProcessTable::readBuffer.size() - total - 1;
+		if(maxLen != 0 && toRead > maxLen - total)
+			toRead = maxLen - total;
+
+		ssize_t bytes = read(fd, &ProcessTable::readBuffer[total], toRead);
+		if(bytes < 0) {
+			if(errno == EINTR)
+				continue;
+
+			int err = errno;
+			close(fd);
+			if(err == ESRCH)
+				return PROC_TERMINATED;
+
+			*errMsg = "Error reading /proc/" + path + ": " + strerror(err);
+			return PROC_ERROR;
+		} else if(bytes == 0) {
+			break;
+		}
+		total += bytes;
+	}
+	close(fd);
+
+	ProcessTable::readBuffer[total] = '\0';
+	*len = total;
+	return PROC_OK;
+}
+
+bool ProcessTable::ParseStat(const char *buf, size_t len, StatInfo *info) {
+
+	// The command name is in parentheses and may itself contain spaces or
+	// parentheses, so fields are counted from the last ')'.  The first field
+	// after it is the state, which is field 3 in proc(5).
+	const char* end = buf + len;
+	const char* p = end;
+	while(p > buf && *(p - 1) != ')')
+		p--;
+	if(p == buf)
+		return false;
+
+	const int PPID = 4, SESSION = 6, PRIORITY = 18, STARTTIME = 22, POLICY = 41;
+	int field = 3;
+	while(field <= POLICY) {
+		while(p < end && *p == ' ')
+			p++;
+		if(p >= end || *p == '\n')
+			return false;
+
+		char* next = NULL;
+		switch(field) {
+			case PPID:
+				info->ppid = (pid_t)strtol(p, &next, 10);
+				break;
+			case SESSION:
+				info->session = (pid_t)strtol(p, &next, 10);
+				break;
+			case PRIORITY:
+				info->priority = strtol(p, &next, 10);
+				break;
+			case STARTTIME:
+				info->starttime = strtoul(p, &next, 10);
+				break;
+			case POLICY:
+				info->policy = strtoul(p, &next, 10);
+				break;
+			default:
+				next = (char*)p;
+				while(next < end && *next != ' ' && *next != '\n')
+					next++;
+				break;
+		}
+		if(next == p)
+			return false;
+
+		p = next;
+		field++;
+	}
+
+	return true;
+}
+
+bool ProcessTable::ParseStatus(const char *buf, size_t len, StatusInfo *info, string *errLabel) {
+
+	info->foundUid = false;
+	info->foundCapEff = false;
+
+	const char* end = buf + len;
+	const char* line = buf;
+	while(line < end) {
+		const char* lineEnd = (const char*)memchr(line, '\n', end - line);
+		if(lineEnd == NULL)
+			lineEnd = end;
+
+		char* next = NULL;
+		if(lineEnd - line > 4 && strncmp(line, "Uid:", 4) == 0) {
+			const char* p = line + 4;
+			info->ruid = (uid_t)strtoul(p, &next, 10);
+			if(next != p && next <= lineEnd) {
+				p = next;
+				info->euid = (uid_t)strtoul(p, &next, 10);
+			}
+			if(next == p || next > lineEnd) {
+				*errLabel = "Uid:";
+				return false;
+			}
+			info->foundUid = true;
+
+		} else if(lineEnd - line > 7 && strncmp(line, "CapEff:", 7) == 0) {
+			const char* p = line + 7;
+			info->effCap = (uint64_t)strtoull(p, &next, 16);
+			if(next == p || next > lineEnd) {
+				*errLabel = "CapEff:";
+				return false;
+			}
+			info->foundCapEff = true;
+		}
+
+		line = lineEnd + 1;
+	}
+
+	return true;
+}
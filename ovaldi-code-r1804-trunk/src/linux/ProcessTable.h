@@ -0,0 +1,203 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifndef PROCESSTABLE_H
+#define PROCESSTABLE_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "StdTypedefs.h"
+
+/**
+	This class holds a snapshot of the process table, taken from /proc the first time any 
+	process information is requested during a run. The process and process58 probes and the 
+	environmentvariable58 probe all query the snapshot, so /proc is only swept once per run no 
+	matter how many objects are collected, and every object sees the same set of processes.
+
+	The snapshot keeps /proc open and reads the files of each process relative to it with 
+	openat(). The pids and command lines of all processes are captured up front. The stat, 
+	status, tty and loginuid data is only read for processes that some object actually asks 
+	about, and is then remembered for the rest of the run. Environments are read on demand and 
+	not kept, since they can be large.
+
+	Processes come and go. Any lookup for a process that has terminated since the snapshot was 
+	taken reports PROC_TERMINATED, which callers should treat as the process not existing.
+
+	The snapshot must be cleared when collection completes.
+*/
+class ProcessTable {
+public:
+
+	/** The outcome of reading a piece of process information. */
+	enum ProcStatus {
+		PROC_OK, ///< no error
+		PROC_TERMINATED, ///< the process terminated
+		PROC_ERROR ///< some other error occurred
+	};
+
+	/** The fields of /proc/<pid>/stat that the probes use. */
+	struct StatInfo {
+		pid_t ppid;
+		pid_t session;
+		long priority;
+		unsigned long starttime;
+		unsigned long policy;
+	};
+
+	/** The fields of /proc/<pid>/status that the probes use. */
+	struct StatusInfo {
+		bool foundUid;
+		uid_t ruid;
+		uid_t euid;
+		bool foundCapEff;
+		uint64_t effCap;
+	};
+
+	/** A pid paired with the command line of that process. */
+	typedef std::vector < std::pair < std::string, std::string > > CommandLineVector;
+
+	/** Return the pid and command line of every process in the snapshot, in /proc order. 
+		Arguments in the command line are separated by single spaces and trailing whitespace is 
+		removed. Command lines are limited to MAX_CMDLINE_LEN bytes.
+	*/
+	static const CommandLineVector& GetCommandLines();
+
+	/** Return the pids of every process in the snapshot. */
+	static StringVector GetPids();
+
+	/** Return the command line of the specified process, or NULL if it is not in the snapshot. */
+	static const std::string* GetCommandLine(const std::string &pid);
+
+	/** Append the pids of all processes whose command line is exactly the specified command line. 
+		@return true if at least one process was found.
+	*/
+	static bool FindByCommandLine(const std::string &cmdline, StringVector *pids);
+
+	/** Return the system uptime in seconds and the wall clock time at which the snapshot was taken. 
+		Both are captured together so start and exec times are consistent across objects.
+		@return false if /proc/uptime could not be read, in which case errMsg is set.
+	*/
+	static bool GetUptime(unsigned long *uptime, time_t *snapshotTime, std::string *errMsg);
+
+	/** Get the stat information of the specified process. errMsg is set if PROC_ERROR is returned. */
+	static ProcStatus GetStat(const std::string &pid, StatInfo *info, std::string *errMsg);
+
+	/** Get the status information of the specified process. errMsg is set if PROC_ERROR is returned. */
+	static ProcStatus GetStatus(const std::string &pid, StatusInfo *info, std::string *errMsg);
+
+	/** Get the device that stdin (fd 0) of the specified process is attached to, or "?" if it is 
+		not attached to a device. A process without fd 0 is not an error. 
+	*/
+	static ProcStatus GetTTY(const std::string &pid, std::string *tty, std::string *errMsg);
+
+	/** Get the login uid of the specified process. errMsg is set if PROC_ERROR is returned. */
+	static ProcStatus GetLoginUid(const std::string &pid, uid_t *loginUid, std::string *errMsg);
+
+	/** Read the environment of the specified process into env. Entries without an '=' are ignored. 
+		The environment is not cached. errMsg is set if PROC_ERROR is returned.
+	*/
+	static ProcStatus GetEnvironment(const std::string &pid, std::map<std::string, std::string> *env, std::string *errMsg);
+
+	/** Release the snapshot and close /proc. The next lookup takes a new snapshot. */
+	static void Clear();
+
+	/** The longest command line that is kept for a process. */
+	static const size_t MAX_CMDLINE_LEN = 1024;
+
+private:
+
+	/** The per process data that is read lazily and remembered for the run. */
+	struct ProcessData {
+		ProcessData() : statRead(false), statusRead(false), ttyRead(false), loginUidRead(false) {}
+
+		bool statRead;
+		ProcStatus statResult;
+		StatInfo stat;
+		std::string statErr;
+
+		bool statusRead;
+		ProcStatus statusResult;
+		StatusInfo status;
+		std::string statusErr;
+
+		bool ttyRead;
+		ProcStatus ttyResult;
+		std::string tty;
+		std::string ttyErr;
+
+		bool loginUidRead;
+		ProcStatus loginUidResult;
+		uid_t loginUid;
+		std::string loginUidErr;
+	};
+
+	/** Take the snapshot if it has not been taken yet. 
+		@throws ProbeException if /proc cannot be read.
+	*/
+	static void Capture();
+
+	/** Return the data record for the specified pid, creating it if needed. */
+	static ProcessData* GetData(const std::string &pid);
+
+	/** Read at most maxLen bytes (0 for no limit) of the file at the specified path, relative to 
+		/proc, into the shared read buffer. On success len is set to the number of bytes read and 
+		the buffer is NUL terminated.
+	*/
+	static ProcStatus ReadFile(const std::string &path, size_t maxLen, size_t *len, std::string *errMsg);
+
+	/** Parse the contents of a stat file. */
+	static bool ParseStat(const char *buf, size_t len, StatInfo *info);
+
+	/** Parse the contents of a status file. */
+	static bool ParseStatus(const char *buf, size_t len, StatusInfo *info, std::string *errLabel);
+
+	/** File descriptor of the open /proc directory, or -1 if no snapshot has been taken. */
+	static int procFd;
+
+	static time_t snapshotTime;
+	static unsigned long uptime;
+	static bool uptimeRead;
+	static std::string uptimeErr;
+
+	static CommandLineVector commandLines;
+	static std::multimap<std::string, std::string> pidsByCommandLine;
+	static std::map<std::string, std::string*> commandLineByPid;
+	static std::map<std::string, ProcessData> processData;
+
+	/** Buffer reused for every file read. */
+	static std::vector<char> readBuffer;
+};
+
+#endif
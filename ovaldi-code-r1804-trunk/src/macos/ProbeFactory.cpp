@@ -68,6 +68,8 @@
 #include "AccountInfoProbe.h"
 #include "InetListeningServer510Probe.h"
 #include "PwPolicy59Probe.h"
+#include "AccountTable.h"
+#include "TimedFileOps.h"
 
 #include "ProbeFactory.h"
 
@@ -168,4 +170,10 @@ void ProbeFactory::Shutdown() {
     delete (*iter);  // the probe better set it's instance pointer to NULL inside of its destructor
     _probes.erase( iter++ );
   }
+
+  // the account snapshot is shared by the probes as well
+  AccountTable::Clear();
+
+  // no more file system calls will be made
+  TimedFileOps::Shutdown();
 } 
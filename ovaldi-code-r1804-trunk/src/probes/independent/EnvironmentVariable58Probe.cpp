@@ -31,7 +31,6 @@
 #ifdef LINUX
 #  include <stdlib.h>
 #  include <sys/types.h>
-#  include <dirent.h>
 #  include <unistd.h>
 #  include <cerrno>
 #  include <cstring>
@@ -40,7 +39,7 @@
 #  include <memory>
 
 #  include <Log.h>
-#  include <DirGuard.h>
+#  include <ProcessTable.h>
 #  include <VectorPtrGuard.h>
 #elif defined SUNOS
 #  include <map>
@@ -93,10 +92,6 @@ extern char ** _environ;
 
 using namespace std;
 
-#ifdef LINUX
-#  define PROC_DIR "/proc"
-#endif
-
 
 namespace {
 
@@ -473,85 +468,17 @@ namespace {
 
 #ifdef LINUX
 	StringVector GetAllPids() {
-		StringVector pids;
-		DirGuard procDir(PROC_DIR);
-		dirent *entry;
-
-		errno = 0;
-		while((entry = readdir(procDir)) != NULL) {
-			if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
-				continue;
-
-			// find the names made up of all digits
-			size_t i;
-			for (i=0; i<strlen(entry->d_name) && isdigit(entry->d_name[i]); ++i)
-				;
-
-			if (i < strlen(entry->d_name))
-				continue;
-
-			pids.push_back(entry->d_name);
-		}
-
-		if (errno)
-			throw ProbeException(string("Error while reading " PROC_DIR ": ") + strerror(errno));
-
-		return pids;
+		// the pids come from the process table snapshot so that every object
+		// in the run sees the same set of processes
+		return ProcessTable::GetPids();
 	}
 
 	ProcStatus GetEnvForPid(const string &pid, map<string, string> *env, string *errMsg) {
-		string envFile = Common::BuildFilePath(
-			Common::BuildFilePath(PROC_DIR, pid),
-			"environ");
-
-		// On linux, the format of the environ file is:
-		// <entry>\0<entry>\0 ... <entry>\0
-		// Normally formatted entries look like <name>=<val>.
-
-
-		string name, val;
-		bool inName = true;
-		errno = 0;
-		// binary mode.  I was able to get binary junk into
-		// an env variable value via setenv().  So I will
-		// not assume values are text, and just read raw bytes out.
-		ifstream in(envFile.c_str(), ios::in|ios::binary);
-		while (in) {
-			int c = in.get();
-			if (in.good()) {
-				if (c == '=')
-					inName = false;
-				else if (c) {
-					if (inName) name += (char)c;
-					else val += (char)c;
-				} else {
-					if (inName)
-						// The following actually produces a lot of spam.
-						// There seem to be a lot of /proc/<pid>/environ
-						// files for processes with weird stuff in them which
-						// does not conform to the normal rules for environment
-						// variables.  So I commented it out.
-//						Log::Debug("Found env value for pid "+pid+": "+name+" with no '=' in it!  Ignoring...");
-						;
-					
-					else {
-						(*env)[name] = val;
-//						Log::Debug("found env var for pid "+pid+": "+name+" = "+val);
-					}
-
-					name.clear();
-					val.clear();
-					inName = true;
-				}
-			}
-		}
-
-		if (errno == ENOENT)
+		ProcessTable::ProcStatus status = ProcessTable::GetEnvironment(pid, env, errMsg);
+		if (status == ProcessTable::PROC_TERMINATED)
 			return PROC_TERMINATED;
-		else if (errno) {
-			*errMsg = "Error reading "+envFile+": "+strerror(errno);
+		else if (status == ProcessTable::PROC_ERROR)
 			return PROC_ERROR;
-		}		
 
 		return PROC_OK;
 	}
@@ -46,6 +46,20 @@
 
 using namespace std;
 
+namespace {
+	/** The number of entries to ask for in each page of a one level or subtree search. */
+	const int PAGE_SIZE = 500;
+
+	/** The maximum number of entries a one level or subtree search may return. */
+	const ULONG SEARCH_SIZE_LIMIT = 100000;
+
+	/** The maximum number of entry searches sent before their results are read. */
+	const unsigned int MAX_PENDING_SEARCHES = 64;
+
+	/** The maximum total size of the attribute values kept in cached entries. Subtree searches can return many large, often binary, values that no object asks for. */
+	const unsigned long long MAX_CACHED_VALUE_BYTES = 64 * 1024 * 1024;
+}
+
 //****************************************************************************************//
 //								LDAPProbe Class										  //
 //****************************************************************************************//
@@ -59,13 +73,18 @@ const string LDAPProbe::ATTRIBUTE_TYPES_ATTRIBUTE = "attributetypes";
 const string LDAPProbe::OBJECT_CLASS_ATTRIBUTE = "objectclass";
 
 LDAPProbe::LDAPProbe() {
-	ldap = LDAPProbe::OpenConnection ( LDAPProbe::GetLDAPServerLocation() );
+	searchCount = 0;
+	cachedValueBytes = 0;
+	droppedValueCount = 0;
+	hostname = LDAPProbe::GetLDAPServerLocation();
+	ldap = LDAPProbe::OpenConnection ( hostname );
 	types = NULL;
 	types = LDAPProbe::GetAttributeValueTypes();
 }
 
 LDAPProbe::~LDAPProbe() {
 	instance = NULL;
+	Log::Debug ( "LDAP: " + Common::ToString ( searchCount ) + " searches were sent to the server for " + Common::ToString ( entries.size() ) + " entries. The values of " + Common::ToString ( droppedValueCount ) + " entries were not kept." );
 	LDAPProbe::DeleteAllTypes();
 	LDAPProbe::CloseConnection ( ldap );
 }
@@ -207,12 +226,17 @@ StringSet* LDAPProbe::GetSuffixes ( ObjectEntity* suffixEntity ) {
 		allSuffixes = this->GetAllSuffixes ( );
 	}
 	ItemEntity* tmp = this->CreateItemEntity ( suffixEntity );
+	StringVector candidates;
 	for ( StringSet::iterator it = allSuffixes->begin() ; it != allSuffixes->end() ; it++ ) {
 		tmp->SetValue ( ( *it ) );
 		if ( suffixEntity->Analyze ( tmp ) == OvalEnum::RESULT_TRUE ) {
-			if ( this->SuffixExists ( *it ) ) {
-				suffixes->insert ( ( *it ) );
-			}
+			candidates.push_back ( *it );
+		}
+	}
+	LDAPProbe::FetchEntries ( candidates );
+	for ( StringVector::iterator it = candidates.begin() ; it != candidates.end() ; it++ ) {
+		if ( this->SuffixExists ( *it ) ) {
+			suffixes->insert ( ( *it ) );
 		}
 	}
 	delete allSuffixes;
@@ -255,13 +279,20 @@ StringSet* LDAPProbe::GetRelativeDns ( string suffixStr , ObjectEntity* relative
 		}
 		ItemEntity* tmp = this->CreateItemEntity ( relativeDnEntity );
 		string relativeDistinguishedNameStr = "";
+		StringVector candidates;
+		StringVector candidateDns;
 		for ( StringSet::iterator it = allRelativeDns->begin() ; it != allRelativeDns->end() ; it++ ) {
 			relativeDistinguishedNameStr = LDAPProbe::RemoveDnBase ( suffixStr, *it );
 			tmp->SetValue ( ( relativeDistinguishedNameStr ) );
 			if ( relativeDnEntity->Analyze ( tmp ) == OvalEnum::RESULT_TRUE ) {
-				if ( this->RelativeDnExists ( suffixStr, relativeDistinguishedNameStr ) ) {
-					relativeDns->insert ( relativeDistinguishedNameStr );
-				}
+				candidates.push_back ( relativeDistinguishedNameStr );
+				candidateDns.push_back ( LDAPProbe::BuildDistinguishedName ( suffixStr, relativeDistinguishedNameStr ) );
+			}
+		}
+		LDAPProbe::FetchEntries ( candidateDns );
+		for ( StringVector::iterator it = candidates.begin() ; it != candidates.end() ; it++ ) {
+			if ( this->RelativeDnExists ( suffixStr, *it ) ) {
+				relativeDns->insert ( *it );
 			}
 		}
 		delete allRelativeDns;
@@ -320,13 +351,8 @@ StringSet* LDAPProbe::GetAttributes ( string suffixStr, string relativeDnStr, Ob
 }
 
 bool LDAPProbe::AttributeExists ( string suffixStr, string relativeDnStr, string attributeStr ) {
-	bool exists = false;
-	StringSet* allAttributes = LDAPProbe::GetAllAttributes ( suffixStr, relativeDnStr );
-	if ( allAttributes->find ( attributeStr ) != allAttributes->end() ) {
-		exists = true;
-	}
-	delete allAttributes;
-	return exists;
+	const LdapEntry& entry = LDAPProbe::GetEntry ( suffixStr, relativeDnStr );
+	return entry.attributes.find ( attributeStr ) != entry.attributes.end();
 }
 
 string LDAPProbe::BuildDistinguishedName ( string suffixStr, string relativeDnStr ) {
@@ -396,6 +422,142 @@ void LDAPProbe::CloseConnection ( LDAP* ldap ) {
 	ldap = NULL;
 }
 
+ULONG LDAPProbe::StartSearch ( string distinguishedName, int scope, LDAPControl** serverControls, ULONG sizeLimit, ULONG* messageId, bool reconnect ) {
+	// the subschemasubentry attribute is operational, so it has to be asked for by name
+	char* attributeArray[3];
+	attributeArray[0] = ( char* ) "*";
+	attributeArray[1] = ( char* ) LDAPProbe::SUBSCHEMA_SUBENTRY_ATTRIBUTE.c_str();
+	attributeArray[2] = ( char* ) NULL;
+
+	ULONG retval = 0;
+	searchCount++;
+	if ( ( retval = ldap_search_ext ( ldap, ( char* ) distinguishedName.c_str(), scope, NULL, attributeArray, 0, serverControls, NULL, 0, sizeLimit, messageId ) ) == LDAP_SERVER_DOWN && reconnect ) {
+		Log::Message ( "The connection to the LDAP server was lost. Opening it again. "+LDAPProbe::GetErrorMessage ( retval ) );
+		try {
+			LDAPProbe::CloseConnection ( ldap );
+		} catch ( ProbeException& ) {
+			// the connection is gone either way
+		}
+		ldap = NULL;
+		ldap = LDAPProbe::OpenConnection ( hostname );
+
+		searchCount++;
+		retval = ldap_search_ext ( ldap, ( char* ) distinguishedName.c_str(), scope, NULL, attributeArray, 0, serverControls, NULL, 0, sizeLimit, messageId );
+	}
+	return retval;
+}
+
+const LDAPProbe::LdapEntry& LDAPProbe::GetEntry ( string suffixStr, string relativeDnStr ) {
+	// an entry that could not be read is treated as if it does not exist
+	static const LdapEntry unreadable;
+
+	string distinguishedName = LDAPProbe::BuildDistinguishedName ( suffixStr, relativeDnStr );
+	map < string , LdapEntry >::iterator it = entries.find ( distinguishedName );
+	if ( it == entries.end() ) {
+		LDAPProbe::FetchEntries ( StringVector ( 1, distinguishedName ) );
+		if ( ( it = entries.find ( distinguishedName ) ) == entries.end() ) {
+			return unreadable;
+		}
+	}
+	return it->second;
+}
+
+void LDAPProbe::FetchEntries ( const StringVector& distinguishedNames ) {
+	StringSet requested;
+	StringVector::const_iterator next = distinguishedNames.begin();
+
+	while ( next != distinguishedNames.end() ) {
+		vector < pair < string , ULONG > > pending;
+
+		// send a batch of searches first, so the server can work on them while the results are read
+		for ( ; next != distinguishedNames.end() && pending.size() < MAX_PENDING_SEARCHES ; next++ ) {
+			if ( entries.find ( *next ) != entries.end() || !requested.insert ( *next ).second ) {
+				continue;
+			}
+			ULONG messageId = 0;
+			ULONG retval = 0;
+			if ( ( retval = LDAPProbe::StartSearch ( *next, LDAP_SCOPE_BASE, NULL, 1, &messageId, pending.empty() ) ) != LDAP_SUCCESS ) {
+				Log::Message ( "Error: An error occurred while reading the entry '"+*next+"'. "+LDAPProbe::GetErrorMessage ( retval ) );
+			} else {
+				pending.push_back ( make_pair ( *next, messageId ) );
+			}
+		}
+
+		LDAPProbe::ReadEntries ( pending );
+	}
+}
+
+void LDAPProbe::ReadEntries ( const vector < pair < string , ULONG > >& pending ) {
+	for ( vector < pair < string , ULONG > >::const_iterator it = pending.begin() ; it != pending.end() ; it++ ) {
+		LDAPMessage* result = NULL;
+		ULONG retval = 0;
+		int type = ( int ) ldap_result ( ldap, it->second, LDAP_MSG_ALL, NULL, &result );
+		if ( type != LDAP_RES_SEARCH_RESULT && type != LDAP_RES_SEARCH_ENTRY ) {
+			Log::Message ( "Error: No result was received while reading the entry '"+it->first+"'." );
+		} else if ( ldap_parse_result ( ldap, result, &retval, NULL, NULL, NULL, NULL, 0 ) != LDAP_SUCCESS ) {
+			Log::Message ( "Error: The result could not be read while reading the entry '"+it->first+"'." );
+		} else if ( retval == LDAP_SUCCESS || retval == LDAP_NO_SUCH_OBJECT ) {
+			LdapEntry& ldapEntry = entries[it->first];
+			LDAPMessage* entry = NULL;
+			if ( retval == LDAP_SUCCESS && ( entry = ldap_first_entry ( ldap, result ) ) != NULL ) {
+				LDAPProbe::ReadEntry ( entry, &ldapEntry );
+			}
+		} else {
+			Log::Message ( "Error: An error occurred while reading the entry '"+it->first+"'. "+LDAPProbe::GetErrorMessage ( retval ) );
+		}
+		if ( result != NULL ) {
+			ldap_msgfree ( result );
+			result = NULL;
+		}
+	}
+}
+
+void LDAPProbe::ReadEntry ( LDAPMessage* entry, LdapEntry* ldapEntry ) {
+	BerElement* attrPtr = NULL;
+	char* attribute = NULL;
+	char* distinguishedName = NULL;
+
+	ldapEntry->exists = true;
+	if ( ( distinguishedName = ldap_get_dn ( ldap, entry ) ) != NULL ) {
+		ldapEntry->distinguishedName = distinguishedName;
+		ldap_memfree ( distinguishedName );
+	}
+
+	unsigned long long valueBytes = 0;
+	for ( attribute = ldap_first_attribute ( ldap, entry, &attrPtr ) ; attribute != NULL ; attribute = ldap_next_attribute ( ldap, entry, attrPtr ) ) {
+		string attributeStr = attribute;
+		string nameStr = Common::ToLower ( attributeStr );
+		if ( nameStr.compare ( LDAPProbe::SUBSCHEMA_SUBENTRY_ATTRIBUTE ) != 0 ) {
+			ldapEntry->attributes.insert ( attributeStr );
+		}
+
+		StringVector& valuesVector = ldapEntry->values[nameStr];
+		berval** values = NULL;
+		if ( ( values = ldap_get_values_len ( ldap, entry, attribute ) ) != NULL ) {
+			unsigned long count = ldap_count_values_len ( values );
+			for ( unsigned long i = 0; i < count; i++ ) {
+				valuesVector.push_back ( string ( values[i]->bv_val, values[i]->bv_len ) );
+				valueBytes += values[i]->bv_len;
+			}
+			ldap_value_free_len ( values );
+		}
+		ldap_memfree ( attribute );
+	}
+	if ( attrPtr != NULL ) {
+		ber_free ( attrPtr, 0 );
+		attrPtr = NULL;
+	}
+
+	// once the cache is full only the attribute names are kept, and values are read when they are asked for
+	if ( cachedValueBytes + valueBytes > MAX_CACHED_VALUE_BYTES ) {
+		ldapEntry->values.clear();
+		ldapEntry->valuesCached = false;
+		droppedValueCount++;
+	} else {
+		cachedValueBytes += valueBytes;
+	}
+}
+
 string LDAPProbe::RemoveDnBase ( string suffixStr, string distinguishedNameStr ) {
 	size_t pos = distinguishedNameStr.rfind ( suffixStr );
 	if ( pos > 0 ) {
@@ -407,7 +569,7 @@ string LDAPProbe::RemoveDnBase ( string suffixStr, string distinguishedNameStr )
 
 string LDAPProbe::GetObjectClass ( string suffixStr, string relativeDnStr ) {
 	string objectClassStr = "";
-	StringVector* objectClassVector = LDAPProbe::GetValues ( suffixStr, relativeDnStr, LDAPProbe::OBJECT_CLASS_ATTRIBUTE );
+	StringVector* objectClassVector = LDAPProbe::GetEntryValues ( suffixStr, relativeDnStr, LDAPProbe::OBJECT_CLASS_ATTRIBUTE );
 	for ( StringVector::iterator it = objectClassVector->begin(); it != objectClassVector->end() ; it++ ) {
 		objectClassStr.append ( *it );
 		objectClassStr.append ( ";" );
@@ -476,81 +638,154 @@ string LDAPProbe::GetLDAPServerLocation() {
 }
 
 StringSet* LDAPProbe::GetAllAttributes ( string suffixStr, string relativeDnStr ) {
-	ULONG retval = 0;
-	StringSet* attributes = new StringSet();
-	LDAPMessage* result = NULL;
-	string distinguishedName = LDAPProbe::BuildDistinguishedName ( suffixStr, relativeDnStr );
-	if ( ( ( retval = ldap_search_ext_s ( ldap, ( char* ) distinguishedName.c_str(), LDAP_SCOPE_BASE, NULL, NULL, 1, NULL, NULL, NULL, 1, &result ) ) != LDAP_SUCCESS ) || ( result == NULL ) ) {
-		Log::Message ( "Error: An error occurred while searching for all of the attributes for the distinguished name '"+distinguishedName+"'. "+LDAPProbe::GetErrorMessage ( retval ) );
-	} else {
-		LDAPMessage* entry = NULL;
-		BerElement* attrPtr = NULL;
-		char* attribute;
-		if ( ( entry = ldap_first_entry ( ldap, result ) ) != NULL ) {
-			do {
-				if ( ( attribute = ldap_first_attribute ( ldap, entry, &attrPtr ) ) != NULL ) {
-					do {
-						attributes->insert ( attribute );
-					} while ( ( attribute = ldap_next_attribute ( ldap, entry, attrPtr ) ) != NULL );
-				}
-				ber_free ( attrPtr,0 );
-				attrPtr = NULL;
-				ldap_memfree ( attribute );
-				attribute = NULL;
-			} while ( ( entry = ldap_next_entry ( ldap, entry ) ) != NULL );
-		}
-	}
-	if ( result != NULL ) {
-		ldap_msgfree ( result );
-		result = NULL;
-	}
-	return attributes;
+	return new StringSet ( LDAPProbe::GetEntry ( suffixStr, relativeDnStr ).attributes );
 }
 
 StringSet* LDAPProbe::GetAllDistinguishedNames ( string suffixStr, string relativeDnStr, int scopeBehavior ) {
 	StringSet* distinguishedNames = new StringSet();
-	ULONG retval = 0;
-	LDAPMessage* result = NULL;
-	LDAPMessage* entry = NULL;
 	string distinguishedName = LDAPProbe::BuildDistinguishedName ( suffixStr, relativeDnStr );
-	if ( ( ( retval=ldap_search_ext_s ( ldap, ( char* ) distinguishedName.c_str(), scopeBehavior, NULL, NULL, 0, NULL, NULL, NULL, 100000, &result ) ) != LDAP_SUCCESS ) || ( result == NULL ) ) {
-		Log::Message ( "Error: An error occurred while searching for all of the distinguished names under the base distinguished name '"+distinguishedName+"'. "+LDAPProbe::GetErrorMessage ( retval ) );
+
+	if ( scopeBehavior == LDAP_SCOPE_BASE ) {
+		const LdapEntry& entry = LDAPProbe::GetEntry ( suffixStr, relativeDnStr );
+		if ( entry.exists ) {
+			distinguishedNames->insert ( entry.distinguishedName );
+		}
+		return distinguishedNames;
 	}
-	if ( ( entry = ldap_first_entry ( ldap, result ) ) != NULL ) {
-		do {
-			distinguishedNames->insert ( ldap_get_dn ( ldap, entry ) );
-		} while ( ( entry = ldap_next_entry ( ldap, entry ) ) != NULL );
+
+	string searchKey = Common::ToString ( scopeBehavior ) + ":" + distinguishedName;
+	map < string , StringSet >::iterator cached = searches.find ( searchKey );
+	if ( cached != searches.end() ) {
+		distinguishedNames->insert ( cached->second.begin(), cached->second.end() );
+		return distinguishedNames;
+	}
+
+	// Read the entries a page at a time, keeping each one as it arrives. A server that does not
+	// support paging ignores the control and returns all of the entries at once.
+	#ifdef WIN32
+	berval* cookie = NULL;
+	#endif
+	#if defined (LINUX) || defined (DARWIN)
+	berval cookie;
+	cookie.bv_val = NULL;
+	cookie.bv_len = 0;
+	#endif
+
+	bool complete = true;
+	bool morePages = true;
+	while ( morePages ) {
+		morePages = false;
+
+		ULONG retval = 0;
+		LDAPControl* pageControl = NULL;
+		LDAPControl* serverControls[2];
+		#ifdef WIN32
+		retval = ldap_create_page_control ( ldap, PAGE_SIZE, cookie, 0, &pageControl );
+		#endif
+		#if defined (LINUX) || defined (DARWIN)
+		retval = ldap_create_page_control ( ldap, PAGE_SIZE, ( cookie.bv_len > 0 ) ? &cookie : NULL, 0, &pageControl );
+		#endif
+		serverControls[0] = ( retval == LDAP_SUCCESS ) ? pageControl : NULL;
+		serverControls[1] = NULL;
+
+		ULONG messageId = 0;
+		retval = LDAPProbe::StartSearch ( distinguishedName, scopeBehavior, serverControls, SEARCH_SIZE_LIMIT, &messageId, true );
+		if ( serverControls[0] != NULL ) {
+			ldap_control_free ( pageControl );
+			pageControl = NULL;
+		}
+		if ( retval != LDAP_SUCCESS ) {
+			Log::Message ( "Error: An error occurred while searching for all of the distinguished names under the base distinguished name '"+distinguishedName+"'. "+LDAPProbe::GetErrorMessage ( retval ) );
+			complete = false;
+			break;
+		}
+
+		LDAPMessage* message = NULL;
+		int type = 0;
+		while ( ( type = ( int ) ldap_result ( ldap, messageId, LDAP_MSG_ONE, NULL, &message ) ) == LDAP_RES_SEARCH_ENTRY || type == LDAP_RES_SEARCH_REFERENCE ) {
+			char* entryDn = NULL;
+			if ( type == LDAP_RES_SEARCH_ENTRY && ( entryDn = ldap_get_dn ( ldap, message ) ) != NULL ) {
+				string entryDnStr = entryDn;
+				ldap_memfree ( entryDn );
+				distinguishedNames->insert ( entryDnStr );
+				// an entry that is already cached keeps its values, so they are not counted twice
+				if ( entries.find ( entryDnStr ) == entries.end() ) {
+					LDAPProbe::ReadEntry ( message, &entries[entryDnStr] );
+				}
+			}
+			ldap_msgfree ( message );
+			message = NULL;
+		}
+
+		LDAPControl** returnedControls = NULL;
+		if ( type != LDAP_RES_SEARCH_RESULT ) {
+			Log::Message ( "Error: No result was received while searching for all of the distinguished names under the base distinguished name '"+distinguishedName+"'." );
+			complete = false;
+		} else if ( ldap_parse_result ( ldap, message, &retval, NULL, NULL, NULL, &returnedControls, 0 ) != LDAP_SUCCESS ) {
+			Log::Message ( "Error: The result could not be read while searching for all of the distinguished names under the base distinguished name '"+distinguishedName+"'." );
+			complete = false;
+		} else if ( retval != LDAP_SUCCESS ) {
+			Log::Message ( "Error: An error occurred while searching for all of the distinguished names under the base distinguished name '"+distinguishedName+"'. "+LDAPProbe::GetErrorMessage ( retval ) );
+			complete = false;
+		} else if ( returnedControls != NULL ) {
+			#ifdef WIN32
+			ULONG count = 0;
+			if ( cookie != NULL ) {
+				ber_bvfree ( cookie );
+				cookie = NULL;
+			}
+			if ( ldap_parse_page_control ( ldap, returnedControls, &count, &cookie ) == LDAP_SUCCESS && cookie != NULL && cookie->bv_len > 0 ) {
+				morePages = true;
+			}
+			#endif
+			#if defined (LINUX) || defined (DARWIN)
+			ber_int_t count = 0;
+			LDAPControl* pageResponse = ldap_control_find ( LDAP_CONTROL_PAGEDRESULTS, returnedControls, NULL );
+			if ( cookie.bv_val != NULL ) {
+				ber_memfree ( cookie.bv_val );
+				cookie.bv_val = NULL;
+				cookie.bv_len = 0;
+			}
+			if ( pageResponse != NULL && ldap_parse_pageresponse_control ( ldap, pageResponse, &count, &cookie ) == LDAP_SUCCESS && cookie.bv_len > 0 ) {
+				morePages = true;
+			}
+			#endif
+		}
+		if ( returnedControls != NULL ) {
+			ldap_controls_free ( returnedControls );
+			returnedControls = NULL;
+		}
+		if ( message != NULL ) {
+			ldap_msgfree ( message );
+			message = NULL;
+		}
+	}
+
+	#ifdef WIN32
+	if ( cookie != NULL ) {
+		ber_bvfree ( cookie );
+	}
+	#endif
+	#if defined (LINUX) || defined (DARWIN)
+	if ( cookie.bv_val != NULL ) {
+		ber_memfree ( cookie.bv_val );
 	}
-	if ( result != NULL ) {
-		ldap_msgfree ( result );
-		result = NULL;
+	#endif
+
+	// an incomplete search is tried again the next time it is needed
+	if ( complete ) {
+		searches[searchKey] = *distinguishedNames;
 	}
 	return distinguishedNames;
 }
 
 bool LDAPProbe::ObjectExists ( string suffixStr, string relativeDnStr ) {
-	bool exists = false;
-	LDAPMessage* result = NULL;
-	LDAPMessage* entry = NULL;
-	unsigned long retval = 0;
-	string distinguishedName = LDAPProbe::BuildDistinguishedName ( suffixStr, relativeDnStr );
-	if ( ( ( retval=ldap_search_ext_s ( ldap, ( char* ) distinguishedName.c_str(), LDAP_SCOPE_BASE, NULL, NULL, 0, NULL, NULL, NULL, 1, &result ) ) != LDAP_SUCCESS ) || ( result == NULL ) ) {
-		Log::Message ( "Error: An error occurred while determining if the entry '"+distinguishedName+"'. "+LDAPProbe::GetErrorMessage ( retval ) );
-	} else {
-		if ( ( entry = ldap_first_entry ( ldap, result ) ) != NULL ) {
-			exists = true;
-		}
-	}
-	if ( result != NULL ) {
-		ldap_msgfree ( result );
-		result = NULL;
-	}
-	return exists;
+	return LDAPProbe::GetEntry ( suffixStr, relativeDnStr ).exists;
 }
 
 void LDAPProbe::GetLdapItem ( string suffixStr, string relativeDnStr, string attributeStr, Item* item ) {
 	string type = "";
-	StringVector* schemas = LDAPProbe::GetValues ( suffixStr, relativeDnStr, LDAPProbe::SUBSCHEMA_SUBENTRY_ATTRIBUTE );
+	StringVector* schemas = LDAPProbe::GetEntryValues ( suffixStr, relativeDnStr, LDAPProbe::SUBSCHEMA_SUBENTRY_ATTRIBUTE );
 	for ( StringVector::iterator schema = schemas->begin() ; schema != schemas->end() ; schema++ ) {
 		TypeMapMap::iterator itmm;
 		if ( ( itmm = types->find ( *schema ) ) != types->end() ) {
@@ -565,7 +800,7 @@ void LDAPProbe::GetLdapItem ( string suffixStr, string relativeDnStr, string att
 	if ( type.compare ( "" ) != 0 ) {
 		bool isBinary = (type.compare("LDAPTYPE_BINARY")==0)?true:false;
 		item->AppendElement ( new ItemEntity ( "ldaptype", type, OvalEnum::DATATYPE_STRING, OvalEnum::STATUS_EXISTS ) );
-		StringVector* values = LDAPProbe::GetValues ( suffixStr, relativeDnStr, attributeStr, isBinary);
+		StringVector* values = LDAPProbe::GetEntryValues ( suffixStr, relativeDnStr, attributeStr, isBinary);
 		if ( values->empty() ) {
 			item->AppendElement ( new ItemEntity ( "value", "", OvalEnum::DATATYPE_STRING, OvalEnum::STATUS_DOES_NOT_EXIST ) );
 		} else {
@@ -668,6 +903,7 @@ StringVector* LDAPProbe::GetValues ( string suffixStr, string relativeDnStr, str
 	attributeArray[0] = ( char* ) attributeStr.c_str();
 	attributeArray[1] = ( char* ) NULL;
 	ULONG retval = 0;
+	searchCount++;
 	if ( ( ( retval = ldap_search_ext_s ( ldap, ( char* ) distinguishedName.c_str(), LDAP_SCOPE_BASE, NULL, attributeArray, 0, NULL, NULL, NULL, 1, &result ) ) != LDAP_SUCCESS ) || ( result == NULL ) ) {
 		Log::Message ( "Error: An error occurred while retrieving the values(s) for the attribute '"+attributeStr+"' of the entry '"+distinguishedName+"'. "+LDAPProbe::GetErrorMessage ( retval ) );
 	}
@@ -704,6 +940,27 @@ StringVector* LDAPProbe::GetValues ( string suffixStr, string relativeDnStr, str
 	return valuesVector;
 }
 
+StringVector* LDAPProbe::GetEntryValues ( string suffixStr, string relativeDnStr, string attributeStr, bool type ) {
+	const LdapEntry& entry = LDAPProbe::GetEntry ( suffixStr, relativeDnStr );
+	if ( !entry.valuesCached ) {
+		return LDAPProbe::GetValues ( suffixStr, relativeDnStr, attributeStr, type );
+	}
+
+	StringVector* valuesVector = new StringVector();
+	map < string , StringVector >::const_iterator values = entry.values.find ( Common::ToLower ( attributeStr ) );
+	if ( values != entry.values.end() ) {
+		for ( StringVector::const_iterator value = values->second.begin() ; value != values->second.end() ; value++ ) {
+			if ( type ) {
+				valuesVector->push_back ( this->ConvertToBinary ( ( char* ) value->data(), value->length() ) );
+			} else {
+				// string values end at the first null character, as they did when read straight from the server
+				valuesVector->push_back ( value->c_str() );
+			}
+		}
+	}
+	return valuesVector;
+}
+
 string LDAPProbe::ConvertToBinary(char* data, unsigned long length){
 	ostringstream oss;
 	oss << hex << setfill('0');
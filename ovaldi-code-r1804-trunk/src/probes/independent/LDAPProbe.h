@@ -39,11 +39,23 @@
 typedef int ULONG;
 #endif
 
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "AbsProbe.h"
 
 /**
 	This class is responsible for collecting ldap information for ldap_objects.
 	This class should be platform independant.
+
+	Every entry the probe looks at is read with a single search for all of its attributes and kept 
+	for the rest of the run, up to a limit on the total size of the cached values, so checking whether an entry or attribute exists, reading its object 
+	class and reading attribute values do not each go back to the server. Base searches for 
+	several entries are sent together before any reply is read, and subtree and one level searches 
+	are read a page at a time as the results arrive. The connection is bound once and reused for 
+	all objects; it is opened again if the server drops it.
 */
 
 /** A map for storing attributes and their corresponding datatypes. */
@@ -67,6 +79,26 @@ class LDAPProbe : public AbsProbe {
 
 	private:
 
+		/** An entry read from the LDAP server. */
+		struct LdapEntry {
+			/** A boolean value indicating whether or not the entry exists. */
+			bool exists;
+
+			/** The distinguished name of the entry as returned by the server. */
+			std::string distinguishedName;
+
+			/** The names of the user attributes of the entry as returned by the server. */
+			StringSet attributes;
+
+			/** The raw values of each attribute, including the subschemasubentry attribute, by lower case attribute name. */
+			std::map < std::string , StringVector > values;
+
+			/** A boolean value indicating whether or not the values were kept. They are dropped once the values of earlier entries fill the cache. */
+			bool valuesCached;
+
+			LdapEntry() : exists ( false ), valuesCached ( true ) {}
+		};
+
 		/** LDAPProbe constructor */
 		LDAPProbe();
 
@@ -85,6 +117,43 @@ class LDAPProbe : public AbsProbe {
 		 */
 		void CloseConnection ( LDAP* ldap );
 
+		/** Start an asynchronous search for all of the user attributes and the subschemasubentry attribute of the matching entries.
+		 *  @param distinguishedName A string that contains the base distinguished name of the search.
+		 *  @param scope A integer value that specifies the scope of the search.
+		 *  @param serverControls The server controls to send with the search, or NULL.
+		 *  @param sizeLimit The maximum number of entries to return.
+		 *  @param messageId The message id of the search.
+		 *  @param reconnect A boolean value indicating whether or not the connection may be opened again, and the search retried once, if the server is down. This must be false while other searches are outstanding.
+		 *  @return The LDAP error code of starting the search.
+		 */
+		ULONG StartSearch ( std::string distinguishedName, int scope, LDAPControl** serverControls, ULONG sizeLimit, ULONG* messageId, bool reconnect );
+
+		/** Retrieve the cached entry with the specified suffix and relative distinguished name, reading it from the server if it has not been read yet.
+		 *  @param suffixStr A string that contains the suffix of the LDAP item.
+		 *  @param relativeDnStr A string that contains the relative distinguished name of the LDAP item.
+		 *  @return The LdapEntry for the specified suffix and relative distinguished name.
+		 */
+		const LdapEntry& GetEntry ( std::string suffixStr, std::string relativeDnStr );
+
+		/** Read all of the specified entries that have not been read yet. The searches are sent in batches, and the results of a batch are read once all of its searches are sent.
+		 *  @param distinguishedNames A StringVector that contains the distinguished names of the entries.
+		 *  @return Void.
+		 */
+		void FetchEntries ( const StringVector& distinguishedNames );
+
+		/** Read the results of entry searches that have been sent, and store the entries that were found.
+		 *  @param pending The distinguished name and message id of each search.
+		 *  @return Void.
+		 */
+		void ReadEntries ( const std::vector < std::pair < std::string , ULONG > >& pending );
+
+		/** Store the attributes and values of a search result entry.
+		 *  @param entry The LDAPMessage that contains the search result entry.
+		 *  @param ldapEntry The LdapEntry to fill in.
+		 *  @return Void.
+		 */
+		void ReadEntry ( LDAPMessage* entry, LdapEntry* ldapEntry );
+
 		/** Get the set of all suffixes on the system that match the object.
 		 *  @param suffixEntity A ObjectEntity that represents the suffix entity in an Object as defined in the OVAL Definition Schema.
 		 *  @return A StringSet containing all of the suffixes specified in the ObjectEntity.
@@ -209,6 +278,15 @@ class LDAPProbe : public AbsProbe {
 		 */
 		StringVector* GetValues ( std::string suffixStr, std::string relativeDnStr, std::string attributeStr, bool type = 0 );
 
+		/** Retrieve all of the values for the specified suffix, relative distinguished name, and attribute from the cached entry, or from the server if the entry's values were not kept.
+		 *  @param suffixStr A string that contains the suffix of the LDAP item.
+		 *  @param relativeDnStr A string that contains the relative distinguished name of the LDAP item.
+		 *  @param attributeStr A string that contains the attribute of the LDAP item.
+		 *  @param type A boolean value indicating whether or not the values are binary.
+		 * @return A StringVector containg all of the values for the specified suffix, relative distinguished name, and attribute.
+		 */
+		StringVector* GetEntryValues ( std::string suffixStr, std::string relativeDnStr, std::string attributeStr, bool type = false );
+
 		/** Converts a sequence of characters that represents binary data into a string of hex-encoded data.  Please see the binary datatype in DatatypeEnumeration in the oval-common-schema for more information.
 		 *	@param data The binary data represented as a sequence of characters.
 		 *	@param length The length of the data.
@@ -289,6 +367,24 @@ class LDAPProbe : public AbsProbe {
 		/** A LDAP structure for accessing the LDAP server. */
 		LDAP* ldap;
 
+		/** The location of the LDAP server. */
+		std::string hostname;
+
+		/** The entries read so far, by distinguished name. */
+		std::map < std::string , LdapEntry > entries;
+
+		/** The distinguished names found by one level and subtree searches, by scope and base distinguished name. */
+		std::map < std::string , StringSet > searches;
+
+		/** The number of searches sent to the LDAP server. */
+		unsigned long searchCount;
+
+		/** The total size in bytes of the attribute values kept in the cached entries. */
+		unsigned long long cachedValueBytes;
+
+		/** The number of cached entries whose values were dropped because the cache was full. */
+		unsigned long droppedValueCount;
+
 };
 
 #endif
@@ -28,6 +28,9 @@
 //
 //****************************************************************************************//
 
+#include <cctype>
+#include <fstream>
+
 #include "Log.h"
 #include "FileFinder.h"
 #include "ObjectEntity.h"
@@ -50,12 +53,24 @@
 
 using namespace std;
 
+namespace {
+	/** Bytes of file contents and matches to keep for later objects. */
+	const unsigned long long CACHE_BUDGET = 32 * 1024 * 1024;
+
+	string ToLower(const string &str) {
+		string lower = str;
+		for(string::iterator iterator = lower.begin(); iterator != lower.end(); iterator++)
+			*iterator = (char)tolower((unsigned char)*iterator);
+		return lower;
+	}
+}
+
 //****************************************************************************************//
 //								TextFileContent54Probe Class								  //	
 //****************************************************************************************//
 TextFileContent54Probe* TextFileContent54Probe::instance = NULL;
 
-TextFileContent54Probe::TextFileContent54Probe() {
+TextFileContent54Probe::TextFileContent54Probe() : cachedSize(0) {
 
 }
 
@@ -216,6 +231,37 @@ void TextFileContent54Probe::GetItems(string path, string fileName,
 	// construct the file path
 	string filePath = Common::BuildFilePath(path, fileName);
 
+	CachedFile& file = this->GetFile(filePath);
+	try {
+		this->GetMatches(path, fileName, file, patternEntity,
+			instanceEntity, matchOptions, fileFinder, collectedItems);
+	} catch(...) {
+		this->Trim();
+		throw;
+	}
+	this->Trim();
+}
+
+TextFileContent54Probe::CachedFile& TextFileContent54Probe::GetFile(const string &filePath) {
+
+	string key = "";
+	unsigned long long size = 0;
+	bool identified = Common::GetFileKey(filePath, &key, &size);
+
+	map<string, CachedFile>::iterator cached = this->files.find(filePath);
+	if(cached != this->files.end()) {
+		if(identified && cached->second.key == key) {
+			// move it to the front of the lru list
+			this->lru.splice(this->lru.begin(), this->lru, cached->second.lruPosition);
+			return cached->second;
+		}
+
+		// the file changed since it was read
+		this->cachedSize -= cached->second.size;
+		this->lru.erase(cached->second.lruPosition);
+		this->files.erase(cached);
+	}
+
 	// read the file into memory
 	string fileContents;
 	char buf[100];
@@ -233,24 +279,94 @@ void TextFileContent54Probe::GetItems(string path, string fileName,
 			fileContents.append(buf, static_cast<size_t>(infile.gcount()));
 
 		infile.close();
-
-		this->GetMatches(path, fileName, fileContents, patternEntity,
-			instanceEntity, matchOptions, fileFinder, collectedItems);
 	}
 	else
-		throw ProbeException(string("Couldn't open file: ")+Common::BuildFilePath(path, fileName));
+		throw ProbeException(string("Couldn't open file: ")+filePath);
+
+	CachedFile& file = this->files[filePath];
+	file.key = identified ? key : "";
+	file.contents.swap(fileContents);
+	file.size = file.contents.size();
+	file.lruPosition = this->lru.insert(this->lru.begin(), filePath);
+	this->cachedSize += file.size;
+
+	return file;
+}
+
+const vector<StringVector>& TextFileContent54Probe::GetAllMatches(CachedFile &file, const string &pattern, int matchOptions) {
+
+	pair<string, int> matchKey(pattern, matchOptions);
+	map<pair<string, int>, vector<StringVector> >::iterator cached = file.matches.find(matchKey);
+	if(cached != file.matches.end())
+		return cached->second;
+
+	// no need to run the pattern if the text every match needs isn't there
+	string literal = REGEX::GetRequiredLiteral(pattern);
+	bool possible = true;
+	if(!literal.empty()) {
+		if(matchOptions & REGEX::IGNORE_CASE) {
+			if(file.lowerContents.empty() && !file.contents.empty()) {
+				file.lowerContents = ToLower(file.contents);
+				file.size += file.lowerContents.size();
+				this->cachedSize += file.lowerContents.size();
+			}
+			possible = file.lowerContents.find(ToLower(literal)) != string::npos;
+		} else {
+			possible = file.contents.find(literal) != string::npos;
+		}
+	}
+
+	// a pattern that fails to compile throws before anything is remembered for it
+	vector<StringVector> matches;
+	if(possible) {
+		this->re.GetAllMatchingSubstrings(pattern, file.contents, matches, matchOptions);
+
+		unsigned long long matchesSize = pattern.size();
+		for(vector<StringVector>::iterator match = matches.begin(); match != matches.end(); match++) {
+			for(StringVector::iterator subMatch = match->begin(); subMatch != match->end(); subMatch++)
+				matchesSize += subMatch->size();
+		}
+		file.size += matchesSize;
+		this->cachedSize += matchesSize;
+	}
+
+	vector<StringVector>& cachedMatches = file.matches[matchKey];
+	cachedMatches.swap(matches);
+	return cachedMatches;
+}
+
+void TextFileContent54Probe::Trim() {
+
+	// files that could not be identified can't be checked for changes, so they never stay
+	list<string>::iterator iterator = this->lru.begin();
+	while(iterator != this->lru.end()) {
+		map<string, CachedFile>::iterator cached = this->files.find(*iterator);
+		if(cached->second.key.empty()) {
+			this->cachedSize -= cached->second.size;
+			iterator = this->lru.erase(iterator);
+			this->files.erase(cached);
+		} else {
+			iterator++;
+		}
+	}
+
+	while(!this->lru.empty() && this->cachedSize > CACHE_BUDGET) {
+		map<string, CachedFile>::iterator cached = this->files.find(this->lru.back());
+		this->cachedSize -= cached->second.size;
+		this->lru.pop_back();
+		this->files.erase(cached);
+	}
 }
 
 void TextFileContent54Probe::GetMatches(const string& path,
 										const string& fileName,
-										const string& fileContents,
+										CachedFile &file,
 										ObjectEntity *patternEntity,
 										ObjectEntity *instanceEntity,
 										int matchOptions,
 										FileFinder &fileFinder,
 										ItemVector *collectedItems) {
 
-	vector<StringVector> matches;
 	StringVector patterns;
 	int instance;
 
@@ -265,10 +381,9 @@ void TextFileContent54Probe::GetMatches(const string& path,
 		++patternIter) {
 
 		instance = 0;
-		matches.clear();
-		this->re.GetAllMatchingSubstrings(*patternIter, fileContents, matches, matchOptions);
+		const vector<StringVector>& matches = this->GetAllMatches(file, *patternIter, matchOptions);
 
-		for (vector<StringVector>::iterator matchIter = matches.begin();
+		for (vector<StringVector>::const_iterator matchIter = matches.begin();
 			matchIter != matches.end();
 			++matchIter) {
 
@@ -298,7 +413,7 @@ void TextFileContent54Probe::GetMatches(const string& path,
 			item->AppendElement(instanceItemEntity);
 
 			// first element is the overall match... subsequent elements are the captures
-			StringVector::iterator subMatchIter = matchIter->begin();
+			StringVector::const_iterator subMatchIter = matchIter->begin();
 			item->AppendElement(new ItemEntity("text", *subMatchIter));
 			++subMatchIter;
 
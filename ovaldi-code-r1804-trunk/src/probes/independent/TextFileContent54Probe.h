@@ -31,6 +31,12 @@
 #ifndef TEXTFILECONTENT54PROBE_H
 #define TEXTFILECONTENT54PROBE_H
 
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "FileFinder.h"
 #include "AbsProbe.h"
 
@@ -38,6 +44,11 @@
 /**
 	This class is responsible for collecting data for the ind-sc:textfilecontent_item defined OVAL System Characteristics Schema.
 	This class should be platform independent.
+
+	Benchmarks check the same few files with many objects, so the contents of the files read
+	and the matches of each pattern run against them are kept for later objects, until the file
+	changes or the cache runs out of room. A pattern is only run if the file contains the literal 
+	text every match of the pattern has to contain.
 */
 class TextFileContent54Probe : public AbsProbe {
 
@@ -69,13 +80,44 @@ private:
 				FileFinder &fileFinder,
 				ItemVector* collectedItems);
 
+	/** A file read for an earlier object and the matches of the patterns already run against it. */
+	struct CachedFile {
+		/** The key from Common::GetFileKey(). Empty if the file could not be identified. */
+		std::string key;
+		std::string contents;
+		/** The contents in lower case, made the first time a case insensitive pattern needs it. */
+		std::string lowerContents;
+		/** The matches of each pattern, by pattern and match options. */
+		std::map<std::pair<std::string, int>, std::vector<StringVector> > matches;
+		/** The memory the entry takes, roughly. */
+		unsigned long long size;
+		std::list<std::string>::iterator lruPosition;
+	};
+
+	/**
+	 * Return the cached contents of the file, reading the file if it is not
+	 * cached or has changed since it was read.
+	 * @throws ProbeException if the file can not be opened.
+	 */
+	CachedFile& GetFile(const std::string &filePath);
+
+	/**
+	 * Return all matches of the pattern in the file. The pattern is only run
+	 * if it was not run against the file before and the file contains its 
+	 * required literal.
+	 */
+	const std::vector<StringVector>& GetAllMatches(CachedFile &file, const std::string &pattern, int matchOptions);
+
+	/** Drop the least recently used files until the cache fits in its budget. Files that could not be identified are always dropped. */
+	void Trim();
+
 	/**
 	 * Gets all matches of the given pattern(s) from the given file contents,
 	 * and appends corresponding items onto the given vector.
 	 */
 	void GetMatches(const std::string& path,
 					const std::string& fileName,
-					const std::string& fileContents,
+					CachedFile &file,
 					ObjectEntity *patternEntity,
 					ObjectEntity *instanceEntity,
 					int matchOptions,
@@ -89,6 +131,12 @@ private:
 	int Behaviors2MatchOptions(BehaviorVector *behaviors);
 
 	REGEX re;
+
+	/** The cached files by path. */
+	std::map<std::string, CachedFile> files;
+	/** Paths of the cached files, most recently used first. */
+	std::list<std::string> lru;
+	unsigned long long cachedSize;
 };
 
 #endif
@@ -38,13 +38,18 @@
 #include <xalanc/PlatformSupport/XSLException.hpp>
 #include <xalanc/DOMSupport/XalanDocumentPrefixResolver.hpp>
 #include <xalanc/XPath/XObject.hpp>
+#include <xalanc/XPath/XPath.hpp>
 #include <xalanc/XPath/NodeRefList.hpp>
 #include <xalanc/XPath/XPathEvaluator.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeDOMSupport.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeInit.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeParserLiaison.hpp>
 
+#include <list>
+#include <map>
+
 #ifdef WIN32
+#  include <Windows.h>
 #  include <FsRedirectionGuard.h>
 #  include <PrivilegeGuard.h>
 // macro this so it can disappear on non-windows OSs.
@@ -98,15 +103,95 @@ namespace {
 			virtual const XMLCh *getContentType() const;
 		};
 	};
+
+	/**
+	 * Parsed documents take several times the space of the file they came
+	 * from.  This is the factor used to estimate how much of the cache
+	 * budget a document uses.
+	 */
+	const unsigned long long DOCUMENT_SIZE_FACTOR = 4;
+
+	/**
+	 * Returns true if the xpath uses a namespace prefix.  Prefixes are resolved
+	 * against the document when the xpath is compiled, so such xpaths can not
+	 * be shared between documents.
+	 */
+	bool UsesNamespacePrefix(const string &xpath);
 }
 
+class XmlFileContentProbe::XalanContext {
+public:
+
+	/** Initialize Xalan and set up the parser. */
+	XalanContext();
+
+	/** Release all documents and compiled xpaths and terminate Xalan. */
+	~XalanContext();
+
+	/** 
+		Return the parsed document for the specified file, parsing it if it is not cached or has
+		changed since it was parsed.
+		@throws ProbeException if the file can not be parsed.
+	*/
+	XalanDocument* GetDocument(const string &filePath);
+
+	/** Return the prefix resolver for a document returned by GetDocument(). */
+	const PrefixResolver& GetPrefixResolver(XalanDocument* document);
+
+	/** Return the compiled form of the xpath for evaluation against a document returned by GetDocument(). */
+	const XPath& GetXPath(const string &xpath, XalanDocument* document);
+
+	/** Evict the least recently used documents until the cache fits in its budget. */
+	void Trim();
+
+	XalanSourceTreeDOMSupport& GetDOMSupport() {
+		return *this->domSupport;
+	}
+
+	XPathEvaluator& GetEvaluator() {
+		return *this->evaluator;
+	}
+
+private:
+
+	struct CachedDocument {
+		XalanDocument* document;
+		XalanDocumentPrefixResolver* prefixResolver;
+		/** xpaths that use namespace prefixes, compiled against this document. */
+		map<string, const XPath*> prefixedXPaths;
+		string filePath;
+		unsigned long long size;
+		list<string>::iterator lruPosition;
+	};
+
+	/** Remove the document with the specified key from the cache and destroy it. */
+	void Evict(string key);
+
+	XalanSourceTreeInit* sourceTreeInit;
+	XalanSourceTreeDOMSupport* domSupport;
+	XalanSourceTreeParserLiaison* liaison;
+	DummyEntityResolver entityResolver;
+	XPathEvaluator* evaluator;
+
+	map<string, CachedDocument> documents;
+	map<XalanDocument*, string> keysByDocument;
+	map<string, string> keysByPath;
+	/** Keys of the cached documents, most recently used first. */
+	list<string> lru;
+	unsigned long long cachedSize;
+
+	/** xpaths without namespace prefixes, compiled once and shared by all documents. */
+	map<string, const XPath*> xpaths;
+};
+
 XmlFileContentProbe* XmlFileContentProbe::instance = NULL;
 
-XmlFileContentProbe::XmlFileContentProbe() {
+XmlFileContentProbe::XmlFileContentProbe() : xalanContext(NULL) {
 
 }
 
 XmlFileContentProbe::~XmlFileContentProbe() {
+  delete xalanContext;
   instance = NULL;
 }
 
@@ -256,71 +341,24 @@ Item* XmlFileContentProbe::EvaluateXpath(string path, string fileName, string xp
 
 	Item* item = NULL;
 
-	string contextNode = "/";
-
 	string filePath = Common::BuildFilePath(path, fileName);
 
-	XPathEvaluator::initialize();
-
-	// Initialize the XalanSourceTree subsystem...
-	XalanSourceTreeInit	theSourceTreeInit;
-
-	// We'll use these to parse the XML file.
-	XalanSourceTreeDOMSupport theDOMSupport;
-	XalanSourceTreeParserLiaison theLiaison(theDOMSupport);
-    theLiaison.setEntityResolver(new DummyEntityResolver());
-
-	// Hook the two together...
-	theDOMSupport.setParserLiaison(&theLiaison);
+	// Xalan is initialized once and torn down with the probe
+	if(this->xalanContext == NULL)
+		this->xalanContext = new XalanContext();
 
     try{				
-		const XalanDOMString theFileName(filePath.c_str());
-
-		// Create an input source that represents a local file...
-		const LocalFileInputSource	theInputSource(theFileName.c_str());
-
-		// Parse the document...
-		XalanDocument* theDocument = NULL;
-		try {
-			theDocument = theLiaison.parseXMLStream(theInputSource);
-		} catch (SAXParseException &e) {
-			throw ProbeException("SAXParseException parsing " + filePath +
-								 ": " + XmlCommon::ToString(e.getMessage()) + 
-								 "  Line=" + Common::ToString(e.getLineNumber()) +
-								 ", Col=" + Common::ToString(e.getColumnNumber()));
-		} catch (SAXException &e) {
-			throw ProbeException("SAXException parsing " + filePath + ": " +
-								 XmlCommon::ToString(e.getMessage()));
-		} catch(...) {
-			theDocument = NULL;
-			// this should never happen at this point only documents that exist should get here
-		}
+		// Parse the document, or reuse it if it was already parsed
+		XalanDocument* theDocument = this->xalanContext->GetDocument(filePath);
 
-		if(theDocument == NULL) {
-			throw ProbeException("Error: Unable to parse the current document: " + filePath);
-		}else { 
-
-		XalanDocumentPrefixResolver thePrefixResolver(theDocument);
-
-		XPathEvaluator theEvaluator;
-
-		// find the context node...
-		XalanNode* const theContextNode = theEvaluator.selectSingleNode(  theDOMSupport,
-																		  theDocument,
-																		  XalanDOMString(contextNode.c_str()).c_str(),
-																		  thePrefixResolver);
-
-		if (theContextNode == 0) {
-			throw ProbeException("Error the specified context node, \'" + contextNode + "\' was not found.");
-		}else{
-			
-			// evaluate the expression...
+		{
+			// the document itself is the context node ('/')
 			const XObjectPtr theResult = (
-				theEvaluator.evaluate(
-						theDOMSupport,
-						theContextNode,
-						XalanDOMString(xpath.c_str()).c_str(),
-						thePrefixResolver));
+				this->xalanContext->GetEvaluator().evaluate(
+						this->xalanContext->GetDOMSupport(),
+						theDocument,
+						this->xalanContext->GetXPath(xpath, theDocument),
+						this->xalanContext->GetPrefixResolver(theDocument)));
 
 			item = this->CreateItem();
 			item->SetStatus(OvalEnum::STATUS_EXISTS);
@@ -394,11 +432,9 @@ Item* XmlFileContentProbe::EvaluateXpath(string path, string fileName, string xp
 					throw ProbeException("Error: invalid xpath object type was specified. An xpath object must be of type boolean, number, string, or node-set.");
 				}
 			}
-			
 		}
-	}
-	
-	XPathEvaluator::terminate();
+
+	this->xalanContext->Trim();
 
 	} catch(const XSLException& theException) {
 		
@@ -407,25 +443,25 @@ Item* XmlFileContentProbe::EvaluateXpath(string path, string fileName, string xp
 		m << (theException.getMessage());
 		string errMsg = m.str();
 
-		XPathEvaluator::terminate();
+		this->xalanContext->Trim();
 
 		throw ProbeException("Error while evaluating an xpath. " + errMsg);
 
 	} catch(ProbeException ex) {
 
-		XPathEvaluator::terminate();
+		this->xalanContext->Trim();
 
 		throw;
 
 	} catch(Exception ex) {
 
-		XPathEvaluator::terminate();
+		this->xalanContext->Trim();
 
 		throw;
 
 	} catch(...) {
 
-		XPathEvaluator::terminate();
+		this->xalanContext->Trim();
 
 		throw ProbeException("Error: XmlFileContentProbe() An unknown error occured while collecting data.");
 	}
@@ -449,6 +485,168 @@ Item* XmlFileContentProbe::CreateItem() {
 }
 
 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ XalanContext methods ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+XmlFileContentProbe::XalanContext::XalanContext() : cachedSize(0) {
+
+	XPathEvaluator::initialize();
+
+	// Initialize the XalanSourceTree subsystem...
+	this->sourceTreeInit = new XalanSourceTreeInit();
+
+	// We'll use these to parse the XML files.
+	this->domSupport = new XalanSourceTreeDOMSupport();
+	this->liaison = new XalanSourceTreeParserLiaison(*this->domSupport);
+	this->liaison->setEntityResolver(&this->entityResolver);
+
+	// Hook the two together...
+	this->domSupport->setParserLiaison(this->liaison);
+
+	this->evaluator = new XPathEvaluator();
+}
+
+XmlFileContentProbe::XalanContext::~XalanContext() {
+
+	while(!this->lru.empty())
+		this->Evict(this->lru.back());
+
+	// the evaluator owns the shared compiled xpaths
+	this->xpaths.clear();
+	delete this->evaluator;
+
+	delete this->liaison;
+	delete this->domSupport;
+	delete this->sourceTreeInit;
+
+	XPathEvaluator::terminate();
+}
+
+XalanDocument* XmlFileContentProbe::XalanContext::GetDocument(const string &filePath) {
+
+	string key;
+	unsigned long long size = 0;
+	bool cacheable = Common::GetFileKey(filePath, &key, &size);
+
+	if(cacheable) {
+		map<string, CachedDocument>::iterator cached = this->documents.find(key);
+		if(cached != this->documents.end()) {
+			// move it to the front of the lru list
+			this->lru.splice(this->lru.begin(), this->lru, cached->second.lruPosition);
+			return cached->second.document;
+		}
+
+		// drop a stale copy of the file parsed before it changed
+		map<string, string>::iterator stale = this->keysByPath.find(filePath);
+		if(stale != this->keysByPath.end())
+			this->Evict(stale->second);
+	}
+
+	const XalanDOMString theFileName(filePath.c_str());
+
+	// Create an input source that represents a local file...
+	const LocalFileInputSource	theInputSource(theFileName.c_str());
+
+	// Parse the document...
+	XalanDocument* theDocument = NULL;
+	try {
+		theDocument = this->liaison->parseXMLStream(theInputSource);
+	} catch (SAXParseException &e) {
+		throw ProbeException("SAXParseException parsing " + filePath +
+							 ": " + XmlCommon::ToString(e.getMessage()) + 
+							 "  Line=" + Common::ToString(e.getLineNumber()) +
+							 ", Col=" + Common::ToString(e.getColumnNumber()));
+	} catch (SAXException &e) {
+		throw ProbeException("SAXException parsing " + filePath + ": " +
+							 XmlCommon::ToString(e.getMessage()));
+	} catch(...) {
+		theDocument = NULL;
+		// this should never happen at this point only documents that exist should get here
+	}
+
+	if(theDocument == NULL) {
+		throw ProbeException("Error: Unable to parse the current document: " + filePath);
+	}
+
+	// If the file could not be identified it is still tracked, under its
+	// path, so it is released by the next Trim().
+	if(!cacheable) {
+		key = "path:" + filePath;
+		if(this->documents.find(key) != this->documents.end())
+			this->Evict(key);
+	}
+
+	CachedDocument& entry = this->documents[key];
+	entry.document = theDocument;
+	entry.prefixResolver = new XalanDocumentPrefixResolver(theDocument);
+	entry.filePath = filePath;
+	entry.size = cacheable ? size * DOCUMENT_SIZE_FACTOR : ~0ULL;
+	entry.lruPosition = this->lru.insert(this->lru.begin(), key);
+	this->cachedSize += cacheable ? entry.size : 0;
+	this->keysByDocument[theDocument] = key;
+	this->keysByPath[filePath] = key;
+
+	return theDocument;
+}
+
+const PrefixResolver& XmlFileContentProbe::XalanContext::GetPrefixResolver(XalanDocument* document) {
+
+	return *this->documents[this->keysByDocument[document]].prefixResolver;
+}
+
+const XPath& XmlFileContentProbe::XalanContext::GetXPath(const string &xpath, XalanDocument* document) {
+
+	CachedDocument& entry = this->documents[this->keysByDocument[document]];
+
+	map<string, const XPath*>& compiled = UsesNamespacePrefix(xpath) ? entry.prefixedXPaths : this->xpaths;
+	map<string, const XPath*>::iterator iterator = compiled.find(xpath);
+	if(iterator != compiled.end())
+		return *iterator->second;
+
+	const XPath* theXPath = this->evaluator->createXPath(XalanDOMString(xpath.c_str()).c_str(), *entry.prefixResolver);
+	compiled[xpath] = theXPath;
+	return *theXPath;
+}
+
+void XmlFileContentProbe::XalanContext::Trim() {
+
+	unsigned long long budget = (unsigned long long)Common::GetXmlDocumentCacheSize() * 1024 * 1024;
+
+	// documents that could not be identified never stay cached
+	list<string>::iterator iterator = this->lru.begin();
+	while(iterator != this->lru.end()) {
+		string key = *(iterator++);
+		if(this->documents[key].size == ~0ULL)
+			this->Evict(key);
+	}
+
+	while(!this->lru.empty() && this->cachedSize > budget)
+		this->Evict(this->lru.back());
+}
+
+void XmlFileContentProbe::XalanContext::Evict(string key) {
+
+	map<string, CachedDocument>::iterator cached = this->documents.find(key);
+	if(cached == this->documents.end())
+		return;
+
+	CachedDocument& entry = cached->second;
+	for(map<string, const XPath*>::iterator iterator = entry.prefixedXPaths.begin(); iterator != entry.prefixedXPaths.end(); iterator++) {
+		this->evaluator->destroyXPath(const_cast<XPath*>(iterator->second));
+	}
+	delete entry.prefixResolver;
+	this->liaison->destroyDocument(entry.document);
+
+	if(entry.size != ~0ULL)
+		this->cachedSize -= entry.size;
+	this->keysByDocument.erase(entry.document);
+	map<string, string>::iterator byPath = this->keysByPath.find(entry.filePath);
+	if(byPath != this->keysByPath.end() && byPath->second == key)
+		this->keysByPath.erase(byPath);
+	this->lru.erase(entry.lruPosition);
+	this->documents.erase(cached);
+}
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ DummyEntityResolver methods ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
@@ -477,5 +675,14 @@ namespace {
 	{
 		return NULL;
 	}
-}
 
+	bool UsesNamespacePrefix(const string &xpath) {
+		// a single ':' separates a prefix from a name, '::' follows an axis
+		for(string::size_type i = xpath.find(':'); i != string::npos; i = xpath.find(':', i + 2)) {
+			if(i + 1 < xpath.size() && xpath[i + 1] == ':')
+				continue;
+			return true;
+		}
+		return false;
+	}
+}
@@ -72,6 +72,16 @@ private:
 
 	/** Return an Item for the specified xpath if is succeeds otherwise return NULL. */
 	Item* EvaluateXpath(std::string path, std::string fileName, std::string xpath);
+
+	/** 
+		Holds the Xalan state that is reused for the life of the probe: the parsed documents, keyed 
+		by file identity and bounded by Common::GetXmlDocumentCacheSize(), and the compiled xpaths. 
+		It is defined in the implementation file so that this header does not depend on Xalan.
+	*/
+	class XalanContext;
+
+	/** Created the first time an xpath is evaluated. */
+	XalanContext* xalanContext;
 };
 
 #endif
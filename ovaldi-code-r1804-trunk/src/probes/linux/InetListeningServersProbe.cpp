@@ -588,6 +588,8 @@ void InetListeningServersProbe::ExecNetstat() {
 	if (pipe(fd1) < 0 || pipe(fd2) < 0)
 		throw ProbeException("Error: (InetListeningServersProbe) Could not open pipe.");
 
+	// the child must not inherit, and later write, the buffered log messages
+	Log::Flush();
 	if ((pid = fork()) < 0) {
 		throw ProbeException("Error: (InetListeningServersProbe) fork error before running netstat -tuwlnpe.");
 
@@ -625,12 +627,12 @@ void InetListeningServersProbe::ChildExecNetstat(int writeErrh, int writeh) {
   // all error messages will be sent down pipe instead of to screen.
   if (writeh != STDOUT_FILENO) {
     if (dup2(writeh, STDOUT_FILENO) != STDOUT_FILENO)
-      exit(-1);
+      _exit(-1);
   }
 
   if (writeErrh != STDERR_FILENO) {
     if (dup2(writeErrh, STDERR_FILENO) != STDERR_FILENO)
-      exit(-1);
+      _exit(-1);
   }
 
   // Output redirected (duplicated), no longer need pipe
@@ -640,7 +642,8 @@ void InetListeningServersProbe::ChildExecNetstat(int writeErrh, int writeh) {
   // Execute the command
   execl("/bin/netstat", "netstat", "-tuwlnpe", NULL);
 
-  exit(0);
+  // only get here if the exec failed, skip the parent's exit handlers
+  _exit(0);
 } 
 
 NetstatResult* InetListeningServersProbe::ParentGetChildResult(int readErrh, int readh, int pid) { //, char* buf, char* errbuf) {
@@ -44,6 +44,7 @@
 #include <OvalMessage.h>
 #include <OvalEnum.h>
 #include <Log.h>
+#include <TimedFileOps.h>
 
 #include "PartitionProbe.h"
 
@@ -170,8 +171,21 @@ void PartitionProbe::CachePartitions() {
 		// replace any octal escape sequences...
 		this->DecodeMtabMountPoint(&mountPoint);
 		
-		if (statfs64(mountPoint.c_str(), &buf))
-			throw ProbeException("statfs64() error occurred on "+mountPoint+": "+strerror(errno));
+		if (TimedFileOps::Statfs64(mountPoint, &buf)) {
+			if (errno != ETIMEDOUT)
+				throw ProbeException("statfs64() error occurred on "+mountPoint+": "+strerror(errno));
+
+			// an unresponsive mount (e.g. a hung NFS server) gets an error
+			// item so the remaining partitions can still be reported
+			Item *item = this->CreateItem();
+			item->SetStatus(OvalEnum::STATUS_ERROR);
+			item->AppendElement(new ItemEntity("mount_point", mountPoint, OvalEnum::DATATYPE_STRING));
+			item->AppendElement(new ItemEntity("device", device));
+			item->AppendElement(new ItemEntity("fs_type", fsType));
+			item->AppendMessage(new OvalMessage("statfs64() timed out on "+mountPoint, OvalEnum::LEVEL_ERROR));
+			this->cachedPartitionItems.push_back(item);
+			continue;
+		}
 
 		re.GetAllMatchingSubstrings("[^,]+", mountOpts, mountOptMatches);
 
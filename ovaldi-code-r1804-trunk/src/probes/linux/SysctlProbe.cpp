@@ -56,18 +56,16 @@ namespace {
 	 * visitor object.
 	 */
 	class FtwVisitor {
-		ObjectEntity *nameObjEntity;
-		ItemVector *items;
+		vector<pair<string, string> > *index;
 
 	public:
-		void setup(ObjectEntity *nameObjEntity, ItemVector *items) {
-			this->nameObjEntity = nameObjEntity;
-			this->items = items;
+		void setup(vector<pair<string, string> > *index) {
+			this->index = index;
 		}
 
 		/**
-		 * Checks the given path for a match with nameObjEntity, adding an item
-		 * to the items vector, if it matches.
+		 * Adds the given path and the property name it corresponds to to the
+		 * index, if it is a regular file.
 		 */
 		int visit(const char *fpath, const struct stat *sb, int typeflag);
 	};
@@ -109,31 +107,12 @@ namespace {
 	 */
 	string Path2SysctlName(const string &relpath);
 
-	/**
-	 * Reads the given file, adding "value" entities to the given item for each
-	 * line of the file.
-	 */
-	void ReadIntoItem(const string &filepath, Item *item);
-
-	/**
-	 * Instead of searching all sysctl property names, this function directly
-	 * gets values for the given names.  Items are created and added to the
-	 * given vector.
-	 */
-	void GetByName(const StringVector &names, ItemVector *items);
-
 	/**
 	 * A function passed into ftw(3) to process visited files.  It delegates to
 	 * visitorObj above.  Don't call this without first setting up visitorObj,
 	 * as this function delegates to a method of that object.
 	 */
 	int visitor(const char *fpath, const struct stat *sb, int typeflag);
-
-	/**
-	 * Searches all sysctl properties for matches with the given object entity.
-	 * Items are created for those which match, and added to the given vector.
-	 */
-	void SearchAll(ObjectEntity *nameObjEntity, ItemVector *items);
 }
 
 //****************************************************************************************//
@@ -141,7 +120,7 @@ namespace {
 //****************************************************************************************//
 SysctlProbe *SysctlProbe::instance = NULL;
 
-SysctlProbe::SysctlProbe() {
+SysctlProbe::SysctlProbe() : indexBuilt(false) {
 }
 
 SysctlProbe::~SysctlProbe() {
@@ -169,9 +148,9 @@ ItemVector* SysctlProbe::CollectItems(Object* object) {
 	if (nameObjEntity->GetOperation() == OvalEnum::OPERATION_EQUALS) {
 		StringVector names;
 		nameObjEntity->GetEntityValues(names);
-		GetByName(names, collectedItems.get());
+		this->GetByName(names, collectedItems.get());
 	} else
-		SearchAll(nameObjEntity, collectedItems.get());
+		this->SearchAll(nameObjEntity, collectedItems.get());
 
 	return collectedItems.release();
 }
@@ -185,6 +164,86 @@ Item* SysctlProbe::CreateItem() {
 	return NULL;
 }
 
+void SysctlProbe::GetByName(const StringVector &names, ItemVector *items) {
+	for (StringVector::const_iterator nameIter = names.begin();
+		 nameIter != names.end();
+		 ++nameIter) {
+
+		auto_ptr<Item> item(::CreateItem());
+		item->AppendElement(new ItemEntity("name", *nameIter, OvalEnum::DATATYPE_STRING));
+
+		string procSysPath(SysctlName2Path(*nameIter));
+		this->ReadIntoItem(procSysPath, item.get());
+		items->push_back(item.release());
+	}
+}
+
+void SysctlProbe::SearchAll(ObjectEntity *nameObjEntity, ItemVector *items) {
+
+	if (!this->indexBuilt) {
+		SysctlIndex newIndex;
+		visitorObj.setup(&newIndex);
+		int result = ftw(PROC_SYS_ROOT, visitor, 10);
+		if (result)
+			throw ProbeException("Error recursing over " PROC_SYS_ROOT 
+								 ": ftw() returned " + Common::ToString(result));
+		this->index.swap(newIndex);
+		this->indexBuilt = true;
+	}
+
+	for (SysctlIndex::iterator iter = this->index.begin();
+		 iter != this->index.end();
+		 ++iter) {
+
+		auto_ptr<ItemEntity> ie(new ItemEntity("name", iter->first, OvalEnum::DATATYPE_STRING));
+		if (nameObjEntity->Analyze(ie.get()) == OvalEnum::RESULT_TRUE) {
+
+			auto_ptr<Item> item(::CreateItem());
+			item->AppendElement(ie.release());
+
+			// the property matches, now we gotta read the file...
+			this->ReadIntoItem(iter->second, item.get());
+
+			items->push_back(item.release());
+		}
+	}
+}
+
+void SysctlProbe::ReadIntoItem(const string &filepath, Item *item) {
+
+	map<string, SysctlValue>::iterator valueIter = this->values.find(filepath);
+	if (valueIter == this->values.end()) {
+		SysctlValue value;
+		value.readable = false;
+
+		ifstream in(filepath.c_str());
+		if (in) {
+			string line;
+			// for non-newline terminated files, it seems that eof() gets set
+			// but (void*)in is still non-null.  So the loop goes one too many
+			// iterations.  So I check eof() explicitly.
+			while(in && !in.eof()) {
+				getline(in, line);
+				if (!line.empty())
+					value.lines.push_back(line);
+			}
+			value.readable = true;
+		}
+
+		valueIter = this->values.insert(make_pair(filepath, value)).first;
+	}
+
+	if (valueIter->second.readable) {
+		for (StringVector::iterator lineIter = valueIter->second.lines.begin();
+			 lineIter != valueIter->second.lines.end();
+			 ++lineIter)
+			item->AppendElement(new ItemEntity("value", *lineIter));
+		item->SetStatus(OvalEnum::STATUS_EXISTS);
+	} else
+		// i wish the STL gave more error information...
+		item->AppendMessage(new OvalMessage("Could not open "+filepath, OvalEnum::LEVEL_ERROR));
+}
+
 namespace {
 	auto_ptr<Item> CreateItem() {
 		auto_ptr<Item> item(new Item(0,
@@ -236,39 +295,6 @@ namespace {
 		return result;
 	}
 
-	void ReadIntoItem(const string &filepath, Item *item) {
-
-		ifstream in(filepath.c_str());
-		if (in) {
-			string value;
-			// for non-newline terminated files, it seems that eof() gets set
-			// but (void*)in is still non-null.  So the loop goes one too many
-			// iterations.  So I check eof() explicitly.
-			while(in && !in.eof()) {
-				getline(in, value);
-				if (!value.empty())
-					item->AppendElement(new ItemEntity("value", value));
-			}
-			item->SetStatus(OvalEnum::STATUS_EXISTS);
-		} else
-			// i wish the STL gave more error information...
-			item->AppendMessage(new OvalMessage("Could not open "+filepath, OvalEnum::LEVEL_ERROR));
-	}
-
-	void GetByName(const StringVector &names, ItemVector *items) {
-		for (StringVector::const_iterator nameIter = names.begin();
-			 nameIter != names.end();
-			 ++nameIter) {
-
-			auto_ptr<Item> item(CreateItem());
-			item->AppendElement(new ItemEntity("name", *nameIter, OvalEnum::DATATYPE_STRING));
-
-			string procSysPath(SysctlName2Path(*nameIter));
-			ReadIntoItem(procSysPath, item.get());
-			items->push_back(item.release());
-		}
-	}
-
 	int FtwVisitor::visit(const char *fpath, const struct stat *sb, int typeflag) {
 
 		// Users might want to know about failures?
@@ -290,18 +316,8 @@ namespace {
 		if (typeflag != FTW_F || !S_ISREG(sb->st_mode))
 			return 0;
 
-		string sysctlName = Path2SysctlName(fpath);
-		auto_ptr<ItemEntity> ie(new ItemEntity("name", sysctlName, OvalEnum::DATATYPE_STRING));
-		if (this->nameObjEntity->Analyze(ie.get()) == OvalEnum::RESULT_TRUE) {
-
-			auto_ptr<Item> item(CreateItem());
-			item->AppendElement(ie.release());
-
-			// the property matches, now we gotta read the file...
-			ReadIntoItem(fpath, item.get());
-
-			this->items->push_back(item.release());
-		}
+		// the value is not read until some object matches the name
+		this->index->push_back(make_pair(Path2SysctlName(fpath), string(fpath)));
 
 		return 0;
 	}
@@ -309,12 +325,4 @@ namespace {
 	int visitor(const char *fpath, const struct stat *sb, int typeflag) {
 		return visitorObj.visit(fpath, sb, typeflag);
 	}
-
-	void SearchAll(ObjectEntity *nameObjEntity, ItemVector *items) {
-		visitorObj.setup(nameObjEntity, items);
-		int result = ftw(PROC_SYS_ROOT, visitor, 10);
-		if (result)
-			throw ProbeException("Error recursing over " PROC_SYS_ROOT 
-								 ": ftw() returned " + Common::ToString(result));
-	}
 }
@@ -34,10 +34,20 @@
 #include "AbsProbe.h"
 #include <Item.h>
 #include <Object.h>
+#include <StdTypedefs.h>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 /**
  * Implements the sysctl_test on linux.  This is currently implemented to search
  * /proc/sys instead of using a sysctl() system call.
+ *
+ * The /proc/sys tree is only walked once per run, the first time an object
+ * needs to search it.  The walk records the name and file of every property;
+ * later searches match against that index.  Property values are read when an
+ * item first needs them and are remembered for the rest of the run.
  */
 class SysctlProbe : public AbsProbe {
 public:
@@ -53,6 +63,42 @@ private:
     
 	virtual Item* CreateItem();
 
+	/** Sysctl property names paired with the files under /proc/sys which hold their values. */
+	typedef std::vector<std::pair<std::string, std::string> > SysctlIndex;
+
+	/** The contents of a property's file. */
+	struct SysctlValue {
+		bool readable;
+		StringVector lines;
+	};
+
+	/**
+	 * Instead of searching all sysctl property names, this function directly
+	 * gets values for the given names.  Items are created and added to the
+	 * given vector.
+	 */
+	void GetByName(const StringVector &names, ItemVector *items);
+
+	/**
+	 * Searches all sysctl properties for matches with the given object entity.
+	 * Items are created for those which match, and added to the given vector.
+	 * The property index is built the first time this is called.
+	 */
+	void SearchAll(ObjectEntity *nameObjEntity, ItemVector *items);
+
+	/**
+	 * Adds "value" entities to the given item for each line of the given
+	 * file.  The file is only read the first time its value is needed.
+	 */
+	void ReadIntoItem(const std::string &filepath, Item *item);
+
+	/** Every property found under /proc/sys, valid once indexBuilt is set. */
+	SysctlIndex index;
+	bool indexBuilt;
+
+	/** The property values read so far, keyed by file path. */
+	std::map<std::string, SysctlValue> values;
+
 	static SysctlProbe *instance;
 };
 
@@ -28,6 +28,8 @@
 //
 //****************************************************************************************//
 
+#include <TimedFileOps.h>
+
 #include "FileProbe.h"
 
 using namespace std;
@@ -191,10 +193,24 @@ Item* FileProbe::GetFileAttributes(string path, string fileName) {
 	//////////////////////////////////////////////////////
 
 	struct stat sbuf;
-	if (lstat(filePath.c_str(), &sbuf) != 0) {
+	if (TimedFileOps::Lstat(filePath, &sbuf) != 0) {
 		if(errno == ENOENT)
 			return NULL;
 
+		// a file that could not be examined in time is reported as an error
+		// item rather than failing the whole object
+		if(errno == ETIMEDOUT) {
+			item = this->CreateItem();
+			item->SetStatus(OvalEnum::STATUS_ERROR);
+			if (!fileName.empty())
+				item->AppendElement(new ItemEntity("filepath", filePath, OvalEnum::DATATYPE_STRING, OvalEnum::STATUS_EXISTS));
+			item->AppendElement(new ItemEntity("path", path, OvalEnum::DATATYPE_STRING, OvalEnum::STATUS_EXISTS));
+			if (!fileName.empty())
+				item->AppendElement(new ItemEntity("filename", fileName, OvalEnum::DATATYPE_STRING, OvalEnum::STATUS_EXISTS));
+			item->AppendMessage(new OvalMessage("Timed out reading the attributes of " + filePath, OvalEnum::LEVEL_ERROR));
+			return item;
+		}
+
 		throw ProbeException(strerror(errno));
 	}
 
@@ -387,7 +403,7 @@ Item* FileProbe::GetFileAttributes(string path, string fileName) {
 	   6) If a file has an ACL, the value will be 'true'.
 	*/
 	
-	int hasExtendedAcl = acl_extended_file(filePath.c_str());
+	int hasExtendedAcl = TimedFileOps::AclExtendedFile(filePath);
 	if(hasExtendedAcl > -1){ // behavior 4, 5, and 6
           item->AppendElement(new ItemEntity("has_extended_acl",Common::ToString(hasExtendedAcl),OvalEnum::DATATYPE_BOOLEAN,OvalEnum::STATUS_EXISTS,0));
 	}else{
@@ -77,12 +77,36 @@ ItemVector* InetdProbe::CollectItems(Object* object) {
 	ObjectEntity* nameEntity = object->GetElementByName("service_name");
 	ObjectEntity* protocolEntity = object->GetElementByName("protocol");
 
+	const vector<InetdEntry>& entries = this->GetEntries();
+
+	ItemVector* items = new ItemVector();
+	for (vector<InetdEntry>::const_iterator iter = entries.begin(); iter != entries.end(); ++iter) {
+		Item* item = this->Entry2Item(*iter, nameEntity, protocolEntity);
+
+		if (item != NULL)
+			items->push_back(item);
+	}
+
+	return items;
+}
+
+const vector<InetdProbe::InetdEntry>& InetdProbe::GetEntries() {
+
+	EntrySnapshot* snapshot = static_cast<EntrySnapshot*>(ConfigSnapshot::Get(INETD_CONF_FILENAME));
+	if (snapshot != NULL)
+		return snapshot->entries;
+
+	snapshot = new EntrySnapshot();
+	snapshot->AddSource(INETD_CONF_FILENAME);
+
 	ifstream in(INETD_CONF_FILENAME.c_str());
-	if (!in)
+	if (!in) {
+		delete snapshot;
 		throw ProbeException(string("Couldn't open file: ")+INETD_CONF_FILENAME);
+	}
 
-	ItemVector* items = new ItemVector();
 	string line;
+	this->tmpLine.clear();
 
 	//make one dummy call at the beginning to set up our read-ahead.
 	//  (This will also cause any dangling continuation lines at the
@@ -91,13 +115,14 @@ ItemVector* InetdProbe::CollectItems(Object* object) {
 
 	while(in) {
 		this->NextVirtualLine(in, line);
-		Item* item = this->Line2Item(line, nameEntity, protocolEntity);
 
-		if (item != NULL)
-			items->push_back(item);
+		InetdEntry entry;
+		if (this->Line2Entry(line, entry))
+			snapshot->entries.push_back(entry);
 	}
 
-	return items;
+	ConfigSnapshot::Put(INETD_CONF_FILENAME, snapshot);
+	return snapshot->entries;
 }
 
 void InetdProbe::NextVirtualLine(istream& in, string& line) {
@@ -127,9 +152,8 @@ void InetdProbe::NextLine(istream& in, string& line) {
 		line.clear();
 }
 
-Item* InetdProbe::Line2Item(const string& line, ObjectEntity *nameEntity, ObjectEntity* protocolEntity) {
+bool InetdProbe::Line2Entry(const string& line, InetdEntry& entry) {
 
-	string serviceName, protocol, serverProg, serverArgs, socketType, user, wait;
 	vector<StringVector> fieldMatches;
 
 	re.GetAllMatchingSubstrings("\\S+", line, fieldMatches);
@@ -144,41 +168,54 @@ Item* InetdProbe::Line2Item(const string& line, ObjectEntity *nameEntity, Object
 		const string& serviceField = fieldMatches[0][0];
 		string::size_type idx = serviceField.find(':');
 		if (idx == string::npos)
-			serviceName = serviceField;
+			entry.serviceName = serviceField;
 		else
-			serviceName = serviceField.substr(idx+1);
+			entry.serviceName = serviceField.substr(idx+1);
 
-		socketType = fieldMatches[1][0];
-		protocol = fieldMatches[2][0];
+		entry.socketType = fieldMatches[1][0];
+		entry.protocol = fieldMatches[2][0];
 
 		// last part of wait field can be a max thread count
 		const string& waitField = fieldMatches[3][0];
 		idx = waitField.find('.');
 		if (idx == string::npos)
-			wait = waitField;
+			entry.wait = waitField;
 		else
-			wait = waitField.substr(0, idx);
+			entry.wait = waitField.substr(0, idx);
 
 		// last part of user field can be a group
 		const string& userField = fieldMatches[4][0];
 		idx = userField.find_first_of(":.");
 		if (idx == string::npos)
-			user = userField;
+			entry.user = userField;
 		else
-			user = userField.substr(0, idx);
+			entry.user = userField.substr(0, idx);
 
-		serverProg = fieldMatches[5][0];
+		entry.serverProg = fieldMatches[5][0];
 
 		// collect up server args, if any
 		if (fieldMatches.size() > 6) {
-			serverArgs = fieldMatches[6][0];
+			entry.serverArgs = fieldMatches[6][0];
 			for (vector<StringVector>::size_type i=7; i<fieldMatches.size(); ++i) {
-				serverArgs += " ";
-				serverArgs += fieldMatches[i][0];
+				entry.serverArgs += " ";
+				entry.serverArgs += fieldMatches[i][0];
 			}
 		}
 	} else
-		return NULL;
+		return false;
+
+	return true;
+}
+
+Item* InetdProbe::Entry2Item(const InetdEntry& entry, ObjectEntity *nameEntity, ObjectEntity* protocolEntity) {
+
+	const string& serviceName = entry.serviceName;
+	const string& protocol = entry.protocol;
+	const string& serverProg = entry.serverProg;
+	const string& serverArgs = entry.serverArgs;
+	const string& socketType = entry.socketType;
+	const string& user = entry.user;
+	const string& wait = entry.wait;
 
 	ItemEntity* nameItemEntity = new ItemEntity("service_name", serviceName, OvalEnum::DATATYPE_STRING);
 	if (nameEntity->Analyze(nameItemEntity) != OvalEnum::RESULT_TRUE) {
@@ -31,6 +31,7 @@
 #define INETDPROBE_H
 
 #include <AbsProbe.h>
+#include <ConfigSnapshot.h>
 #include <istream>
 #include <Item.h>
 #include <Object.h>
@@ -38,9 +39,12 @@
 #include <REGEX.h>
 #include <set>
 #include <string>
+#include <vector>
 
 /**
- * The probe for analyzing inetd config files.
+ * The probe for analyzing inetd config files.  The config file is parsed
+ * once into a snapshot of entries, which is reused for every object until
+ * the file changes.
  */
 class InetdProbe : public AbsProbe {
 
@@ -56,8 +60,31 @@ class InetdProbe : public AbsProbe {
 
 	private:
 
+	/** The fields of one service entry in the config file. */
+	struct InetdEntry {
+		std::string serviceName;
+		std::string socketType;
+		std::string protocol;
+		std::string wait;
+		std::string user;
+		std::string serverProg;
+		std::string serverArgs;
+	};
+
+	/** The entries read from the config file. */
+	class EntrySnapshot : public ConfigSnapshot {
+		public:
+		std::vector<InetdEntry> entries;
+	};
+
 	InetdProbe();
 
+	/**
+	 * Returns the entries of the config file, reading them if they have not
+	 * been read yet or the file has changed since.
+	 */
+	const std::vector<InetdEntry>& GetEntries();
+
 	/**
 	 * Gets the next "line" of the given stream, where here, a "line"
 	 * is a complete configuration entry, including continuation lines.
@@ -71,11 +98,16 @@ class InetdProbe : public AbsProbe {
 	void NextLine(std::istream& in, std::string& line);
 
 	/**
-	 * Breaks up the given line into pieces and creates an item.  If
-	 * one could not be created, e.g. because it didn't match the object,
-	 * or the line was malformed, NULL is returned.
+	 * Breaks up the given line into the fields of an entry.  If the
+	 * line was malformed, false is returned.
+	 */
+	bool Line2Entry(const std::string& line, InetdEntry& entry);
+
+	/**
+	 * Creates an item from the given entry.  If the entry didn't match
+	 * the object, NULL is returned.
 	 */
-	Item* Line2Item(const std::string& line, ObjectEntity *nameEntity, ObjectEntity* protocolEntity);
+	Item* Entry2Item(const InetdEntry& entry, ObjectEntity *nameEntity, ObjectEntity* protocolEntity);
 
 	/** Stores our read-ahead line */
 	std::string tmpLine;
@@ -96,18 +96,18 @@ ItemVector* PasswordProbe::CollectItems(Object* object) {
 	return items;
 }
 
-Item *PasswordProbe::CreateItemFromPasswd(const struct passwd *pwInfo) {
+Item *PasswordProbe::CreateItemFromPasswd(const AccountTable::PasswdEntry &pwInfo) {
 	Item *item = this->CreateItem();
 	item->SetStatus(OvalEnum::STATUS_EXISTS);
 	
-	ItemEntity *nameEntity = new ItemEntity("username", pwInfo->pw_name,
+	ItemEntity *nameEntity = new ItemEntity("username", pwInfo.name,
 											OvalEnum::DATATYPE_STRING);
-	ItemEntity *passwordEntity = new ItemEntity("password", pwInfo->pw_passwd);
-	ItemEntity *useridEntity = new ItemEntity("user_id", Common::ToString(pwInfo->pw_uid), OvalEnum::DATATYPE_INTEGER);
-	ItemEntity *groupidEntity = new ItemEntity("group_id", Common::ToString(pwInfo->pw_gid), OvalEnum::DATATYPE_INTEGER);
-	ItemEntity *gcosEntity = new ItemEntity("gcos", pwInfo->pw_gecos);
-	ItemEntity *homeDirEntity = new ItemEntity("home_dir", pwInfo->pw_dir);
-	ItemEntity *loginShellEntity = new ItemEntity("login_shell", pwInfo->pw_shell);
+	ItemEntity *passwordEntity = new ItemEntity("password", pwInfo.password);
+	ItemEntity *useridEntity = new ItemEntity("user_id", Common::ToString(pwInfo.uid), OvalEnum::DATATYPE_INTEGER);
+	ItemEntity *groupidEntity = new ItemEntity("group_id", Common::ToString(pwInfo.gid), OvalEnum::DATATYPE_INTEGER);
+	ItemEntity *gcosEntity = new ItemEntity("gcos", pwInfo.gecos);
+	ItemEntity *homeDirEntity = new ItemEntity("home_dir", pwInfo.homeDir);
+	ItemEntity *loginShellEntity = new ItemEntity("login_shell", pwInfo.shell);
 
 	item->AppendElement(nameEntity);
 	item->AppendElement(passwordEntity);
@@ -121,8 +121,8 @@ Item *PasswordProbe::CreateItemFromPasswd(const struct passwd *pwInfo) {
 }
 
 Item *PasswordProbe::GetSingleItem(const string& username) {
-	errno = 0;
-	struct passwd *pwInfo = getpwnam(username.c_str());
+	int error = 0;
+	const AccountTable::PasswdEntry *pwInfo = AccountTable::FindPasswd(username, &error);
 	Item *item;
 
 	if (pwInfo == NULL) {
@@ -130,29 +130,32 @@ Item *PasswordProbe::GetSingleItem(const string& username) {
 		ItemEntity *nameEntity = new ItemEntity("username", username, OvalEnum::DATATYPE_STRING);
 		item->AppendElement(nameEntity);
 
-		if (errno == 0) {
+		if (error == 0) {
 			// for a simple not-found condition, return the dummy item with
 			// appropriate status.
 			item->SetStatus(OvalEnum::STATUS_DOES_NOT_EXIST);
 		} else {
 			// if some other error occurred, set error status and append a message
 			item->SetStatus(OvalEnum::STATUS_ERROR);
-			item->AppendMessage(new OvalMessage(string("Error getting user info: ")+strerror(errno),
+			item->AppendMessage(new OvalMessage(string("Error getting user info: ")+strerror(error),
 												OvalEnum::LEVEL_ERROR));
 		}
 	} else
-		item = this->CreateItemFromPasswd(pwInfo);
+		item = this->CreateItemFromPasswd(*pwInfo);
 
 	return item;
 }
 
 ItemVector *PasswordProbe::GetMultipleItems(Object *passwordObject) {
-	struct passwd *pwInfo;
+	// the user database is only swept once per run; this throws if
+	// that sweep failed
+	const vector<AccountTable::PasswdEntry> &entries = AccountTable::GetPasswdEntries();
 	ItemVector *items = new ItemVector();
 
-	errno = 0;
-	while ((pwInfo = getpwent()) != NULL) {
-		Item *item = this->CreateItemFromPasswd(pwInfo);
+	for (vector<AccountTable::PasswdEntry>::const_iterator iter = entries.begin();
+		 iter != entries.end();
+		 ++iter) {
+		Item *item = this->CreateItemFromPasswd(*iter);
 
 		if (passwordObject->Analyze(item))
 			items->push_back(item);
@@ -160,22 +163,6 @@ ItemVector *PasswordProbe::GetMultipleItems(Object *passwordObject) {
 			delete item;
 	}
 
-	endpwent();
-
-	if (errno != 0) {
-		// error occurred... delete all items we found and throw
-		// an exception
-		while (!items->empty()) {
-			Item *item = items->back();
-			items->pop_back();
-			delete item;
-		}
-		
-		delete items;
-		throw ProbeException(string("Error getting user info: ")+strerror(errno),
-							 ERROR_WARN);
-	}
-
 	return items;
 }
 
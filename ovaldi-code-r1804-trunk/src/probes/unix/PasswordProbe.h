@@ -33,7 +33,7 @@
 #include "AbsProbe.h"
 #include "Item.h"
 #include "Object.h"
-#include <pwd.h>
+#include "AccountTable.h"
 #include <string>
 
 
@@ -59,8 +59,8 @@ class PasswordProbe : public AbsProbe {
 
 	PasswordProbe();
 
-	/** Creates an item from a passwd struct */
-	Item *CreateItemFromPasswd(struct passwd const *pwInfo);
+	/** Creates an item from a user database entry */
+	Item *CreateItemFromPasswd(const AccountTable::PasswdEntry &pwInfo);
 
 	/** Finds a single item by name. */
 	Item *GetSingleItem(const std::string& username);
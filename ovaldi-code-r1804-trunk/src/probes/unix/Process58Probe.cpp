@@ -33,6 +33,7 @@
 #  include <selinux/context.h>
 #  include <sys/capability.h>
 #  include <SecurityContextGuard.h>
+#  include <ProcessTable.h>
 #endif
 
 #include <fstream>
@@ -336,19 +337,13 @@ void Process58Probe::GetPSInfo(string command, string pidStr, ItemVector* items)
 	if (!Common::FromString(pidStr, &pid))
 		throw ProbeException("Couldn't interpret \""+pidStr+"\" as a pid!");
 
-	// Grab the current time and uptime(Linux only) to calculate start and exec times later
-	currentTime = time(NULL);
-
+	// Grab the snapshot time and uptime(Linux only) to calculate start and exec times later
 	unsigned long uptime = 0;
-	if(!RetrieveUptime(&uptime, &errMsg)) {
-		throw ProbeException(errMsg);
-    }
+	if(!ProcessTable::GetUptime(&uptime, &currentTime, &errMsg)) {
+		throw ProbeException("Process58Probe: " + errMsg);
+	}
 
 	string procDir = "/proc/" + pidStr;
-	struct stat st;
-
-	if (stat(procDir.c_str(), &st) != 0)
-		return; // oops, this process went away when we weren't looking
 
 	// Clear the ps values
 	memset(cmdline, 0, CMDLINE_LEN + 1);
@@ -538,191 +533,74 @@ void Process58Probe::GetPSInfo(string command, string pidStr, ItemVector* items)
 
 Process58Probe::ProcStatus Process58Probe::RetrieveStatFile(const string &process, int *ppid, long *priority, unsigned long *starttime, pid_t *session, unsigned long *policy, string *errMsg) {
 
-	// Stat File parameters.  While we're really only concerned with gathering the parameters
-	// that are passed in, these variables are good placeholders in case we decide to collect
-	// something else in the future.
-	//
-	pid_t pid; // obviously we already know this...
-	int pgrp, tty, tpgid, exit_signal, processor = 0;
-	long cutime, cstime, nice, placeholder, itrealvalue, rss = 0;
-	unsigned long flags, minflt, cminflt, majflt, cmajflt, utime, stime, vsize, rt_priority, rlim = 0;
-	unsigned long startcode, endcode, startstack, kstkesp, kstkeip, signal, blocked, sigignore = 0;
-	unsigned long sigcatch, wchan, nswap, cnswap = 0;
-	char comm[PATH_MAX];
-	char state;
-
-	FILE *statFile = NULL;
-
-	// Generate the absolute path name for the 'stat' file
-	string statPath = "/proc/"+process+"/stat";
-
-	// Open the 'stat' file and read the contents
-	if((statFile = fopen(statPath.c_str(), "r")) == NULL) {
-		if (errno == ENOENT)
-			return PROC_TERMINATED;
-
-		*errMsg = "Process58Probe: Error opening "+statPath+": "+strerror(errno);
+	ProcessTable::StatInfo info;
+	ProcessTable::ProcStatus status = ProcessTable::GetStat(process, &info, errMsg);
+	if (status == ProcessTable::PROC_TERMINATED)
+		return PROC_TERMINATED;
+	else if (status == ProcessTable::PROC_ERROR) {
+		*errMsg = "Process58Probe: " + *errMsg;
 		return PROC_ERROR;
-
-	} else {
-
-		// Linux gives us a nicely formatted file for fscanf to pull in
-	  fscanf(statFile, "%d %s %c %d %d %d %d %d %lu %lu %lu %lu %lu %lu %lu %ld %ld %ld %ld %ld %ld %lu %lu %ld %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %d %d %lu %lu", &pid, comm, &state, ppid, &pgrp, session, &tty, &tpgid, &flags, &minflt, &cminflt, &majflt, &cmajflt, &utime, &stime, &cutime, &cstime, priority, &nice, &placeholder, &itrealvalue, starttime, &vsize, &rss, &rlim, &startcode, &endcode, &startstack, &kstkesp, &kstkeip, &signal, &blocked, &sigignore, &sigcatch, &wchan, &nswap, &cnswap, &exit_signal, &processor, &rt_priority, policy);
-
 	}
 
-	if (fclose(statFile) == EOF) {
-		*errMsg = "Error closing "+statPath+": "+strerror(errno);
-		return PROC_ERROR;
-	}
+	*ppid = info.ppid;
+	*priority = info.priority;
+	*starttime = info.starttime;
+	*session = info.session;
+	*policy = info.policy;
 
 	return PROC_OK;
 }
 
 Process58Probe::ProcStatus Process58Probe::RetrieveStatusFile(const string &process, uid_t **ruid, uid_t **euid, uint64_t **effCap, string *errMsg) {
-	string statusFileName = "/proc/"+process+"/status";
-	bool foundUid=false, foundCapEff=false;
-	errno = 0;
-	ifstream statusFile(statusFileName.c_str());
 
-	if (!statusFile) {
-		// Processes come and go; if it went away, that's ok.
-		// No need to report.  If there was some other
-		// error, throw an exception.
-		if (errno == ENOENT)
-			return PROC_TERMINATED;
-
-		*errMsg = "Process58Probe: Error opening "+statusFileName+": "+strerror(errno);
+	ProcessTable::StatusInfo info;
+	ProcessTable::ProcStatus status = ProcessTable::GetStatus(process, &info, errMsg);
+	if (status == ProcessTable::PROC_TERMINATED)
+		return PROC_TERMINATED;
+	else if (status == ProcessTable::PROC_ERROR) {
+		*errMsg = "Process58Probe: " + *errMsg;
 		return PROC_ERROR;
 	}
 
-	string line;
-	while (statusFile) {
-		getline(statusFile, line);
-
-		// eof is ok, other errors are not
-		if (!statusFile) {
-			if (statusFile.eof())
-				break;
-			else {
-				*errMsg = "Error reading "+statusFileName+": "+strerror(errno);
-				return Process58Probe::PROC_ERROR;
-			}
-		}
-
-		istringstream iss(line);
-		string label;
-		errno = 0;
-		iss >> label;
-
-		if (!iss) {
-			*errMsg = "Couldn't read label from line \""+line+"\" in "+statusFileName;
-			return PROC_ERROR;
-		}
-
-		if (label == "Uid:") {
-			iss >> **ruid >> **euid;
-			foundUid = true;
-
-		} else if (label == "CapEff:") {
-			iss >> hex >> **effCap >> dec;
-			foundCapEff = true;
-		}
-
-		if (!iss) {
-			if (iss.eof())
-				// eol was premature
-				*errMsg = "Premature end-of-line while reading "+label+" from "+
-					statusFileName;
-			else
-				*errMsg = "Error encountered while reading "+statusFileName+": "+
-					strerror(errno);
-
-			return PROC_ERROR;
-		}
-	}
+	if (info.foundUid) {
+		**ruid = info.ruid;
+		**euid = info.euid;
+	} else
+		*ruid = *euid = NULL;
 
-	if (!foundUid) *ruid = *euid = NULL;
-	if (!foundCapEff) *effCap = NULL;
+	if (info.foundCapEff)
+		**effCap = info.effCap;
+	else
+		*effCap = NULL;
 
 	return PROC_OK;
 }
 
 Process58Probe::ProcStatus Process58Probe::RetrieveTTY(const string &process, char *ttyName, string *err) {
-	int bytes = 0;
-
-	// Generate the absolute path name for the stdout(0) file in 'fd'
-	string ttyPath = "/proc/" + process + "/fd/0";
-
-	// Attempt to read the name of the file linked to '0'
-	bytes = readlink(ttyPath.c_str(), ttyName, TTY_LEN);
-
-	// If there is an error, set the tty string to '?'
-	if(bytes < 0 || strncmp(ttyName, "/dev", 4) != 0) {
-		strncpy(ttyName, "?\0", 2);
-
-		if (bytes < 0) {
-			// we can't check for ENOENT and return PROC_TERMINATED here, since
-			// not all processes have a /proc/<pid>/fd/0 symlink.  If the link
-			// isn't there, we just assume the process is there but doesn't have
-			// a stdout.  Actually, that shouldn't be an error either.  It
-			// should only be an error if the link was there but we just
-			// couldn't read it.  So let's say ENOENT is ok.
-			if (errno == ENOENT)
-				return PROC_OK;
-
-			*err = "readlink("+ttyPath+"): "+strerror(errno);
-			return PROC_ERROR;
-		}
-	}
 
-	return PROC_OK;
-}
-
-bool Process58Probe::RetrieveUptime(unsigned long *uptime, string *errMsg) {
-	// The second value in this file represents idle time - we're not concerned with this.
-	unsigned long idle = 0;
-	FILE *uptimeHandle = NULL;
-
-	// Open and parse the 'uptime' file
-	if((uptimeHandle = fopen("/proc/uptime", "r")) == NULL) {
-		*errMsg = string("Process58Probe: Could not open /proc/uptime: ") + strerror(errno);
-		uptime = 0;
-		return false;
-	} else {
-		fscanf(uptimeHandle, "%lu %lu", uptime, &idle);
-	}
+	// The snapshot reports '?' for processes whose stdout(0) is not a device
+	string tty;
+	ProcessTable::ProcStatus status = ProcessTable::GetTTY(process, &tty, err);
+	strncpy(ttyName, tty.c_str(), TTY_LEN);
+	ttyName[TTY_LEN] = '\0';
 
-	if (fclose(uptimeHandle) == EOF) {
-		*errMsg = string("fclose(/proc/uptime): ") + strerror(errno);
-		return false;
-	}
+	if (status == ProcessTable::PROC_TERMINATED)
+		return PROC_TERMINATED;
+	else if (status == ProcessTable::PROC_ERROR)
+		return PROC_ERROR;
 
-	return true;
+	return PROC_OK;
 }
 
 Process58Probe::ProcStatus Process58Probe::RetrieveLoginUid(pid_t pid, uid_t *loginUid, string *err) {
-	string loginUidFilename = "/proc/" + Common::ToString(pid) + "/loginuid";
-	errno = 0;
-	ifstream in(loginUidFilename.c_str());
 
-	if (!in) {
-		if (errno == ENOENT)
-			return PROC_TERMINATED;
-
-		*err = "Couldn't open " + loginUidFilename + ": " + strerror(errno);
+	ProcessTable::ProcStatus status = ProcessTable::GetLoginUid(Common::ToString(pid), loginUid, err);
+	if (status == ProcessTable::PROC_TERMINATED)
+		return PROC_TERMINATED;
+	else if (status == ProcessTable::PROC_ERROR)
 		return PROC_ERROR;
-	}
-
-	in >> *loginUid;
-
-	if (in)
-		return PROC_OK;
 
-	*err = "Couldn't interpret contents of " + loginUidFilename +
-		" as a uid";
-
-	return PROC_ERROR;
+	return PROC_OK;
 }
 
 void Process58Probe::AddCapabilities(Item *item, uint64_t effCap) {
@@ -1039,6 +917,21 @@ bool Process58Probe::CommandExists(string command, string &pid) {
   free(data);
   return exists;
 }
+#elif defined LINUX
+bool Process58Probe::CommandExists(string command, string &pid) {
+
+	// the process table snapshot is indexed by command line
+	StringVector pids;
+	if (!ProcessTable::FindByCommandLine(command, &pids))
+		return false;
+
+	pid = pids[0];
+	return true;
+}
+bool Process58Probe::CommandExists(string command, StringVector &pids) {
+
+	return ProcessTable::FindByCommandLine(command, &pids);
+}
 #else
 bool Process58Probe::CommandExists(string command, string &pid) {
 
@@ -1168,6 +1061,21 @@ StringPairVector* Process58Probe::GetMatchingCommands(string pattern, bool isReg
   free(data);
   return commands;
 }
+#elif defined LINUX
+StringPairVector* Process58Probe::GetMatchingCommands(string pattern, bool isRegex) {
+
+	const ProcessTable::CommandLineVector& commandLines = ProcessTable::GetCommandLines();
+	StringPairVector* commands = new StringPairVector();
+
+	ProcessTable::CommandLineVector::const_iterator iterator;
+	for(iterator = commandLines.begin(); iterator != commandLines.end(); iterator++) {
+		if(this->IsMatch(pattern, iterator->second, isRegex)) {
+			commands->push_back(new pair<string,string>(iterator->second, iterator->first));
+		}
+	}
+
+	return commands;
+}
 #else
 StringPairVector* Process58Probe::GetMatchingCommands(string pattern, bool isRegex) {
 	StringPairVector* commands = new StringPairVector();
@@ -1217,46 +1125,23 @@ StringPairVector* Process58Probe::GetMatchingCommands(string pattern, bool isReg
 #endif
 
 int Process58Probe::RetrieveCommandLine(const char *process, char *cmdline, string *errMsg) {
-	// Build the absolute path to the command line file
-	string cmdlinePath = "/proc/";
-	cmdlinePath.append(process);
 
 #ifdef LINUX
-	FILE *cmdlineFile = NULL;
-	int i = 0;
-	int bytes = 0;	
-	
-	cmdlinePath.append("/cmdline");
-
-	// Open the file for reading
-	if((cmdlineFile = fopen(cmdlinePath.c_str(), "r")) == NULL) {
+	const string* snapshotCmdline = ProcessTable::GetCommandLine(process);
+	if(snapshotCmdline == NULL) {
 		errMsg->append("Process58Probe: Unable to obtain command line for pid: ");
 		errMsg->append(process);
 		return(-1);
-
-	} else {
-    
-		// Read the contents of the file, and convert all of the NULL's
-		// separating the args to spaces.
-		//
-		bytes = fread(cmdline, sizeof(char), CMDLINE_LEN, cmdlineFile);
-		
-		// Remember to leave the trailing NULL (bytes - 1).
-		for(i = 0; i < bytes - 1; i++) {
-			if(cmdline[i] == '\0') {
-				cmdline[i] = ' ';
-			}
-		}
-		//Clean up excess trailing spaces
-		string cmdlinestr = cmdline;
-		Common::TrimEnd(cmdlinestr);
-		strcpy (cmdline, cmdlinestr.c_str());
 	}
 
-	fclose(cmdlineFile); 
+	strncpy(cmdline, snapshotCmdline->c_str(), CMDLINE_LEN);
+	cmdline[CMDLINE_LEN] = '\0'; // ensure null-termination
 
 #elif defined SUNOS
 
+	// Build the absolute path to the psinfo file
+	string cmdlinePath = "/proc/";
+	cmdlinePath.append(process);
 	cmdlinePath += "/psinfo";
 	psinfo_t info;
 	
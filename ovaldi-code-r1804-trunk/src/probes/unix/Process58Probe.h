@@ -191,12 +191,6 @@ private:
 	*/
 	ProcStatus RetrieveTTY(const std::string &process, char *ttyName, std::string *err);
 
-	/**
-		Read the value contained in '/proc/uptime/' so that we can calculate
-		the start time and exec time of the running processes.
-	*/
-	bool RetrieveUptime(unsigned long *uptime, std::string *errMsg);
-
 	/**
 	 * Get the contents of /proc/<pid>/loginuid
 	 */
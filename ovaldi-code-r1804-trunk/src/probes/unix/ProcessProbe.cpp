@@ -52,6 +52,10 @@
 
 #include <Log.h>
 
+#ifdef LINUX
+#include <ProcessTable.h>
+#endif
+
 // Define some buffer lengths
 #define CMDLINE_LEN 1024
 #define TTY_LEN PATH_MAX
@@ -270,20 +274,11 @@ void ProcessProbe::GetPSInfo(string command, string pidStr, ItemVector* items) {
 
 	int status = 0;
 
-	// Grab the current time and uptime(Linux only) to calculate start and exec times later
-	currentTime = time(NULL);
-
+	// Grab the snapshot time and uptime(Linux only) to calculate start and exec times later
 	unsigned long uptime = 0;
-	status = RetrieveUptime(&uptime, &errMsg);
-	if(status < 0) {
-		throw ProbeException(errMsg);
-    }
-
-	string procDir = "/proc/" + pidStr;
-	struct stat st;
-
-	if (stat(procDir.c_str(), &st) != 0)
-		return; // oops, this process went away when we weren't looking
+	if(!ProcessTable::GetUptime(&uptime, &currentTime, &errMsg)) {
+		throw ProbeException("ProcessProbe: " + errMsg);
+	}
 
 	// Clear the ps values
 	memset(cmdline, 0, CMDLINE_LEN + 1);
@@ -380,120 +375,55 @@ void ProcessProbe::GetPSInfo(string command, string pidStr, ItemVector* items) {
 
 int ProcessProbe::RetrieveStatFile(const char *process, int *pid, int *ppid, long *priority, unsigned long *starttime, unsigned long *policy, string *errMsg) {
 
-  // Stat File parameters.  While we're really only concerned with gathering the parameters
-  // that are passed in, these variables are good placeholders in case we decide to collect
-  // something else in the future.
-  //
-  int pgrp, session, tty, tpgid, exit_signal, processor = 0;
-  long cutime, cstime, nice, placeholder, itrealvalue, rss = 0;
-  unsigned long flags, minflt, cminflt, majflt, cmajflt, utime, stime, vsize, rt_priority, rlim = 0;
-  unsigned long startcode, endcode, startstack, kstkesp, kstkeip, signal, blocked, sigignore = 0;
-  unsigned long sigcatch, wchan, nswap, cnswap = 0;
-  char comm[PATH_MAX];
-  char state;
-
-  FILE *statFile = NULL;
-
-  // Generate the absolute path name for the 'stat' file
-  string statPath = "/proc/";
-  statPath.append(process);
-  statPath.append("/stat");
-
-  // Open the 'stat' file and read the contents
-  if((statFile = fopen(statPath.c_str(), "r")) == NULL) {
-    errMsg->append("ProcessProbe: Unable to obtain process information for pid: ");
-    errMsg->append(process);
-    return(-1);
-
-  } else {
-
-    // Linux gives us a nicely formatted file for fscanf to pull in
-    fscanf(statFile, "%d %s %c %d %d %d %d %d %lu %lu %lu %lu %lu %lu %lu %ld %ld %ld %ld %ld %ld %lu %lu %ld %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %d %d %lu %lu", pid, comm, &state, ppid, &pgrp, &session, &tty, &tpgid, &flags, &minflt, &cminflt, &majflt, &cmajflt, &utime, &stime, &cutime, &cstime, priority, &nice, &placeholder, &itrealvalue, starttime, &vsize, &rss, &rlim, &startcode, &endcode, &startstack, &kstkesp, &kstkeip, &signal, &blocked, &sigignore, &sigcatch, &wchan, &nswap, &cnswap, &exit_signal, &processor, &rt_priority, policy);
+	ProcessTable::StatInfo info;
+	string err;
+	if(ProcessTable::GetStat(process, &info, &err) != ProcessTable::PROC_OK || !Common::FromString(process, pid)) {
+		errMsg->append("ProcessProbe: Unable to obtain process information for pid: ");
+		errMsg->append(process);
+		return(-1);
+	}
 
-  }
-  fclose(statFile);
+	*ppid = info.ppid;
+	*priority = info.priority;
+	*starttime = info.starttime;
+	*policy = info.policy;
 
-  return(0);
+	return(0);
 }
 
 int ProcessProbe::RetrieveStatusFile(const char *process, int *ruid, int *euid, string *errMsg) {
-	string statusFileName = string("/proc/")+process+"/status";
-	errno = 0;
-	ifstream statusFile(statusFileName.c_str());
 
-	if (!statusFile) {
-		// Processes come and go; if it went away, that's ok.
-		// No need to report.  If there was some other
-		// error, throw an exception.
-		if (errno == ENOENT)
-			return -1;
+	ProcessTable::StatusInfo info;
+	string err;
+	ProcessTable::ProcStatus status = ProcessTable::GetStatus(process, &info, &err);
 
-		*errMsg = "ProcessProbe: Error opening "+statusFileName+": "+strerror(errno);
+	// Processes come and go; if it went away, that's ok.
+	// No need to report.
+	if(status == ProcessTable::PROC_TERMINATED)
+		return -1;
+
+	if(status == ProcessTable::PROC_ERROR) {
+		*errMsg = "ProcessProbe: " + err;
 		return -1;
 	}
 
-	string line, label;
-	while (statusFile) {
-		getline(statusFile, line);
-		istringstream iss(line);
-		iss >> label;
-		if (label == "Uid:") {
-			*ruid = *euid = -1;
-			errno = 0;
-			iss >> *ruid >> *euid;
-			if (iss)
-				return 1;
-
-			if ((*ruid == -1 || *euid == -1) && iss.eof())
-				// we didn't get values for both... eol was premature
-				*errMsg = "Premature end-of-line while reading ruid and euid from "+
-					statusFileName;
-			else if (errno != 0)
-				*errMsg = "Error encountered while reading "+statusFileName+": "+
-					strerror(errno);
-			//else... we dunno what happened...
-
-			return -1;
-		}
+	if(!info.foundUid) {
+		*errMsg += string("'Uid:' line not found in /proc/")+process+"/status";
+		return -1;
 	}
 
-	*errMsg += "'Uid:' line not found in "+statusFileName;
-	return -1;
+	*ruid = info.ruid;
+	*euid = info.euid;
+	return 1;
 }
 
 void ProcessProbe::RetrieveTTY(const char *process, char *ttyName) {
-  int bytes = 0;
 
-  // Generate the absolute path name for the stdout(0) file in 'fd'
-  string ttyPath = "/proc/";
-  ttyPath.append(process);
-  ttyPath.append("/fd/0");
-
-  // Attempt to read the name of the file linked to '0'
-  bytes = readlink(ttyPath.c_str(), ttyName, TTY_LEN);
-
-  // If there is an error, set the tty string to '?'
-  if(bytes < 0 || strncmp(ttyName, "/dev", 4) != 0) {
-    strncpy(ttyName, "?\0", 2);
-  }
-}
-
-int  ProcessProbe::RetrieveUptime(unsigned long *uptime, string *errMsg) {
-  // The second value in this file represents idle time - we're not concerned with this.
-  unsigned long idle = 0;
-  FILE *uptimeHandle = NULL;
-
-  // Open and parse the 'uptime' file
-  if((uptimeHandle = fopen("/proc/uptime", "r")) == NULL) {
-    errMsg->append("ProcessProbe: Could not open /proc/uptime");
-    uptime = 0;
-    return(-1);
-  } else {
-    fscanf(uptimeHandle, "%lu %lu", uptime, &idle);
-  }
-  fclose(uptimeHandle);
-
-  return(0);
+	// Any error leaves the tty as '?'
+	string tty, err;
+	ProcessTable::GetTTY(process, &tty, &err);
+	strncpy(ttyName, tty.c_str(), TTY_LEN);
+	ttyName[TTY_LEN] = '\0';
 }
 
 #elif defined SUNOS
@@ -758,6 +688,17 @@ bool ProcessProbe::CommandExists(string command, string &pid) {
   free(data);
   return exists;
 }
+#elif defined LINUX
+bool ProcessProbe::CommandExists(string command, string &pid) {
+
+	// the process table snapshot is indexed by command line
+	StringVector pids;
+	if(!ProcessTable::FindByCommandLine(command, &pids))
+		return false;
+
+	pid = pids[0];
+	return true;
+}
 #else
 bool ProcessProbe::CommandExists(string command, string &pid) {
 
@@ -844,6 +785,21 @@ StringPairVector* ProcessProbe::GetMatchingCommands(string pattern, bool isRegex
   free(data);
   return commands;
 }
+#elif defined LINUX
+StringPairVector* ProcessProbe::GetMatchingCommands(string pattern, bool isRegex) {
+
+	const ProcessTable::CommandLineVector& commandLines = ProcessTable::GetCommandLines();
+	StringPairVector* commands = new StringPairVector();
+
+	ProcessTable::CommandLineVector::const_iterator iterator;
+	for(iterator = commandLines.begin(); iterator != commandLines.end(); iterator++) {
+		if(this->IsMatch(pattern, iterator->second, isRegex)) {
+			commands->push_back(new pair<string,string>(iterator->second, iterator->first));
+		}
+	}
+
+	return commands;
+}
 #else
 StringPairVector* ProcessProbe::GetMatchingCommands(string pattern, bool isRegex) {
 	StringPairVector* commands = new StringPairVector();
@@ -892,46 +848,23 @@ StringPairVector* ProcessProbe::GetMatchingCommands(string pattern, bool isRegex
 #endif
 
 int ProcessProbe::RetrieveCommandLine(const char *process, char *cmdline, string *errMsg) {
-	// Build the absolute path to the command line file
-	string cmdlinePath = "/proc/";
-	cmdlinePath.append(process);
 
 #ifdef LINUX
-	FILE *cmdlineFile = NULL;
-	int i = 0;
-	int bytes = 0;
-
-	cmdlinePath.append("/cmdline");
-
-	// Open the file for reading
-	if((cmdlineFile = fopen(cmdlinePath.c_str(), "r")) == NULL) {
+	const string* snapshotCmdline = ProcessTable::GetCommandLine(process);
+	if(snapshotCmdline == NULL) {
 		errMsg->append("ProcessProbe: Unable to obtain command line for pid: ");
 		errMsg->append(process);
 		return(-1);
-
-	} else {
-    
-		// Read the contents of the file, and convert all of the NULL's
-		// separating the args to spaces.
-		//
-		bytes = fread(cmdline, sizeof(char), CMDLINE_LEN, cmdlineFile);
-	    
-		// Remember to leave the trailing NULL (bytes - 1).
-		for(i = 0; i < bytes - 1; i++) {
-			if(cmdline[i] == '\0') {
-				cmdline[i] = ' ';
-			}
-		}
-		//Clean up excess trailing spaces
-		string cmdlinestr = cmdline;
-		Common::TrimEnd(cmdlinestr);
-		strcpy (cmdline, cmdlinestr.c_str());
 	}
 
-	fclose(cmdlineFile); 
+	strncpy(cmdline, snapshotCmdline->c_str(), CMDLINE_LEN);
+	cmdline[CMDLINE_LEN] = '\0'; // ensure null-termination
 
 #elif defined SUNOS
 
+	// Build the absolute path to the psinfo file
+	string cmdlinePath = "/proc/";
+	cmdlinePath.append(process);
 	cmdlinePath += "/psinfo";
 	psinfo_t info;
 	
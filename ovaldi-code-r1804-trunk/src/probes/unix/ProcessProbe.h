@@ -121,12 +121,6 @@ private:
 	*/
 	void RetrieveTTY(const char *process, char *ttyName);
 
-	/**
-		Read the value contained in '/proc/uptime/' so that we can calculate
-		the start time and exec time of the running processes.
-	*/
-	int RetrieveUptime(unsigned long *uptime, std::string *errMsg);
-
 #endif
 
 #ifdef SUNOS
@@ -48,8 +48,7 @@ RunLevelProbe * RunLevelProbe::_instance = NULL;  // static initialization
 
 
 
-RunLevelProbe::RunLevelProbe( ) {
-  _analyzeRunlevels();
+RunLevelProbe::RunLevelProbe( ) : _runlevels( NULL ) {
 }
 
 
@@ -87,6 +86,7 @@ RunLevelProbe::CollectItems( Object* object ){
                   * runlevel        = object->GetElementByName("runlevel");
     
   _verifyRunlevelObjectAttr( service_name, runlevel ); // throws ProbException
+  _analyzeRunlevels();
   
   collectedItems  = new ItemVector();    
   runlevelSet     = _getRunLevelData( runlevel );
@@ -198,7 +198,7 @@ RunLevelProbe::_getItemEntities( CharSet * runlevelSet, RunLevelItemSet * servic
       
   for( runlevel_iter = runlevelSet->begin(); runlevel_iter != runlevelSet->end(); runlevel_iter++ ){
     char runlevel_chr = (*runlevel_iter);
-    mapSet = _runlevels[ runlevel_chr ];
+    mapSet = (*_runlevels)[ runlevel_chr ];
     for( service_iter = mapSet.begin(); service_iter != mapSet.end(); service_iter++ ){
       runlevel_item rli = (*service_iter);
       if ( services->find( rli ) != services->end() ){
@@ -290,7 +290,7 @@ RunLevelProbe::_getMatchingRunlevels( string pattern, bool isRegex, bool insertU
   CharSet * matches = new CharSet(); 
   SetMap::iterator iter;
 
-  for( iter = _runlevels.begin(); iter != _runlevels.end(); iter++ ){
+  for( iter = _runlevels->begin(); iter != _runlevels->end(); iter++ ){
     char runlevel = (*iter).first;
     const char runlevel_str[] = { runlevel, (char)NULL };
     bool insert = _isInsertable( pattern, runlevel_str, isRegex, insertUnequalNonRegex );
@@ -322,7 +322,7 @@ RunLevelProbe::_getMatchingServiceNames ( string pattern, CharSet * working_runl
     char runlevel = (*runlevel_iter);
     
     // get services for given runlevel
-    SetMap::iterator  map_iter   = _runlevels.find( runlevel );
+    SetMap::iterator  map_iter   = _runlevels->find( runlevel );
     RunLevelItemSet   rlSet      = (*map_iter).second;
 
     for( RunLevelItemSet::iterator iter = rlSet.begin(); iter != rlSet.end(); ++iter ){
@@ -420,7 +420,7 @@ RunLevelProbe::_constructFullPath( const char * path, const char * filename ) co
 
 void
 RunLevelProbe::_populateMap( const char runlevel, const runlevel_item &rli ){
-  RunLevelItemSet &rlSet = _runlevels[ runlevel ];
+  RunLevelItemSet &rlSet = (*_runlevels)[ runlevel ];
   rlSet.insert( rli );
 }
 
@@ -530,9 +530,21 @@ RunLevelProbe::_analyzeRunlevelDir( const char * dir, const char runlevel ){
 void
 RunLevelProbe::_analyzeRunlevels ( ){
   const char runlevelTypes[] = { '0', '1', '2', '3', '4', '5', '6', 'S', 's' };
+  RunLevelSnapshot * snapshot = static_cast<RunLevelSnapshot *>( ConfigSnapshot::Get( RC_DIR ) );
+
+  if( snapshot == NULL ){
+    snapshot    = new RunLevelSnapshot();
+    _runlevels  = &snapshot->runlevels;
 
-  for( unsigned int i = 0; i < sizeof( runlevelTypes ) / sizeof(char); ++i ){
-    string runlevelDir = string(RC_DIR "/rc") + runlevelTypes[i] + ".d";
-    _analyzeRunlevelDir( runlevelDir.c_str(), runlevelTypes[i] );
+    // links added to or removed from a directory change its modification time
+    for( unsigned int i = 0; i < sizeof( runlevelTypes ) / sizeof(char); ++i ){
+      string runlevelDir = string(RC_DIR "/rc") + runlevelTypes[i] + ".d";
+      snapshot->AddSource( runlevelDir );
+      _analyzeRunlevelDir( runlevelDir.c_str(), runlevelTypes[i] );
+    }
+
+    ConfigSnapshot::Put( RC_DIR, snapshot );
   }
+
+  _runlevels = &snapshot->runlevels;
 }
@@ -32,6 +32,7 @@
 #define RUNLEVELPROBE_H
 
 #include "../../AbsProbe.h"
+#include "../../ConfigSnapshot.h"
 
 #include <string>
 #include <set>
@@ -88,6 +89,16 @@ typedef std::set<runlevel_item, ltrunlevel_item_comparator> RunLevelItemSet;
 typedef std::map<const char, RunLevelItemSet> SetMap;
 
 
+/**
+  The runlevel information read from the runlevel directories. It is reused until one of the 
+  directories changes.
+ */
+class RunLevelSnapshot : public ConfigSnapshot {
+  public:
+    SetMap  runlevels;
+};
+
+
 /**
 	Data collector for runlevel test
   The resulting ItemEnities contain information about what services run at what runlevels
@@ -165,7 +176,8 @@ class RunLevelProbe : public AbsProbe {
     void          _analyzeRunlevelDir( const char * dir, const char runlevel ); 
 
     /**
-      Generates a map (_runlevels) of runlevel information for the system.
+      Generates a map (_runlevels) of runlevel information for the system, unless the map generated
+      before is still current.
     */
     void          _analyzeRunlevels();
     
@@ -272,8 +284,8 @@ class RunLevelProbe : public AbsProbe {
   private:  // Private Member Variables 
 	  static RunLevelProbe *  _instance;
 
-    /** Storage container of system runlevel information **/
-    SetMap  _runlevels;   
+    /** Storage container of system runlevel information, owned by the current RunLevelSnapshot **/
+    SetMap * _runlevels;   
 };
 
 #endif
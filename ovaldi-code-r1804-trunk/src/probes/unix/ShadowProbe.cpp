@@ -37,57 +37,6 @@
 
 using namespace std;
 
-namespace {
-	/**
-	 * Used to manage locking/unlocking of password/shadow files in a
-	 * safe way.  Simply stack-allocate an object of this class, and
-	 * the files will be locked.  Unlocking will occur automatically
-	 * when the object goes out of scope.
-	 *
-	 * The outer anonymous namespace makes this class private to this
-	 * compilation unit.
-	 */
-	class ShadowFileGuard {
-		public:
-		ShadowFileGuard();
-		~ShadowFileGuard();
-	};
-
-	ShadowFileGuard::ShadowFileGuard() {
-		// It was never clear to me which of the shadow API functions
-		// set errno values.  The man pages on my dev system don't say any
-		// of them do.  Several web pages I looked at indicated the *_r
-		// variants of the functions set errno but didn't say anything 
-		// about the non _r variants.  So this is coded defensively,
-		// adding extra description text if errno was set, and omitting it
-		// otherwise.
-		errno = 0;
-		if (lckpwdf() == -1) {
-			string msg = "Error locking password files";
-			if (errno != 0)
-				msg += string(": ") + strerror(errno);
-			
-			throw ProbeException(msg);
-		}
-	}
-
-	ShadowFileGuard::~ShadowFileGuard() {
-		// This does not throw an exception if unlocking failed.
-		// You never know if the guard went out of scope due to
-		// another exception being thrown, which you don't want
-		// to mask.  So it just logs a message instead.
-		errno = 0;
-		if (ulckpwdf() == -1) {
-			string msg = "Error unlocking password files";
-			if (errno != 0)
-				msg += string(": ") + strerror(errno);
-			
-			Log::Info(msg);
-		}
-	}
-}
-
-
 ShadowProbe* ShadowProbe::instance = NULL;
 map<string, string> ShadowProbe::dollarEncryptMethodTypes;
 
@@ -111,7 +60,6 @@ Item* ShadowProbe::CreateItem() {
 }
 
 ItemVector* ShadowProbe::CollectItems(Object* object) {
-	ShadowFileGuard guard;
 
 	ObjectEntity* usernameEntity = object->GetElementByName ( "username" );
 	OvalEnum::Operation op = usernameEntity->GetOperation();
@@ -150,20 +98,20 @@ ItemVector* ShadowProbe::CollectItems(Object* object) {
 	return items;
 }
 
-Item *ShadowProbe::CreateItemFromPasswd(const struct spwd *pwInfo) {
+Item *ShadowProbe::CreateItemFromPasswd(const AccountTable::ShadowEntry &pwInfo) {
 	Item *item = this->CreateItem();
 	item->SetStatus(OvalEnum::STATUS_EXISTS);
 	
-	ItemEntity *nameEntity = new ItemEntity("username", pwInfo->sp_namp,
+	ItemEntity *nameEntity = new ItemEntity("username", pwInfo.name,
 											OvalEnum::DATATYPE_STRING);
-	ItemEntity *passwordEntity = new ItemEntity("password", pwInfo->sp_pwdp);
-	ItemEntity *lastChangedEntity = new ItemEntity("chg_lst", Common::ToString(pwInfo->sp_lstchg), OvalEnum::DATATYPE_INTEGER);
-	ItemEntity *changeAllowedEntity = new ItemEntity("chg_allow", Common::ToString(pwInfo->sp_min), OvalEnum::DATATYPE_INTEGER);
-	ItemEntity *changeRequiredEntity = new ItemEntity("chg_req", Common::ToString(pwInfo->sp_max), OvalEnum::DATATYPE_INTEGER);
-	ItemEntity *expirationWarningEntity = new ItemEntity("exp_warn", Common::ToString(pwInfo->sp_warn), OvalEnum::DATATYPE_INTEGER);
-	ItemEntity *accountInactiveEntity = new ItemEntity("exp_inact", Common::ToString(pwInfo->sp_inact), OvalEnum::DATATYPE_INTEGER);
-	ItemEntity *expirationDateEntity = new ItemEntity("exp_date", Common::ToString(pwInfo->sp_expire), OvalEnum::DATATYPE_INTEGER);
-	ItemEntity *flagsEntity = new ItemEntity("flag", Common::ToString(pwInfo->sp_flag));
+	ItemEntity *passwordEntity = new ItemEntity("password", pwInfo.password);
+	ItemEntity *lastChangedEntity = new ItemEntity("chg_lst", Common::ToString(pwInfo.lastChange), OvalEnum::DATATYPE_INTEGER);
+	ItemEntity *changeAllowedEntity = new ItemEntity("chg_allow", Common::ToString(pwInfo.minDays), OvalEnum::DATATYPE_INTEGER);
+	ItemEntity *changeRequiredEntity = new ItemEntity("chg_req", Common::ToString(pwInfo.maxDays), OvalEnum::DATATYPE_INTEGER);
+	ItemEntity *expirationWarningEntity = new ItemEntity("exp_warn", Common::ToString(pwInfo.warnDays), OvalEnum::DATATYPE_INTEGER);
+	ItemEntity *accountInactiveEntity = new ItemEntity("exp_inact", Common::ToString(pwInfo.inactiveDays), OvalEnum::DATATYPE_INTEGER);
+	ItemEntity *expirationDateEntity = new ItemEntity("exp_date", Common::ToString(pwInfo.expireDate), OvalEnum::DATATYPE_INTEGER);
+	ItemEntity *flagsEntity = new ItemEntity("flag", Common::ToString(pwInfo.flag));
 
 	item->AppendElement(nameEntity);
 	item->AppendElement(passwordEntity);
@@ -175,7 +123,7 @@ Item *ShadowProbe::CreateItemFromPasswd(const struct spwd *pwInfo) {
 	item->AppendElement(expirationDateEntity);
 	item->AppendElement(flagsEntity);
 
-	string method = this->FindPasswordEncryptMethod(pwInfo->sp_pwdp);
+	string method = this->FindPasswordEncryptMethod(pwInfo.password);
 	ItemEntity *encryptMethodEntity;
 	if (method.empty()) {
 		item->AppendMessage(new OvalMessage("Couldn't determine password encryption method"));
@@ -213,9 +161,8 @@ string ShadowProbe::FindPasswordEncryptMethod(const string &password) {
 }
 
 Item *ShadowProbe::GetSingleItem(const string& username) {
-	errno = 0;
-	
-	struct spwd *pwInfo = getspnam(username.c_str());
+	int error = 0;
+	const AccountTable::ShadowEntry *pwInfo = AccountTable::FindShadow(username, &error);
 	Item *item;
 
 	if (pwInfo == NULL) {
@@ -223,29 +170,32 @@ Item *ShadowProbe::GetSingleItem(const string& username) {
 		ItemEntity *nameEntity = new ItemEntity("username", username, OvalEnum::DATATYPE_STRING);
 		item->AppendElement(nameEntity);
 
-		if (errno == 0) {
+		if (error == 0) {
 			// for a simple not-found condition, return the dummy item with
 			// appropriate status.
 			item->SetStatus(OvalEnum::STATUS_DOES_NOT_EXIST);
 		} else {
 			// if some other error occurred, set error status and append a message
 			item->SetStatus(OvalEnum::STATUS_ERROR);
-			item->AppendMessage(new OvalMessage(string("Error getting shadow info: ")+strerror(errno),
+			item->AppendMessage(new OvalMessage(string("Error getting shadow info: ")+strerror(error),
 												OvalEnum::LEVEL_ERROR));
 		}
 	} else
-		item = this->CreateItemFromPasswd(pwInfo);
+		item = this->CreateItemFromPasswd(*pwInfo);
 
 	return item;
 }
 
 ItemVector *ShadowProbe::GetMultipleItems(Object *shadowObject) {
-	struct spwd *pwInfo;
+	// the shadow database is only swept once per run, with the password
+	// files locked; this throws if that sweep failed
+	const vector<AccountTable::ShadowEntry> &entries = AccountTable::GetShadowEntries();
 	ItemVector *items = new ItemVector();
 
-	errno = 0;
-	while ((pwInfo = getspent()) != NULL) {
-		Item *item = this->CreateItemFromPasswd(pwInfo);
+	for (vector<AccountTable::ShadowEntry>::const_iterator iter = entries.begin();
+		 iter != entries.end();
+		 ++iter) {
+		Item *item = this->CreateItemFromPasswd(*iter);
 
 		if (shadowObject->Analyze(item))
 			items->push_back(item);
@@ -253,22 +203,6 @@ ItemVector *ShadowProbe::GetMultipleItems(Object *shadowObject) {
 			delete item;
 	}
 
-	endspent();
-
-	if (errno != 0) {
-		// error occurred... delete all items we found and throw
-		// an exception
-		while (!items->empty()) {
-			Item *item = items->back();
-			items->pop_back();
-			delete item;
-		}
-		
-		delete items;
-		throw ProbeException(string("Error getting user info: ")+strerror(errno),
-							 ERROR_WARN);
-	}
-
 	return items;
 }
 
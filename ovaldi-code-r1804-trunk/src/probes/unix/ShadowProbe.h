@@ -33,7 +33,7 @@
 #include "AbsProbe.h"
 #include "Item.h"
 #include "Object.h"
-#include <shadow.h>
+#include "AccountTable.h"
 #include <string>
 #include <map>
 
@@ -60,8 +60,8 @@ class ShadowProbe : public AbsProbe {
 
 	ShadowProbe();
 
-	/** Creates an item from a spwd struct */
-	Item *CreateItemFromPasswd(const struct spwd *pwInfo);
+	/** Creates an item from a shadow password database entry */
+	Item *CreateItemFromPasswd(const AccountTable::ShadowEntry &pwInfo);
 
 	/**
 	 * Attempts to determine the encryption method used on the given
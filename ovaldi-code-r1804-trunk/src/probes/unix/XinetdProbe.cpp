@@ -113,36 +113,13 @@ ItemVector* XinetdProbe::CollectItems(Object* object) {
 	ObjectEntity *nameEntity = object->GetElementByName("service_name");
 	ObjectEntity *protocolEntity = object->GetElementByName("protocol");
 
-	StringVector includeStack; // will allow us to catch circular includes
-	string confFileName = XINETD_CONF_FILENAME;
-	vector<ServiceEntryMap> services;
-	ServiceEntryMap defaults; // will be merged into the individual services
-
-	this->CanonicalizeFileName(confFileName);
-
-	includeStack.push_back(confFileName);
-	this->ProcessConfigFile(confFileName, includeStack, services, 
-							defaults, nameEntity, protocolEntity);
-	includeStack.pop_back();
-
-	//Log::Debug("Done reading config files; now normalizing data...");
-
-	// normalize defaults...
-	this->NormalizeDefaults(defaults);
+	const vector<ServiceEntryMap>& services = this->GetServices();
 
-	// Merge defaults into each service to complete the description.
-	// The xinetd app itself fills in more params automatically, so we
-	// we must simulate that behavior to create accurate service entries.
-	//   As we go, we'll also create our items.
 	ItemVector *items = new ItemVector();
-	for (vector<ServiceEntryMap>::iterator iter = services.begin();
+	for (vector<ServiceEntryMap>::const_iterator iter = services.begin();
 		 iter != services.end();
 		 ++iter) {
 
-		//Log::Debug(string("Normalizing service: ")+(*iter)[NAME_PARAM][0].str());
-		this->MergeDefaultsIntoService(*iter, defaults);
-		this->FillInOtherParams(*iter);
-
 		Item *item = this->Service2Item(*iter, nameEntity, protocolEntity);
 
 		// will be null if the service doesn't match the object.
@@ -153,18 +130,64 @@ ItemVector* XinetdProbe::CollectItems(Object* object) {
 	return items;
 }
 
+const vector<XinetdProbe::ServiceEntryMap>& XinetdProbe::GetServices() {
+
+	ServiceSnapshot *snapshot = static_cast<ServiceSnapshot*>(ConfigSnapshot::Get(XINETD_CONF_FILENAME));
+	if (snapshot != NULL)
+		return snapshot->services;
+
+	snapshot = new ServiceSnapshot();
+	StringVector includeStack; // will allow us to catch circular includes
+	string confFileName = XINETD_CONF_FILENAME;
+	ServiceEntryMap defaults; // will be merged into the individual services
+
+	try {
+		this->CanonicalizeFileName(confFileName);
+
+		includeStack.push_back(confFileName);
+		this->ProcessConfigFile(confFileName, includeStack, snapshot->services, 
+								defaults, *snapshot);
+		includeStack.pop_back();
+
+		//Log::Debug("Done reading config files; now normalizing data...");
+
+		// normalize defaults...
+		this->NormalizeDefaults(defaults);
+
+		// Merge defaults into each service to complete the description.
+		// The xinetd app itself fills in more params automatically, so we
+		// we must simulate that behavior to create accurate service entries.
+		// Ports missing from a service are looked up in the services database.
+		snapshot->AddSource("/etc/services");
+		for (vector<ServiceEntryMap>::iterator iter = snapshot->services.begin();
+			 iter != snapshot->services.end();
+			 ++iter) {
+
+			//Log::Debug(string("Normalizing service: ")+(*iter)[NAME_PARAM][0].str());
+			this->MergeDefaultsIntoService(*iter, defaults);
+			this->FillInOtherParams(*iter);
+		}
+	} catch (...) {
+		delete snapshot;
+		throw;
+	}
+
+	ConfigSnapshot::Put(XINETD_CONF_FILENAME, snapshot);
+	return snapshot->services;
+}
+
 void XinetdProbe::ProcessConfigFile(const string& confFileName, 
 									StringVector& includeStack, 
 									vector<ServiceEntryMap>& services, 
 									ServiceEntryMap& defaults,
-									ObjectEntity* nameEntity,
-									ObjectEntity* protocolEntity) {
+									ConfigSnapshot& snapshot) {
 
 	vector<StringVector> entryMatches;
 	vector<StringVector> includeDirMatches;
 	StringVector includeMatch;
 	string confFileContents;
 
+	snapshot.AddSource(confFileName);
 	this->ReadFileToString(confFileName, confFileContents);
 
 	// Look for an "include" line.  That tells us to ignore this file and parse the
@@ -194,7 +217,7 @@ void XinetdProbe::ProcessConfigFile(const string& confFileName,
 
 			includeStack.push_back(includeFileName);
 			this->ProcessConfigFile(includeFileName, includeStack, services, defaults, 
-									nameEntity, protocolEntity);
+									snapshot);
 			includeStack.pop_back();
 			return;
 		} else
@@ -214,7 +237,7 @@ void XinetdProbe::ProcessConfigFile(const string& confFileName,
 		Common::TrimString(dir);
 		this->CanonicalizeFileName(dir);
 		Log::Debug(string("Including directory ")+dir);
-		this->ProcessIncludeDir(dir, includeStack, services, defaults, nameEntity, protocolEntity);
+		this->ProcessIncludeDir(dir, includeStack, services, defaults, snapshot);
 	}
 
 	// Matches all services.  The extra newline before the close brace
@@ -259,7 +282,8 @@ void XinetdProbe::ProcessConfigFile(const string& confFileName,
 		} else
 			services.push_back(entryMap);
 
-		Log::Debug(string("Found ")+(isDefaultsEntry ? "defaults":"service") + " entry: "+entryName);
+		if(Log::IsDebug())
+			Log::Debug(string("Found ")+(isDefaultsEntry ? "defaults":"service") + " entry: "+entryName);
 	}
 }
 
@@ -267,13 +291,15 @@ void XinetdProbe::ProcessIncludeDir(const string& includeDir,
 									StringVector& includeStack, 
 									vector<ServiceEntryMap>& services, 
 									ServiceEntryMap& defaults,
-									ObjectEntity* nameEntity,
-									ObjectEntity* protocolEntity) {
+									ConfigSnapshot& snapshot) {
 
 	DIR *dir;
 	struct dirent *ent;
 	StringVector fileNamesToProcess;
 
+	// files added to or removed from the directory change its modification time
+	snapshot.AddSource(includeDir);
+
 	errno = 0;
 	dir = opendir(includeDir.c_str());
 	if (dir==NULL)
@@ -337,7 +363,7 @@ void XinetdProbe::ProcessIncludeDir(const string& includeDir,
 		Log::Debug(string("Including (via includedir) ")+*iter);
 
 		includeStack.push_back(*iter);
-		this->ProcessConfigFile(*iter, includeStack, services, defaults, nameEntity, protocolEntity);
+		this->ProcessConfigFile(*iter, includeStack, services, defaults, snapshot);
 		includeStack.pop_back();
 	}
 }
@@ -36,6 +36,7 @@
 
 #include <AbsProbe.h>
 #include <Common.h>
+#include <ConfigSnapshot.h>
 #include <Item.h>
 #include <Object.h>
 #include <ObjectEntity.h>
@@ -60,6 +61,10 @@ class XinetdParam;
  * In particular, no parameter is cumulative, all params support all operators,
  * all params may have multiple values, and all param values are treated as 
  * simple strings.
+ * <p>
+ * The config files are parsed once into a snapshot of fully normalized services,
+ * which is reused for every object until one of the files or included directories
+ * changes.
  */
 class XinetdProbe : public AbsProbe {
 
@@ -78,20 +83,32 @@ class XinetdProbe : public AbsProbe {
 	/** Type representing a service configuration entry. */
 	typedef std::map<std::string, std::vector<XinetdParam> > ServiceEntryMap;
 
+	/** The normalized services read from the config files. */
+	class ServiceSnapshot : public ConfigSnapshot {
+		public:
+		std::vector<ServiceEntryMap> services;
+	};
+
 	XinetdProbe();
 
+	/**
+	 * Returns the services described by the config files, reading and normalizing
+	 * them if they have not been read yet or have changed since.
+	 */
+	const std::vector<ServiceEntryMap>& GetServices();
+
 	/**
 	 * Processes the given xinetd config file.  Information about
 	 * services contained therein are stored in the 'services' param.
 	 * The defaults section is stored separately, in the given
-	 * 'defaults' param.
+	 * 'defaults' param.  The file, and any file or directory it includes, 
+	 * is added as a source of the given snapshot.
 	 */
 	void ProcessConfigFile(const std::string& confFileName, 
 						   StringVector& includeStack, 
 						   std::vector<ServiceEntryMap>& services, 
 						   ServiceEntryMap& defaults,
-						   ObjectEntity* nameEntity,
-						   ObjectEntity* protocolEntity);
+						   ConfigSnapshot& snapshot);
 
 	/**
 	 * Processes the given directory of config files.  Information
@@ -105,8 +122,7 @@ class XinetdProbe : public AbsProbe {
 						   StringVector& includeStack,
 						   std::vector<ServiceEntryMap>& services,
 						   ServiceEntryMap& defaults,
-						   ObjectEntity* nameEntity,
-						   ObjectEntity* protocolEntity);
+						   ConfigSnapshot& snapshot);
 
 	/**
 	 * Given a chunk of text containing the innards of a service description
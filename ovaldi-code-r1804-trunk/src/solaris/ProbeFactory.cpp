@@ -57,6 +57,8 @@
 // SOLARIS PORT NOTICE: Add other probes here to support collection of solaris specific objects.
 #include "IsainfoProbe.h"
 #include "Patch54Probe.h"
+#include "AccountTable.h"
+#include "TimedFileOps.h"
 
 #include "ProbeFactory.h"
 
@@ -154,4 +156,10 @@ void ProbeFactory::Shutdown() {
     delete (*iter);  // the probe better set it's instance pointer to NULL inside of its destructor
     _probes.erase( iter++ );
   }
+
+  // the account snapshot is shared by the probes as well
+  AccountTable::Clear();
+
+  // no more file system calls will be made
+  TimedFileOps::Shutdown();
 }
@@ -0,0 +1,313 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#include <sys/types.h>
+#include <pwd.h>
+#ifndef DARWIN
+#  include <shadow.h>
+#endif
+#include <cerrno>
+#include <cstring>
+
+#include "AbsProbe.h"
+#include "Common.h"
+#include "Log.h"
+
+#include "AccountTable.h"
+
+using namespace std;
+
+namespace {
+
+	/** Return the specified string, or "" if it is NULL. */
+	string ToString(const char *value) {
+		return (value == NULL) ? "" : value;
+	}
+
+	void CopyPasswd(const struct passwd *pwInfo, AccountTable::PasswdEntry *entry) {
+		entry->name = ToString(pwInfo->pw_name);
+		entry->password = ToString(pwInfo->pw_passwd);
+		entry->uid = pwInfo->pw_uid;
+		entry->gid = pwInfo->pw_gid;
+		entry->gecos = ToString(pwInfo->pw_gecos);
+		entry->homeDir = ToString(pwInfo->pw_dir);
+		entry->shell = ToString(pwInfo->pw_shell);
+	}
+
+#ifndef DARWIN
+	void CopyShadow(const struct spwd *spInfo, AccountTable::ShadowEntry *entry) {
+		entry->name = ToString(spInfo->sp_namp);
+		entry->password = ToString(spInfo->sp_pwdp);
+		entry->lastChange = spInfo->sp_lstchg;
+		entry->minDays = spInfo->sp_min;
+		entry->maxDays = spInfo->sp_max;
+		entry->warnDays = spInfo->sp_warn;
+		entry->inactiveDays = spInfo->sp_inact;
+		entry->expireDate = spInfo->sp_expire;
+		entry->flag = spInfo->sp_flag;
+	}
+
+	/**
+	 * Used to manage locking/unlocking of password/shadow files in a
+	 * safe way.  Simply stack-allocate an object of this class, and
+	 * the files will be locked.  Unlocking will occur automatically
+	 * when the object goes out of scope.
+	 *
+	 * The outer anonymous namespace makes this class private to this
+	 * compilation unit.
+	 */
+	class ShadowFileGuard {
+		public:
+		ShadowFileGuard();
+		~ShadowFileGuard();
+	};
+
+	ShadowFileGuard::ShadowFileGuard() {
+		// It was never clear to me which of the shadow API functions
+		// set errno values.  The man pages on my dev system don't say any
+		// of them do.  Several web pages I looked at indicated the *_r
+		// variants of the functions set errno but didn't say anything 
+		// about the non _r variants.  So this is coded defensively,
+		// adding extra description text if errno was set, and omitting it
+		// otherwise.
+		errno = 0;
+		if (lckpwdf() == -1) {
+			string msg = "Error locking password files";
+			if (errno != 0)
+				msg += string(": ") + strerror(errno);
+			
+			throw ProbeException(msg);
+		}
+	}
+
+	ShadowFileGuard::~ShadowFileGuard() {
+		// This does not throw an exception if unlocking failed.
+		// You never know if the guard went out of scope due to
+		// another exception being thrown, which you don't want
+		// to mask.  So it just logs a message instead.
+		errno = 0;
+		if (ulckpwdf() == -1) {
+			string msg = "Error unlocking password files";
+			if (errno != 0)
+				msg += string(": ") + strerror(errno);
+			
+			Log::Info(msg);
+		}
+	}
+#endif
+}
+
+//****************************************************************************************//
+//								AccountTable Class										  //	
+//****************************************************************************************//
+bool AccountTable::passwdRead = false;
+string AccountTable::passwdError;
+vector<AccountTable::PasswdEntry> AccountTable::passwdEntries;
+map<string, AccountTable::PasswdEntry> AccountTable::passwdByName;
+set<string> AccountTable::missingUserNames;
+
+#ifndef DARWIN
+bool AccountTable::shadowRead = false;
+string AccountTable::shadowError;
+vector<AccountTable::ShadowEntry> AccountTable::shadowEntries;
+map<string, AccountTable::ShadowEntry> AccountTable::shadowByName;
+set<string> AccountTable::missingShadowNames;
+#endif
+
+unsigned long AccountTable::lookupHits = 0;
+unsigned long AccountTable::lookupMisses = 0;
+
+const vector<AccountTable::PasswdEntry>& AccountTable::GetPasswdEntries() {
+
+	AccountTable::ReadPasswd();
+	if(!AccountTable::passwdError.empty())
+		throw ProbeException(AccountTable::passwdError, ERROR_WARN);
+
+	return AccountTable::passwdEntries;
+}
+
+const AccountTable::PasswdEntry* AccountTable::FindPasswd(const string &name, int *error) {
+
+	*error = 0;
+
+	map<string, PasswdEntry>::iterator iterator = AccountTable::passwdByName.find(name);
+	if(iterator != AccountTable::passwdByName.end()) {
+		AccountTable::lookupHits++;
+		return &iterator->second;
+	}
+	if(AccountTable::missingUserNames.find(name) != AccountTable::missingUserNames.end()) {
+		AccountTable::lookupHits++;
+		return NULL;
+	}
+
+	AccountTable::lookupMisses++;
+
+	errno = 0;
+	struct passwd *pwInfo = getpwnam(name.c_str());
+	if(pwInfo == NULL) {
+		// only a clean "not found" is remembered, errors may be transient
+		if(errno == 0)
+			AccountTable::missingUserNames.insert(name);
+		else
+			*error = errno;
+		return NULL;
+	}
+
+	PasswdEntry entry;
+	CopyPasswd(pwInfo, &entry);
+	return &AccountTable::passwdByName.insert(make_pair(name, entry)).first->second;
+}
+
+#ifndef DARWIN
+const vector<AccountTable::ShadowEntry>& AccountTable::GetShadowEntries() {
+
+	AccountTable::ReadShadow();
+	if(!AccountTable::shadowError.empty())
+		throw ProbeException(AccountTable::shadowError, ERROR_WARN);
+
+	return AccountTable::shadowEntries;
+}
+
+const AccountTable::ShadowEntry* AccountTable::FindShadow(const string &name, int *error) {
+
+	*error = 0;
+
+	map<string, ShadowEntry>::iterator iterator = AccountTable::shadowByName.find(name);
+	if(iterator != AccountTable::shadowByName.end()) {
+		AccountTable::lookupHits++;
+		return &iterator->second;
+	}
+	if(AccountTable::missingShadowNames.find(name) != AccountTable::missingShadowNames.end()) {
+		AccountTable::lookupHits++;
+		return NULL;
+	}
+
+	AccountTable::lookupMisses++;
+
+	ShadowFileGuard guard;
+
+	errno = 0;
+	struct spwd *spInfo = getspnam(name.c_str());
+	if(spInfo == NULL) {
+		if(errno == 0)
+			AccountTable::missingShadowNames.insert(name);
+		else
+			*error = errno;
+		return NULL;
+	}
+
+	ShadowEntry entry;
+	CopyShadow(spInfo, &entry);
+	return &AccountTable::shadowByName.insert(make_pair(name, entry)).first->second;
+}
+#endif
+
+void AccountTable::Clear() {
+
+	if(AccountTable::lookupHits > 0 || AccountTable::lookupMisses > 0)
+		Log::Debug("Account lookups: " + Common::ToString(AccountTable::lookupHits) + " answered from memory, " + 
+				   Common::ToString(AccountTable::lookupMisses) + " passed to the name service.");
+	AccountTable::lookupHits = 0;
+	AccountTable::lookupMisses = 0;
+
+	AccountTable::passwdRead = false;
+	AccountTable::passwdError = "";
+	AccountTable::passwdEntries.clear();
+	AccountTable::passwdByName.clear();
+	AccountTable::missingUserNames.clear();
+
+#ifndef DARWIN
+	AccountTable::shadowRead = false;
+	AccountTable::shadowError = "";
+	AccountTable::shadowEntries.clear();
+	AccountTable::shadowByName.clear();
+	AccountTable::missingShadowNames.clear();
+#endif
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  Private Members  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+void AccountTable::ReadPasswd() {
+
+	if(AccountTable::passwdRead)
+		return;
+
+	struct passwd *pwInfo;
+
+	setpwent();
+	errno = 0;
+	while((pwInfo = getpwent()) != NULL) {
+		PasswdEntry entry;
+		CopyPasswd(pwInfo, &entry);
+		AccountTable::passwdEntries.push_back(entry);
+
+		// the first entry for a name is the one getpwnam() would find
+		AccountTable::passwdByName.insert(make_pair(entry.name, entry));
+	}
+	int error = errno;
+	endpwent();
+
+	if(error != 0) {
+		AccountTable::passwdEntries.clear();
+		AccountTable::passwdError = string("Error getting user info: ") + strerror(error);
+	}
+
+	AccountTable::passwdRead = true;
+}
+
+#ifndef DARWIN
+void AccountTable::ReadShadow() {
+
+	if(AccountTable::shadowRead)
+		return;
+
+	ShadowFileGuard guard;
+	struct spwd *spInfo;
+
+	setspent();
+	errno = 0;
+	while((spInfo = getspent()) != NULL) {
+		ShadowEntry entry;
+		CopyShadow(spInfo, &entry);
+		AccountTable::shadowEntries.push_back(entry);
+		AccountTable::shadowByName.insert(make_pair(entry.name, entry));
+	}
+	int error = errno;
+	endspent();
+
+	if(error != 0) {
+		AccountTable::shadowEntries.clear();
+		AccountTable::shadowError = string("Error getting user info: ") + strerror(error);
+	}
+
+	AccountTable::shadowRead = true;
+}
+#endif
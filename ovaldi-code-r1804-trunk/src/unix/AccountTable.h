@@ -0,0 +1,134 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifndef ACCOUNTTABLE_H
+#define ACCOUNTTABLE_H
+
+#include <sys/types.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+	This class holds a snapshot of the user and shadow password databases for the duration 
+	of a run, for the password and shadow probes. The databases are read through the name 
+	service switch, so accounts served by LDAP or SSSD are included just as they would be by 
+	getpwent() and getspent(). Each database is swept at most once per run.
+
+	Lookups by name consult the snapshot first. Accounts a name service does not enumerate 
+	can still be found by name, so a lookup that misses falls back to getpwnam() or getspnam() 
+	once, and its answer, including "no such account", is remembered for the rest of the run. 
+	The number of lookups answered from memory is logged when the snapshot is cleared.
+
+	The snapshot must be cleared when collection completes.
+*/
+class AccountTable {
+public:
+
+	/** An entry in the user database. */
+	struct PasswdEntry {
+		std::string name;
+		std::string password;
+		uid_t uid;
+		gid_t gid;
+		std::string gecos;
+		std::string homeDir;
+		std::string shell;
+	};
+
+	/** An entry in the shadow password database. */
+	struct ShadowEntry {
+		std::string name;
+		std::string password;
+		long lastChange;
+		long minDays;
+		long maxDays;
+		long warnDays;
+		long inactiveDays;
+		long expireDate;
+		unsigned long flag;
+	};
+
+	/** Return every entry in the user database, in the order they are enumerated. 
+		A ProbeException is thrown if the database could not be read.
+	*/
+	static const std::vector<PasswdEntry>& GetPasswdEntries();
+
+	/** Look up a user by name. If there is no such user NULL is returned and error is set to 0. 
+		If the lookup fails NULL is returned and error is set to the errno value.
+	*/
+	static const PasswdEntry* FindPasswd(const std::string &name, int *error);
+
+#ifndef DARWIN
+	/** Return every entry in the shadow password database, in the order they are enumerated. 
+		The password files are locked while they are read. A ProbeException is thrown if the 
+		files could not be locked or the database could not be read.
+	*/
+	static const std::vector<ShadowEntry>& GetShadowEntries();
+
+	/** Look up a shadow password entry by user name, as for FindPasswd(const std::string&, int*). 
+		A ProbeException is thrown if the password files could not be locked.
+	*/
+	static const ShadowEntry* FindShadow(const std::string &name, int *error);
+#endif
+
+	/** Discard the snapshot. The lookup counts are logged and reset. */
+	static void Clear();
+
+private:
+
+	/** Sweep the user database, if it has not been swept yet. */
+	static void ReadPasswd();
+
+#ifndef DARWIN
+	/** Sweep the shadow password database, if it has not been swept yet. */
+	static void ReadShadow();
+#endif
+
+	static bool passwdRead;
+	static std::string passwdError;
+	static std::vector<PasswdEntry> passwdEntries;
+	static std::map<std::string, PasswdEntry> passwdByName;
+	static std::set<std::string> missingUserNames;
+
+#ifndef DARWIN
+	static bool shadowRead;
+	static std::string shadowError;
+	static std::vector<ShadowEntry> shadowEntries;
+	static std::map<std::string, ShadowEntry> shadowByName;
+	static std::set<std::string> missingShadowNames;
+#endif
+
+	static unsigned long lookupHits;
+	static unsigned long lookupMisses;
+};
+
+#endif
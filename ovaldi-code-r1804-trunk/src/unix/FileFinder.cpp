@@ -38,9 +38,9 @@
 #include <cerrno>
 #include <memory>
 
-#include <DirGuard.h>
 #include <EntityComparator.h>
 #include <Log.h>
+#include <TimedFileOps.h>
 
 #include "FileFinder.h"
 
@@ -205,11 +205,10 @@ void FileFinder::GetPathsForOperation(string dirIn, string queryVal, StringVecto
 	try {
 
 		struct stat statbuf;
-		struct dirent *dirp;
 		string tmp;
 
 		//	Call stat 
-		if(lstat(dirIn.c_str(), &statbuf) < 0) {
+		if(TimedFileOps::Lstat(dirIn, &statbuf) < 0) {
 			return; 
 		}
 
@@ -220,36 +219,24 @@ void FileFinder::GetPathsForOperation(string dirIn, string queryVal, StringVecto
 			if (EntityComparator::CompareString(op, queryVal, dirIn) == OvalEnum::RESULT_TRUE)
 				pathVector->push_back(dirIn);
 
-			//	Open the directory
-			DirGuard dp(dirIn, false);
-
-			if(dp.isClosed()) {
-				//	Error opening directory
+			//	Read the directory
+			StringVector names;
+			if(TimedFileOps::ReadDir(dirIn, &names) < 0) {
+				//	Error reading directory
 				//	not sure this error matters
-				// cout << "Failed to open the directory" << endl;
+				// cout << "Failed to read the directory" << endl;
 				return;
 			}
 
 			//	Loop through all names in the directory and make recursive call
-			while((dirp = readdir(dp)) != NULL) {
-				//	Ignore dot and dot-dot
-				if(strcmp(dirp->d_name, ".") == 0 || strcmp(dirp->d_name, "..") == 0)
-					continue;
+			for(StringVector::iterator name = names.begin(); name != names.end(); name++) {
 
 				//	append the name
-				tmp = Common::BuildFilePath(dirIn, dirp->d_name);
+				tmp = Common::BuildFilePath(dirIn, *name);
 
 				// Nake recursive call
 				GetPathsForOperation(tmp, queryVal, pathVector, op);
 			}
-
-			//	Close the directory
-			if(dp.close() < 0) {
-				//	Error closing the directory
-				//	not sure this error matters
-				// cout << "Failed to close the directory" << endl;
-				return;
-			}
 		}
 
 	//	Just need to ensure that all exceptions have a nice message. 
@@ -283,25 +270,25 @@ void FileFinder::GetFilesForOperation(string path, string queryVal, StringVector
 
 	try {
 
-		//	Open the directory
-		DirGuard dp(path, false);
-		if(dp.isClosed()) {
+		//	Read the directory
+		StringVector names;
+		if(TimedFileOps::ReadDir(path, &names) < 0) {
+			//	A directory that could not be read in time is recorded as a timeout,
+			//	the object is reported as incomplete rather than in error
+			if(errno == ETIMEDOUT)
+				return;
 			string errorMessage = "Error opening directory " + path + ": " +
 				strerror(errno);
 			throw FileFinderException(errorMessage);
 		}
 
 		//	Loop through all names in the directory
-		struct dirent *dirp;
-		while((dirp = readdir(dp)) != NULL) {
-			//	Ignore dot and dot-dot
-			if(strcmp(dirp->d_name, ".") == 0 || strcmp(dirp->d_name, "..") == 0)
-				continue;
+		for(StringVector::iterator name = names.begin(); name != names.end(); name++) {
 
 			//	Call stat 
 			struct stat statbuf;
-			string filepath = Common::BuildFilePath(path, dirp->d_name);
-			if(lstat(filepath.c_str(), &statbuf) < 0) {
+			string filepath = Common::BuildFilePath(path, *name);
+			if(TimedFileOps::Lstat(filepath, &statbuf) < 0) {
 				continue;
 			}
 
@@ -311,8 +298,8 @@ void FileFinder::GetFilesForOperation(string path, string queryVal, StringVector
 					if (EntityComparator::CompareString(op, queryVal, filepath) == OvalEnum::RESULT_TRUE)
 						fileNames->push_back(filepath);
 				} else {
-					if (EntityComparator::CompareString(op, queryVal, dirp->d_name) == OvalEnum::RESULT_TRUE)
-						fileNames->push_back(dirp->d_name);
+					if (EntityComparator::CompareString(op, queryVal, *name) == OvalEnum::RESULT_TRUE)
+						fileNames->push_back(*name);
 				}
 			}
 		}
@@ -349,7 +336,7 @@ bool FileFinder::PathExists(const string &path, string *actualPath) {
 
 	struct stat st;
 
-	bool exists = lstat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+	bool exists = TimedFileOps::Lstat(path, &st) == 0 && S_ISDIR(st.st_mode);
 	if (exists && actualPath != NULL)
 		*actualPath = Common::StripTrailingSeparators(path);
 	return exists;
@@ -393,7 +380,7 @@ bool FileFinder::FileNameExists(string path, string fileName,
 	//	Call stat 
 	struct stat statbuf;
 	string filepath = Common::BuildFilePath(path, fileName);
-	if(lstat(filepath.c_str(), &statbuf) == 0 && !S_ISDIR(statbuf.st_mode)) {
+	if(TimedFileOps::Lstat(filepath, &statbuf) == 0 && !S_ISDIR(statbuf.st_mode)) {
 		exists = true;
 		if (actualFileName)
 			*actualFileName = fileName;
@@ -416,30 +403,25 @@ StringVector* FileFinder::GetChildDirectories(string path) {
 	try {
 
 		struct stat statbuf;
-		struct dirent *dirp;
-		DirGuard dp(path, false);
+		StringVector names;
 
-		if(dp.isClosed()) {
-			if (errno == ENOENT)
+		if(TimedFileOps::ReadDir(path, &names) < 0) {
+			// timeouts are recorded and reported on the object
+			if (errno == ENOENT || errno == ETIMEDOUT)
 				return childDirs.release();
-			throw FileFinderException("Couldn't open directory " + path +
+			throw FileFinderException("Couldn't read directory " + path +
 									  ": " + strerror(errno));
 		}
 
 		//	Loop through all names in the directory and make recursive call
-		errno = 0;
-		while((dirp = readdir(dp)) != NULL) {
-			//	Ignore dot and dot-dot
-			if(strcmp(dirp->d_name, ".") == 0 || strcmp(dirp->d_name, "..") == 0)
-				continue;
+		for(StringVector::iterator name = names.begin(); name != names.end(); name++) {
 
-			string filePath = Common::BuildFilePath(path, dirp->d_name);
+			string filePath = Common::BuildFilePath(path, *name);
 			//	Call stat
-			if(stat(filePath.c_str(), &statbuf) < 0) {
-				if (errno == ENOENT) {
-					// shouldn't happen if readdir() just returned it, but
-					// just in case...
-					errno = 0;
+			if(TimedFileOps::Stat(filePath, &statbuf) < 0) {
+				if (errno == ENOENT || errno == ETIMEDOUT) {
+					// ENOENT shouldn't happen if the directory was just
+					// read, but just in case...
 					continue;
 				}
 
@@ -449,13 +431,8 @@ StringVector* FileFinder::GetChildDirectories(string path) {
 
 			if (S_ISDIR(statbuf.st_mode))
 				childDirs->push_back(filePath);
-
-			errno = 0;
 		}
 
-		if (errno)
-			throw FileFinderException("readdir("+path+"): "+strerror(errno));
-
 		//	Just need to ensure that all exceptions have a nice message. 
 		//	So rethrow the exceptions I created catch the others and format them.
 	} catch(Exception ex) {
@@ -498,22 +475,19 @@ namespace {
 				   pathToCompare[nextPathCompIdx] == Common::fileSeperator)
 				++nextPathCompIdx;
 
-		dirent *dirp;
 		struct stat st;
-		DirGuard dir(currPath, false);
+		StringVector names;
 
-		// ignore dir open error.
-		if (dir.isClosed())
+		// ignore dir read error.
+		if (TimedFileOps::ReadDir(currPath, &names) < 0)
 			return;
 
-		while((dirp = readdir(dir)) != NULL) {
-			if (!strcmp(dirp->d_name, ".") || !strcmp(dirp->d_name, ".."))
-				continue;
+		for (StringVector::iterator name = names.begin(); name != names.end(); ++name) {
 
-			if (Common::EqualsIgnoreCase(dirp->d_name, pathComp)) {
+			if (Common::EqualsIgnoreCase(*name, pathComp)) {
 				// ignore non-directories and stat() errors
-				string tmpPath = Common::BuildFilePath(currPath, dirp->d_name);
-				if (lstat(tmpPath.c_str(), &st) == -1 || !S_ISDIR(st.st_mode))
+				string tmpPath = Common::BuildFilePath(currPath, *name);
+				if (TimedFileOps::Lstat(tmpPath, &st) == -1 || !S_ISDIR(st.st_mode))
 					continue;
 
 				if (nextSepIdx == string::npos ||
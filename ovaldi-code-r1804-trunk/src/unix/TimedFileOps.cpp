@@ -0,0 +1,551 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef LINUX
+#  include <acl/libacl.h>
+#endif
+
+#include "Common.h"
+#include "CollectionDeadline.h"
+#include "Instrumentation.h"
+#include "Log.h"
+
+#include "TimedFileOps.h"
+
+using namespace std;
+
+namespace {
+
+	/** The names of the calls, indexed by operation, for messages. */
+	const char *OPERATION_NAMES[] = {
+		"lstat",
+		"stat",
+		"readdir",
+		"statfs64",
+		"acl_extended_file"
+	};
+
+	/** Sent to the helper ahead of the path. */
+	struct RequestHeader {
+		int op;
+		size_t pathLength;
+	};
+
+	/** Sent back by the helper ahead of the call's output. */
+	struct ResponseHeader {
+		int result;
+		int error;
+		size_t resultLength;
+	};
+
+	enum ReadStatus {
+		READ_OK,
+		READ_TIMED_OUT,
+		READ_FAILED
+	};
+
+	bool WriteFully(int fd, const void *buf, size_t len) {
+		const char *p = (const char*)buf;
+		while(len > 0) {
+			ssize_t n = write(fd, p, len);
+			if(n < 0) {
+				if(errno == EINTR)
+					continue;
+				return false;
+			}
+			p += n;
+			len -= n;
+		}
+		return true;
+	}
+
+	/** 
+		Send a request to the helper. SIGPIPE is blocked while writing, so a helper that has 
+		just been killed makes the write fail with EPIPE rather than take the interpreter down. 
+		It is only blocked here, so the commands the probes run still get the default action.
+	*/
+	bool WriteRequest(int fd, const RequestHeader &request, const string &path) {
+		sigset_t pipeSignal;
+		sigset_t oldMask;
+		sigset_t pending;
+		sigemptyset(&pipeSignal);
+		sigaddset(&pipeSignal, SIGPIPE);
+
+		sigpending(&pending);
+		bool alreadyPending = sigismember(&pending, SIGPIPE) == 1;
+		sigprocmask(SIG_BLOCK, &pipeSignal, &oldMask);
+
+		bool written = WriteFully(fd, &request, sizeof(request)) && WriteFully(fd, path.data(), path.length());
+		int error = errno;
+
+		// take back the signal the failed write raised before unblocking it
+		if(!written && error == EPIPE && !alreadyPending) {
+			sigpending(&pending);
+			int received = 0;
+			if(sigismember(&pending, SIGPIPE) == 1)
+				sigwait(&pipeSignal, &received);
+		}
+
+		sigprocmask(SIG_SETMASK, &oldMask, NULL);
+		errno = error;
+		return written;
+	}
+
+	/** Read len bytes, giving up on end of file or an error. */
+	bool ReadFully(int fd, void *buf, size_t len) {
+		char *p = (char*)buf;
+		while(len > 0) {
+			ssize_t n = read(fd, p, len);
+			if(n < 0) {
+				if(errno == EINTR)
+					continue;
+				return false;
+			} else if(n == 0) {
+				return false;
+			}
+			p += n;
+			len -= n;
+		}
+		return true;
+	}
+
+	/** Read len bytes, giving up if they have not all arrived by the specified time. */
+	ReadStatus ReadWithin(int fd, void *buf, size_t len, unsigned long long deadline) {
+		char *p = (char*)buf;
+		while(len > 0) {
+			unsigned long long now = CollectionDeadline::Now();
+			if(now >= deadline)
+				return READ_TIMED_OUT;
+
+			struct pollfd pfd;
+			pfd.fd = fd;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+			int ready = poll(&pfd, 1, (int)(deadline - now));
+			if(ready < 0) {
+				if(errno == EINTR)
+					continue;
+				return READ_FAILED;
+			} else if(ready == 0) {
+				continue;
+			}
+
+			ssize_t n = read(fd, p, len);
+			if(n < 0) {
+				if(errno == EINTR)
+					continue;
+				return READ_FAILED;
+			} else if(n == 0) {
+				return READ_FAILED;
+			}
+			p += n;
+			len -= n;
+		}
+		return READ_OK;
+	}
+}
+
+//****************************************************************************************//
+//								TimedFileOps Class										  //	
+//****************************************************************************************//
+pid_t TimedFileOps::helperPid = -1;
+int TimedFileOps::requestFd = -1;
+int TimedFileOps::responseFd = -1;
+vector<pid_t> TimedFileOps::abandonedHelpers;
+
+int TimedFileOps::Lstat(const string &path, struct stat *buf) {
+
+	Instrumentation::RecordFileSystemCall();
+
+	if(CollectionDeadline::GetCallBudget() < 0)
+		return lstat(path.c_str(), buf);
+
+	string result;
+	int ret = TimedFileOps::Call(OP_LSTAT, path, &result);
+	if(ret == 0)
+		memcpy(buf, result.data(), sizeof(struct stat));
+	return ret;
+}
+
+int TimedFileOps::Stat(const string &path, struct stat *buf) {
+
+	Instrumentation::RecordFileSystemCall();
+
+	if(CollectionDeadline::GetCallBudget() < 0)
+		return stat(path.c_str(), buf);
+
+	string result;
+	int ret = TimedFileOps::Call(OP_STAT, path, &result);
+	if(ret == 0)
+		memcpy(buf, result.data(), sizeof(struct stat));
+	return ret;
+}
+
+int TimedFileOps::ReadDir(const string &path, StringVector *names) {
+
+	Instrumentation::RecordFileSystemCall();
+
+	string result;
+	int ret = TimedFileOps::Call(OP_READDIR, path, &result);
+	if(ret != 0)
+		return ret;
+
+	// the names come back separated by nul characters
+	string::size_type start = 0;
+	while(start < result.length()) {
+		string::size_type end = result.find('\0', start);
+		if(end == string::npos)
+			end = result.length();
+		names->push_back(result.substr(start, end - start));
+		start = end + 1;
+	}
+
+	return 0;
+}
+
+#ifdef LINUX
+int TimedFileOps::Statfs64(const string &path, struct statfs64 *buf) {
+
+	Instrumentation::RecordFileSystemCall();
+
+	if(CollectionDeadline::GetCallBudget() < 0)
+		return statfs64(path.c_str(), buf);
+
+	string result;
+	int ret = TimedFileOps::Call(OP_STATFS64, path, &result);
+	if(ret == 0)
+		memcpy(buf, result.data(), sizeof(struct statfs64));
+	return ret;
+}
+
+int TimedFileOps::AclExtendedFile(const string &path) {
+
+	Instrumentation::RecordFileSystemCall();
+
+	if(CollectionDeadline::GetCallBudget() < 0)
+		return acl_extended_file(path.c_str());
+
+	string result;
+	return TimedFileOps::Call(OP_ACL_EXTENDED_FILE, path, &result);
+}
+#endif
+
+void TimedFileOps::Shutdown() {
+
+	// an idle helper exits as soon as its request pipe is closed
+	if(TimedFileOps::helperPid != -1) {
+		close(TimedFileOps::requestFd);
+		close(TimedFileOps::responseFd);
+		while(waitpid(TimedFileOps::helperPid, NULL, 0) < 0 && errno == EINTR)
+			;
+		TimedFileOps::helperPid = -1;
+		TimedFileOps::requestFd = -1;
+		TimedFileOps::responseFd = -1;
+	}
+
+	TimedFileOps::ReapHelpers();
+}
+
+void TimedFileOps::ForgetHelper() {
+
+	// the helper and any abandoned ones belong to the parent, which waits for them
+	if(TimedFileOps::helperPid != -1) {
+		close(TimedFileOps::requestFd);
+		close(TimedFileOps::responseFd);
+		TimedFileOps::helperPid = -1;
+		TimedFileOps::requestFd = -1;
+		TimedFileOps::responseFd = -1;
+	}
+
+	TimedFileOps::abandonedHelpers.clear();
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  Private Members  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+int TimedFileOps::Call(Operation op, const string &path, string *result) {
+
+	result->clear();
+
+	int error = 0;
+	int budget = CollectionDeadline::GetCallBudget();
+	if(budget < 0) {
+		int ret = TimedFileOps::Perform(op, path, result, &error);
+		errno = error;
+		return ret;
+	}
+
+	string call = string(OPERATION_NAMES[op]) + "(" + path + ")";
+	if(budget == 0) {
+		CollectionDeadline::RecordTimeout(call);
+		errno = ETIMEDOUT;
+		return -1;
+	}
+
+	if(TimedFileOps::helperPid == -1 && !TimedFileOps::StartHelper()) {
+		// without a helper the call can not be bounded, but it can still be made
+		Log::Debug("Unable to start a helper process for " + call + ": " + strerror(errno));
+		int ret = TimedFileOps::Perform(op, path, result, &error);
+		errno = error;
+		return ret;
+	}
+
+	RequestHeader request;
+	request.op = op;
+	request.pathLength = path.length();
+	if(!WriteRequest(TimedFileOps::requestFd, request, path)) {
+		TimedFileOps::StopHelper();
+		errno = EIO;
+		return -1;
+	}
+
+	unsigned long long deadline = CollectionDeadline::Now() + budget;
+	ResponseHeader response;
+	ReadStatus status = ReadWithin(TimedFileOps::responseFd, &response, sizeof(response), deadline);
+	if(status == READ_OK && response.resultLength > 0) {
+		result->resize(response.resultLength);
+		status = ReadWithin(TimedFileOps::responseFd, &(*result)[0], response.resultLength, deadline);
+	}
+
+	if(status != READ_OK) {
+		TimedFileOps::StopHelper();
+		result->clear();
+		if(status == READ_TIMED_OUT) {
+			Log::Debug(call + " did not complete within " + Common::ToString(budget) + " milliseconds.");
+			CollectionDeadline::RecordTimeout(call);
+			errno = ETIMEDOUT;
+		} else {
+			errno = EIO;
+		}
+		return -1;
+	}
+
+	// a successful stat returns exactly one structure
+	if(response.result == 0 && (op == OP_LSTAT || op == OP_STAT || op == OP_STATFS64)) {
+		size_t expected = sizeof(struct stat);
+#ifdef LINUX
+		if(op == OP_STATFS64)
+			expected = sizeof(struct statfs64);
+#endif
+		if(result->length() != expected) {
+			result->clear();
+			errno = EIO;
+			return -1;
+		}
+	}
+
+	errno = response.error;
+	return response.result;
+}
+
+int TimedFileOps::Perform(int op, const string &path, string *result, int *error) {
+
+	int ret = -1;
+	*error = 0;
+
+	switch(op) {
+		case OP_LSTAT:
+		case OP_STAT: {
+			struct stat buf;
+			ret = (op == OP_LSTAT) ? lstat(path.c_str(), &buf) : stat(path.c_str(), &buf);
+			*error = errno;
+			if(ret == 0)
+				result->assign((const char*)&buf, sizeof(buf));
+			break;
+		}
+
+		case OP_READDIR: {
+			DIR *dir = opendir(path.c_str());
+			if(dir == NULL) {
+				*error = errno;
+				break;
+			}
+
+			struct dirent *entry;
+			errno = 0;
+			while((entry = readdir(dir)) != NULL) {
+				if(strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+					result->append(entry->d_name);
+					result->push_back('\0');
+				}
+				errno = 0;
+			}
+			*error = errno;
+			closedir(dir);
+
+			ret = (*error == 0) ? 0 : -1;
+			if(ret != 0)
+				result->clear();
+			break;
+		}
+
+#ifdef LINUX
+		case OP_STATFS64: {
+			struct statfs64 buf;
+			ret = statfs64(path.c_str(), &buf);
+			*error = errno;
+			if(ret == 0)
+				result->assign((const char*)&buf, sizeof(buf));
+			break;
+		}
+
+		case OP_ACL_EXTENDED_FILE:
+			ret = acl_extended_file(path.c_str());
+			*error = errno;
+			break;
+#endif
+
+		default:
+			*error = EINVAL;
+			break;
+	}
+
+	return ret;
+}
+
+void TimedFileOps::Serve(int requestFd, int responseFd) {
+
+	try {
+		for(;;) {
+			RequestHeader request;
+			if(!ReadFully(requestFd, &request, sizeof(request)))
+				break;
+
+			string path(request.pathLength, '\0');
+			if(request.pathLength > 0 && !ReadFully(requestFd, &path[0], request.pathLength))
+				break;
+
+			string result;
+			ResponseHeader response;
+			response.result = TimedFileOps::Perform(request.op, path, &result, &response.error);
+			response.resultLength = result.length();
+
+			if(!WriteFully(responseFd, &response, sizeof(response)) ||
+			   !WriteFully(responseFd, result.data(), result.length()))
+				break;
+		}
+	} catch(...) {
+		_exit(EXIT_FAILURE);
+	}
+
+	_exit(EXIT_SUCCESS);
+}
+
+bool TimedFileOps::StartHelper() {
+
+	TimedFileOps::ReapHelpers();
+
+	int requestPipe[2];
+	int responsePipe[2];
+	if(pipe(requestPipe) != 0)
+		return false;
+	if(pipe(responsePipe) != 0) {
+		int error = errno;
+		close(requestPipe[0]);
+		close(requestPipe[1]);
+		errno = error;
+		return false;
+	}
+
+	// keep the helper's pipes out of any commands the probes run and any
+	// helper started later, so that the helper sees its request pipe close
+	fcntl(requestPipe[0], F_SETFD, FD_CLOEXEC);
+	fcntl(requestPipe[1], F_SETFD, FD_CLOEXEC);
+	fcntl(responsePipe[0], F_SETFD, FD_CLOEXEC);
+	fcntl(responsePipe[1], F_SETFD, FD_CLOEXEC);
+
+	// the helper must not carry a copy of the buffered log messages
+	Log::Flush();
+
+	pid_t pid = fork();
+	if(pid < 0) {
+		int error = errno;
+		close(requestPipe[0]);
+		close(requestPipe[1]);
+		close(responsePipe[0]);
+		close(responsePipe[1]);
+		errno = error;
+		return false;
+	} else if(pid == 0) {
+		close(requestPipe[1]);
+		close(responsePipe[0]);
+		TimedFileOps::Serve(requestPipe[0], responsePipe[1]);
+	}
+
+	close(requestPipe[0]);
+	close(responsePipe[1]);
+
+	TimedFileOps::helperPid = pid;
+	TimedFileOps::requestFd = requestPipe[1];
+	TimedFileOps::responseFd = responsePipe[0];
+
+	return true;
+}
+
+void TimedFileOps::StopHelper() {
+
+	if(TimedFileOps::helperPid == -1)
+		return;
+
+	// the helper is most likely stuck in the kernel and will only go away
+	// once the call it is making returns, so it is not waited for here
+	kill(TimedFileOps::helperPid, SIGKILL);
+	close(TimedFileOps::requestFd);
+	close(TimedFileOps::responseFd);
+	if(waitpid(TimedFileOps::helperPid, NULL, WNOHANG) == 0)
+		TimedFileOps::abandonedHelpers.push_back(TimedFileOps::helperPid);
+
+	TimedFileOps::helperPid = -1;
+	TimedFileOps::requestFd = -1;
+	TimedFileOps::responseFd = -1;
+}
+
+void TimedFileOps::ReapHelpers() {
+
+	vector<pid_t>::iterator iterator = TimedFileOps::abandonedHelpers.begin();
+	while(iterator != TimedFileOps::abandonedHelpers.end()) {
+		if(waitpid((*iterator), NULL, WNOHANG) != 0)
+			iterator = TimedFileOps::abandonedHelpers.erase(iterator);
+		else
+			iterator++;
+	}
+}
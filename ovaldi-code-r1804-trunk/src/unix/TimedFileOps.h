@@ -0,0 +1,120 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#ifndef TIMEDFILEOPS_H
+#define TIMEDFILEOPS_H
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef LINUX
+#  include <sys/statfs.h>
+#endif
+#include <string>
+#include <vector>
+
+#include "StdTypedefs.h"
+
+/**
+	This class wraps the file system calls that can block indefinitely, for instance on a hung 
+	NFS mount, so that the probes can place a time limit on them.
+
+	When neither a per call nor a per object timeout is configured the calls are simply made 
+	directly. Otherwise each call is handed to a helper process, started the first time it is 
+	needed, and the interpreter waits for the answer no longer than the budget given by 
+	CollectionDeadline. If the budget runs out the helper is killed and left behind, the call 
+	fails with errno set to ETIMEDOUT and the timeout is recorded with CollectionDeadline. A new 
+	helper is started for the next call.
+
+	All of the functions return what the wrapped call returns and leave errno set on failure.
+*/
+class TimedFileOps {
+public:
+
+	/** lstat() the specified path. */
+	static int Lstat(const std::string &path, struct stat *buf);
+
+	/** stat() the specified path. */
+	static int Stat(const std::string &path, struct stat *buf);
+
+	/** Read the names in the specified directory, leaving out "." and "..". Returns 0 on success and -1 on failure. */
+	static int ReadDir(const std::string &path, StringVector *names);
+
+#ifdef LINUX
+	/** statfs64() the specified path. */
+	static int Statfs64(const std::string &path, struct statfs64 *buf);
+
+	/** acl_extended_file() the specified path. */
+	static int AclExtendedFile(const std::string &path);
+#endif
+
+	/** Stop the helper process and reap any helpers that were abandoned earlier. */
+	static void Shutdown();
+
+	/** Close this process's copies of the helper's pipes without stopping the helper. Called in forked
+		children so that a helper started by the parent sees its request pipe close when the parent shuts it down.
+	*/
+	static void ForgetHelper();
+
+private:
+
+	/** The calls the helper process knows how to make. */
+	enum Operation {
+		OP_LSTAT,
+		OP_STAT,
+		OP_READDIR,
+		OP_STATFS64,
+		OP_ACL_EXTENDED_FILE
+	};
+
+	/** Make the specified call, within the current budget if there is one. The call's output is stored in result. */
+	static int Call(Operation op, const std::string &path, std::string *result);
+
+	/** Make the specified call directly in this process. Returns the call's result and stores its errno in error. */
+	static int Perform(int op, const std::string &path, std::string *result, int *error);
+
+	/** Answer requests read from requestFd until it is closed. Runs in the helper process and never returns. */
+	static void Serve(int requestFd, int responseFd);
+
+	/** Start a new helper process. Returns false if it could not be started. */
+	static bool StartHelper();
+
+	/** Kill the helper process, if any. */
+	static void StopHelper();
+
+	/** Reap any helpers that have exited since they were abandoned. */
+	static void ReapHelpers();
+
+	static pid_t helperPid;
+	static int requestFd;
+	static int responseFd;
+	static std::vector<pid_t> abandonedHelpers;
+};
+
+#endif
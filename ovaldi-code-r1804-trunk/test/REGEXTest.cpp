@@ -0,0 +1,131 @@
+//
+//
+//****************************************************************************************//
+// Copyright (c) 2002-2014, The MITRE Corporation
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice, this list
+//       of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice, this 
+//       list of conditions and the following disclaimer in the documentation and/or other
+//       materials provided with the distribution.
+//     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without specific 
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+// SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+// OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+// EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//****************************************************************************************//
+
+#include <iostream>
+#include <string>
+
+#include "REGEX.h"
+
+using namespace std;
+
+namespace {
+	int failures = 0;
+
+	/** Check that the required literal found for the pattern is the expected one. */
+	void CheckLiteral(const string &pattern, const string &expected) {
+		string literal = REGEX::GetRequiredLiteral(pattern);
+		if(literal.compare(expected) != 0) {
+			cerr << "FAIL: GetRequiredLiteral(\"" << pattern << "\") returned \"" << literal
+				<< "\", expected \"" << expected << "\"" << endl;
+			failures++;
+		}
+	}
+
+	/** Check that a subject the pattern matches contains the pattern's required literal. */
+	void CheckMatch(const string &pattern, const string &subject) {
+		REGEX regex;
+		if(!regex.IsMatch(pattern.c_str(), subject.c_str())) {
+			cerr << "FAIL: \"" << pattern << "\" does not match \"" << subject << "\"" << endl;
+			failures++;
+			return;
+		}
+		string literal = REGEX::GetRequiredLiteral(pattern);
+		if(subject.find(literal) == string::npos) {
+			cerr << "FAIL: \"" << subject << "\" matches \"" << pattern << "\" but does not contain \""
+				<< literal << "\"" << endl;
+			failures++;
+		}
+	}
+}
+
+int main() {
+
+	// plain text and single character escapes
+	CheckLiteral("PermitRootLogin\\s+yes", "PermitRootLogin");
+	CheckLiteral("^\\s*Protocol\\s+2\\s*$", "Protocol");
+	CheckLiteral("foo\\.bar", "foo.bar");
+	CheckLiteral("\\bumask\\b", "umask");
+	CheckLiteral("abcd?e", "abc");
+	CheckLiteral("ab*cdef", "cdef");
+	CheckLiteral("[a-z]+_value", "_value");
+	CheckLiteral("(optional)?required", "required");
+
+	// counted quantifiers
+	CheckLiteral("^\\d{3}$", "");
+	CheckLiteral("x{2,5}", "");
+	CheckLiteral("a{10}", "");
+	CheckLiteral("[0-9]{1024}", "");
+	CheckLiteral("umask\\s+0{1,2}77", "umask");
+	CheckLiteral("Protocol\\s+[0-9]{1}", "Protocol");
+	CheckLiteral("ab{2,}cdef", "cdef");
+	CheckLiteral("ab{2}?cdef", "cdef");
+	CheckLiteral("a{,3}bc", "");
+	CheckLiteral("a{x}bc", "");
+
+	// patterns that are not looked at
+	CheckLiteral("yes|no", "");
+	CheckLiteral("(?i)permit", "");
+	CheckLiteral("\\Qa.b\\E", "");
+
+	// escapes that take arguments
+	CheckLiteral("\\x41BC", "");
+	CheckLiteral("\\x{41}", "");
+	CheckLiteral("\\p{Lu}", "");
+	CheckLiteral("\\P{Lu}xyz", "");
+	CheckLiteral("\\cA", "");
+	CheckLiteral("\\012", "");
+	CheckLiteral("(?<name>a)\\k<name>", "");
+	CheckLiteral("(a)\\g{1}", "");
+	CheckLiteral("(a)\\1", "");
+	CheckLiteral("\\N{U+0041}", "");
+
+	// every match contains the literal
+	CheckMatch("PermitRootLogin\\s+yes", "PermitRootLogin   yes");
+	CheckMatch("\\x41BC", "ABC");
+	CheckMatch("\\x{41}", "A");
+	CheckMatch("\\p{Lu}", "A");
+	CheckMatch("\\cA", "\001");
+	CheckMatch("\\012", "\n");
+	CheckMatch("(?<name>a)\\k<name>", "aa");
+	CheckMatch("(a)\\g{1}", "aa");
+	CheckMatch("^\\d{3}$", "127");
+	CheckMatch("x{2,5}", "xxx");
+	CheckMatch("a{10}", "aaaaaaaaaa");
+	CheckMatch("[0-9]{4}", "2048");
+	CheckMatch("umask\\s+0{1,2}77", "umask 077");
+	CheckMatch("Protocol\\s+[0-9]{1}", "Protocol 2");
+
+	if(failures > 0) {
+		cerr << failures << " check(s) failed" << endl;
+		return 1;
+	}
+	cout << "REGEX checks passed" << endl;
+	return 0;
+}
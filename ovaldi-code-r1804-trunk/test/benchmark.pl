@@ -0,0 +1,367 @@
+#!/usr/bin/perl
+#
+#
+#****************************************************************************************//
+# Copyright (c) 2002-2014, The MITRE Corporation
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are
+# permitted provided that the following conditions are met:
+#
+#     * Redistributions of source code must retain the above copyright notice, this list
+#       of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright notice, this
+#       list of conditions and the following disclaimer in the documentation and/or other
+#       materials provided with the distribution.
+#     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+#       used to endorse or promote products derived from this software without specific
+#       prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+# OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+# OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+# TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+# EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Benchmark for the OVAL Interpreter. Generates a synthetic OVAL Definitions
+# document and a file system tree for it to look at under a temporary root,
+# runs the interpreter against them several times and reports the time taken
+# by parsing, collection and analysis, the throughput of each and the peak
+# memory of the process, as measured by the interpreter's -P report.
+#
+# The content is the same for the same options, so two builds can be compared
+# by running this against each of them on the same machine.
+#
+# Usage: benchmark.pl [options]
+#   --ovaldi <path>       interpreter to run. DEFAULT=./Release/ovaldi
+#   --schema <dir>        directory that contains the OVAL schema. DEFAULT=../../xml
+#   --definitions <n>     number of definitions to generate. DEFAULT=1000
+#   --mix <list>          relative weight of each kind of definition, as a comma
+#                         separated list of kind=weight. The kinds are textfile,
+#                         file, package, process, variable and set.
+#                         DEFAULT=textfile=4,file=2,package=1,process=1,variable=1,set=1
+#   --dirs <n>            directories in the file system tree. DEFAULT=20
+#   --files <n>           files in each directory. DEFAULT=10
+#   --lines <n>           lines in each file. DEFAULT=200
+#   --runs <n>            number of times to run the interpreter. DEFAULT=3
+#   --args <string>       extra options for the interpreter, like "-A -w 4".
+#   --generate <dir>      only write the content and file system tree to <dir>.
+#   --keep                do not remove the temporary root when done.
+#
+
+use strict;
+use warnings;
+
+use File::Path qw(mkpath rmtree);
+use File::Temp qw(tempdir);
+use Getopt::Long;
+use JSON::PP;
+use POSIX qw(floor);
+use Scalar::Util qw(looks_like_number);
+use Time::HiRes qw(time);
+
+my %options = (
+	ovaldi => "./Release/ovaldi",
+	schema => "../../xml",
+	definitions => 1000,
+	mix => "textfile=4,file=2,package=1,process=1,variable=1,set=1",
+	dirs => 20,
+	files => 10,
+	lines => 200,
+	runs => 3,
+	args => "",
+	generate => "",
+	keep => 0,
+);
+GetOptions(\%options, "ovaldi=s", "schema=s", "definitions=i", "mix=s", "dirs=i", "files=i",
+	"lines=i", "runs=i", "args=s", "generate=s", "keep") or die "Invalid options, see the top of $0\n";
+
+my @kinds = ("textfile", "file", "package", "process", "variable", "set");
+my %weights = map { $_ => 0 } @kinds;
+foreach my $entry (split /,/, $options{mix}) {
+	my ($kind, $weight) = split /=/, $entry;
+	die "Unknown kind of definition in --mix: $kind\n" unless exists $weights{$kind};
+	$weights{$kind} = $weight;
+}
+my @schedule = map { ($_) x $weights{$_} } @kinds;
+die "--mix gives every kind of definition a weight of 0\n" unless @schedule;
+
+# dpkg and rpm based systems support different package objects
+my $packageKind = -x "/usr/bin/dpkg" ? "dpkginfo" : "rpminfo";
+
+my $root = $options{generate} ne "" ? $options{generate} : tempdir("ovaldi-benchmark-XXXXXX", TMPDIR => 1);
+mkpath($root);
+
+my $fsRoot = "$root/fs";
+my $definitionsFile = "$root/definitions.xml";
+
+WriteFileSystem();
+my %counts = WriteDefinitions();
+print "Generated $options{definitions} definitions (" . join(", ", map { "$_: $counts{$_}" } grep { $counts{$_} } @kinds) . ")\n";
+print "Generated $options{dirs} x $options{files} files of $options{lines} lines under $fsRoot\n";
+
+if($options{generate} eq "") {
+	RunBenchmark();
+	if($options{keep}) {
+		print "Kept $root\n";
+	} else {
+		rmtree($root);
+	}
+}
+
+exit 0;
+
+#
+# Write the file system tree. Every file holds key = value lines, with a few
+# comments and blank lines, like a typical configuration file.
+#
+sub WriteFileSystem {
+	for(my $d = 0; $d < $options{dirs}; $d++) {
+		my $dir = DirName($d);
+		mkpath($dir);
+		for(my $f = 0; $f < $options{files}; $f++) {
+			open(my $out, ">", FileName($d, $f)) or die "Unable to write " . FileName($d, $f) . ": $!\n";
+			for(my $l = 0; $l < $options{lines}; $l++) {
+				if($l % 10 == 0) {
+					print $out "# section $l of file $f in directory $d\n\n";
+				}
+				print $out "key_$l = value_${d}_${f}_$l\n";
+			}
+			close($out);
+		}
+	}
+}
+
+sub DirName {
+	my ($d) = @_;
+	return sprintf("%s/etc/dir%03d", $fsRoot, $d);
+}
+
+sub FileName {
+	my ($d, $f) = @_;
+	return sprintf("%s/file%03d.conf", DirName($d), $f);
+}
+
+#
+# Write the definitions document. Definition n is of the kind picked by
+# cycling through the weighted mix, and looks at a file picked from n, so
+# that different definitions share files the way real content does.
+#
+sub WriteDefinitions {
+	my (@definitions, @tests, @objects, @states, @variables);
+	my %counts = map { $_ => 0 } @kinds;
+
+	for(my $n = 1; $n <= $options{definitions}; $n++) {
+		my $kind = $schedule[($n - 1) % @schedule];
+		$counts{$kind}++;
+
+		my $d = $n % $options{dirs};
+		my $f = floor($n / $options{dirs}) % $options{files};
+		my $l = $n % $options{lines};
+		my $dir = DirName($d);
+		my $file = sprintf("file%03d.conf", $f);
+		my $test;
+
+		if($kind eq "textfile") {
+			# one line of one file, checked against a state
+			push @objects, TextFileObject($n, "<ind-def:path>$dir</ind-def:path>\n\t\t\t<ind-def:filename>$file</ind-def:filename>", "^key_$l\\s*=\\s*(\\S+)\$");
+			push @states, "\t\t<ind-def:textfilecontent54_state id=\"oval:bench:ste:$n\" version=\"1\">\n"
+				. "\t\t\t<ind-def:subexpression operation=\"pattern match\">^value_${d}_</ind-def:subexpression>\n"
+				. "\t\t</ind-def:textfilecontent54_state>\n";
+			$test = Test($n, "ind-def", "textfilecontent54", "all", "at_least_one_exists", 1);
+
+		} elsif($kind eq "file") {
+			# every file in a directory named by a constant variable
+			push @variables, "\t\t<constant_variable id=\"oval:bench:var:$n\" version=\"1\" datatype=\"string\" comment=\"directory $d\">\n"
+				. "\t\t\t<value>$dir</value>\n"
+				. "\t\t</constant_variable>\n";
+			push @objects, "\t\t<unix-def:file_object id=\"oval:bench:obj:$n\" version=\"1\">\n"
+				. "\t\t\t<unix-def:path var_ref=\"oval:bench:var:$n\"/>\n"
+				. "\t\t\t<unix-def:filename operation=\"pattern match\">\\.conf\$</unix-def:filename>\n"
+				. "\t\t</unix-def:file_object>\n";
+			push @states, "\t\t<unix-def:file_state id=\"oval:bench:ste:$n\" version=\"1\">\n"
+				. "\t\t\t<unix-def:type>regular</unix-def:type>\n"
+				. "\t\t\t<unix-def:uread datatype=\"boolean\">1</unix-def:uread>\n"
+				. "\t\t</unix-def:file_state>\n";
+			$test = Test($n, "unix-def", "file", "all", "at_least_one_exists", 1);
+
+		} elsif($kind eq "package") {
+			# a few real packages, and many that are not installed
+			my @names = ("bash", "coreutils", "libc6", "glibc");
+			my $name = $n % 5 == 0 ? $names[$n % @names] : "ovaldi-benchmark-$n";
+			push @objects, "\t\t<linux-def:${packageKind}_object id=\"oval:bench:obj:$n\" version=\"1\">\n"
+				. "\t\t\t<linux-def:name>$name</linux-def:name>\n"
+				. "\t\t</linux-def:${packageKind}_object>\n";
+			$test = Test($n, "linux-def", $packageKind, "all", "any_exist", 0);
+
+		} elsif($kind eq "process") {
+			push @objects, "\t\t<unix-def:process58_object id=\"oval:bench:obj:$n\" version=\"1\">\n"
+				. "\t\t\t<unix-def:command_line operation=\"pattern match\">^\\S*(sh|init|ovaldi-benchmark-$n)\\b</unix-def:command_line>\n"
+				. "\t\t\t<unix-def:pid datatype=\"int\" operation=\"greater than\">0</unix-def:pid>\n"
+				. "\t\t</unix-def:process58_object>\n";
+			$test = Test($n, "unix-def", "process58", "all", "any_exist", 0);
+
+		} elsif($kind eq "variable") {
+			# the same line must hold the value a local variable built from it
+			push @objects, TextFileObject($n, "<ind-def:filepath>$dir/$file</ind-def:filepath>", "^key_$l\\s*=\\s*(\\S+)\$");
+			push @variables, "\t\t<local_variable id=\"oval:bench:var:$n\" version=\"1\" datatype=\"string\" comment=\"value of key_$l\">\n"
+				. "\t\t\t<concat>\n"
+				. "\t\t\t\t<literal_component>value_</literal_component>\n"
+				. "\t\t\t\t<substring substring_start=\"7\" substring_length=\"-1\">\n"
+				. "\t\t\t\t\t<object_component object_ref=\"oval:bench:obj:$n\" item_field=\"subexpression\"/>\n"
+				. "\t\t\t\t</substring>\n"
+				. "\t\t\t</concat>\n"
+				. "\t\t</local_variable>\n";
+			push @states, "\t\t<ind-def:textfilecontent54_state id=\"oval:bench:ste:$n\" version=\"1\">\n"
+				. "\t\t\t<ind-def:subexpression var_ref=\"oval:bench:var:$n\"/>\n"
+				. "\t\t</ind-def:textfilecontent54_state>\n";
+			$test = Test($n, "ind-def", "textfilecontent54", "all", "at_least_one_exists", 1);
+
+		} else {
+			# the union of one line from every file in two directories
+			my $other = ($d + 1) % $options{dirs};
+			my $first = $n * 10 + 1;
+			my $second = $n * 10 + 2;
+			push @objects, TextFileObject($first, "<ind-def:path>$dir</ind-def:path>\n\t\t\t<ind-def:filename operation=\"pattern match\">\\.conf\$</ind-def:filename>", "^key_$l\\s*=\\s*(\\S+)\$");
+			push @objects, TextFileObject($second, "<ind-def:path>" . DirName($other) . "</ind-def:path>\n\t\t\t<ind-def:filename operation=\"pattern match\">\\.conf\$</ind-def:filename>", "^key_$l\\s*=\\s*(\\S+)\$");
+			push @objects, "\t\t<ind-def:textfilecontent54_object id=\"oval:bench:obj:$n\" version=\"1\">\n"
+				. "\t\t\t<set>\n"
+				. "\t\t\t\t<object_reference>oval:bench:obj:$first</object_reference>\n"
+				. "\t\t\t\t<object_reference>oval:bench:obj:$second</object_reference>\n"
+				. "\t\t\t</set>\n"
+				. "\t\t</ind-def:textfilecontent54_object>\n";
+			push @states, "\t\t<ind-def:textfilecontent54_state id=\"oval:bench:ste:$n\" version=\"1\">\n"
+				. "\t\t\t<ind-def:subexpression operation=\"pattern match\">^value_\\d+_\\d+_$l\$</ind-def:subexpression>\n"
+				. "\t\t</ind-def:textfilecontent54_state>\n";
+			$test = Test($n, "ind-def", "textfilecontent54", "all", "at_least_one_exists", 1);
+		}
+
+		push @tests, $test;
+		push @definitions, "\t\t<definition id=\"oval:bench:def:$n\" version=\"1\" class=\"compliance\">\n"
+			. "\t\t\t<metadata>\n"
+			. "\t\t\t\t<title>Benchmark definition $n</title>\n"
+			. "\t\t\t\t<description>Synthetic $kind definition.</description>\n"
+			. "\t\t\t</metadata>\n"
+			. "\t\t\t<criteria>\n"
+			. "\t\t\t\t<criterion test_ref=\"oval:bench:tst:$n\"/>\n"
+			. "\t\t\t</criteria>\n"
+			. "\t\t</definition>\n";
+	}
+
+	open(my $out, ">", $definitionsFile) or die "Unable to write $definitionsFile: $!\n";
+	print $out "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	print $out "<oval_definitions xmlns=\"http://oval.mitre.org/XMLSchema/oval-definitions-5\""
+		. " xmlns:oval=\"http://oval.mitre.org/XMLSchema/oval-common-5\""
+		. " xmlns:ind-def=\"http://oval.mitre.org/XMLSchema/oval-definitions-5#independent\""
+		. " xmlns:unix-def=\"http://oval.mitre.org/XMLSchema/oval-definitions-5#unix\""
+		. " xmlns:linux-def=\"http://oval.mitre.org/XMLSchema/oval-definitions-5#linux\""
+		. " xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\""
+		. " xsi:schemaLocation=\"http://oval.mitre.org/XMLSchema/oval-definitions-5 oval-definitions-schema.xsd"
+		. " http://oval.mitre.org/XMLSchema/oval-definitions-5#independent independent-definitions-schema.xsd"
+		. " http://oval.mitre.org/XMLSchema/oval-definitions-5#unix unix-definitions-schema.xsd"
+		. " http://oval.mitre.org/XMLSchema/oval-definitions-5#linux linux-definitions-schema.xsd"
+		. " http://oval.mitre.org/XMLSchema/oval-common-5 oval-common-schema.xsd\">\n";
+	print $out "\t<generator>\n"
+		. "\t\t<oval:product_name>ovaldi benchmark</oval:product_name>\n"
+		. "\t\t<oval:schema_version>5.10.1</oval:schema_version>\n"
+		. "\t\t<oval:timestamp>2014-01-01T00:00:00</oval:timestamp>\n"
+		. "\t</generator>\n";
+	print $out "\t<definitions>\n", @definitions, "\t</definitions>\n";
+	print $out "\t<tests>\n", @tests, "\t</tests>\n";
+	print $out "\t<objects>\n", @objects, "\t</objects>\n";
+	print $out "\t<states>\n", @states, "\t</states>\n" if @states;
+	print $out "\t<variables>\n", @variables, "\t</variables>\n" if @variables;
+	print $out "</oval_definitions>\n";
+	close($out);
+
+	return %counts;
+}
+
+sub TextFileObject {
+	my ($id, $location, $pattern) = @_;
+	return "\t\t<ind-def:textfilecontent54_object id=\"oval:bench:obj:$id\" version=\"1\">\n"
+		. "\t\t\t$location\n"
+		. "\t\t\t<ind-def:pattern operation=\"pattern match\">$pattern</ind-def:pattern>\n"
+		. "\t\t\t<ind-def:instance datatype=\"int\" operation=\"greater than or equal\">1</ind-def:instance>\n"
+		. "\t\t</ind-def:textfilecontent54_object>\n";
+}
+
+sub Test {
+	my ($n, $prefix, $type, $check, $existence, $hasState) = @_;
+	return "\t\t<$prefix:${type}_test id=\"oval:bench:tst:$n\" version=\"1\" check=\"$check\" check_existence=\"$existence\" comment=\"benchmark test $n\">\n"
+		. "\t\t\t<$prefix:object object_ref=\"oval:bench:obj:$n\"/>\n"
+		. ($hasState ? "\t\t\t<$prefix:state state_ref=\"oval:bench:ste:$n\"/>\n" : "")
+		. "\t\t</$prefix:${type}_test>\n";
+}
+
+#
+# Run the interpreter the requested number of times and report on each run,
+# followed by the median of the runs.
+#
+sub RunBenchmark {
+	die "Unable to run $options{ovaldi}\n" unless -x $options{ovaldi};
+
+	my @columns = ("run", "total s", "parse s", "collect s", "analyze s", "defs/s parse", "objects/s collect", "items/s collect", "defs/s analyze", "peak rss kb");
+	my $format = "%-6s" . ("%18s" x (@columns - 1)) . "\n";
+	printf $format, @columns;
+
+	my @rows;
+	for(my $run = 1; $run <= $options{runs}; $run++) {
+		my $outDir = "$root/run$run";
+		mkpath($outDir);
+
+		my @command = ($options{ovaldi}, "-m", "-s",
+			"-a", $options{schema},
+			"-o", $definitionsFile,
+			"-d", "$outDir/system-characteristics.xml",
+			"-r", "$outDir/results.xml",
+			"-y", $outDir,
+			"-P", "$outDir/report.json",
+			split(" ", $options{args}));
+
+		my $start = time();
+		system(join(" ", map { "'$_'" } @command) . " > '$outDir/ovaldi.out' 2>&1");
+		my $elapsed = time() - $start;
+		die "The interpreter failed on run $run, see $outDir\n" if $? != 0;
+
+		my $row = ReadReport("$outDir/report.json", $elapsed);
+		push @rows, $row;
+		printf $format, $run, @$row;
+	}
+
+	my @median;
+	for(my $i = 0; $i < @columns - 1; $i++) {
+		# rates that could not be computed are reported as "-" and left out
+		my @sorted = sort { $a <=> $b } grep { looks_like_number($_) } map { $_->[$i] } @rows;
+		push @median, @sorted ? $sorted[floor(@sorted / 2)] : "-";
+	}
+	printf $format, "median", @median;
+}
+
+sub ReadReport {
+	my ($file, $elapsed) = @_;
+
+	open(my $in, "<", $file) or die "Unable to read $file: $!\n";
+	my $report = decode_json(join("", <$in>));
+	close($in);
+
+	my %phases = map { $_->{name} => $_ } @{$report->{phases}};
+	my $seconds = sub { my ($name) = @_; return exists $phases{$name} ? $phases{$name}->{wall_ms} / 1000 : 0; };
+	my $rate = sub { my ($count, $time) = @_; return $time > 0 ? sprintf("%.1f", $count / $time) : "-"; };
+
+	my $items = 0;
+	$items += $_->{items} foreach @{$report->{probes}};
+	my $objects = scalar @{$report->{objects}};
+
+	my $parse = $seconds->("parse definitions");
+	my $collect = $seconds->("collect");
+	my $analyze = $seconds->("analyze");
+
+	return [sprintf("%.3f", $elapsed), sprintf("%.3f", $parse), sprintf("%.3f", $collect), sprintf("%.3f", $analyze),
+		$rate->($options{definitions}, $parse), $rate->($objects, $collect), $rate->($items, $collect),
+		$rate->($options{definitions}, $analyze), $report->{total}->{peak_memory_kb}];
+}
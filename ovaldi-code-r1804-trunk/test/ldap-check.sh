@@ -0,0 +1,208 @@
+#!/bin/bash
+#
+#
+#****************************************************************************************#
+# Copyright (c) 2002-2014, The MITRE Corporation
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are
+# permitted provided that the following conditions are met:
+#
+#     * Redistributions of source code must retain the above copyright notice, this list
+#       of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright notice, this 
+#       list of conditions and the following disclaimer in the documentation and/or other
+#       materials provided with the distribution.
+#     * Neither the name of The MITRE Corporation nor the names of its contributors may be
+#       used to endorse or promote products derived from this software without specific 
+#       prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY 
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+# OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+# SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+# OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+# TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+# EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+#****************************************************************************************#
+
+
+#
+# Checks the ldap probe against a private slapd. A few hundred entries, each
+# with a large jpegPhoto, are loaded and a one level ldap_object reads the
+# description of every one of them. The check passes if every description is
+# collected and the definition is true, and if the process stayed well below
+# the size of all of the photos, which the probe must not keep in memory.
+#
+# The probe reads the server from /etc/ldap.conf and always uses port 389, so
+# this has to run as root, with slapd and the ldap client tools installed.
+# The check is skipped when that is not the case.
+#
+# Usage: ldap-check.sh <ovaldi> <schema dir> [entries]
+#
+
+OVALDI=$1
+SCHEMA=$2
+ENTRIES=${3:-300}
+SUFFIX="dc=example,dc=com"
+ROOTDN="cn=admin,$SUFFIX"
+ROOTPW="secret"
+URI="ldap://127.0.0.1:389/"
+
+skip() {
+	echo "SKIP: ldap check, $1"
+	exit 0
+}
+
+fail() {
+	echo "FAIL: ldap check, $1"
+	exit 1
+}
+
+if [ -z "$OVALDI" -o -z "$SCHEMA" ]; then
+	echo "Usage: $0 <ovaldi> <schema dir> [entries]"
+	exit 1
+fi
+
+SLAPD=`command -v slapd || ls /usr/sbin/slapd /usr/libexec/slapd /usr/libexec/openldap/slapd 2>/dev/null | head -1`
+[ -n "$SLAPD" ] || skip "slapd was not found"
+command -v ldapadd > /dev/null || skip "ldapadd was not found"
+[ `id -u` -eq 0 ] || skip "the probe only uses port 389, so it has to run as root"
+if [ -e /etc/ldap.conf ] && ! grep -q '^host[[:space:]][[:space:]]*127\.0\.0\.1' /etc/ldap.conf; then
+	skip "/etc/ldap.conf names another server"
+fi
+
+LDAPSCHEMA=""
+for dir in /etc/ldap/schema /etc/openldap/schema /usr/local/etc/openldap/schema; do
+	if [ -f $dir/inetorgperson.schema ]; then
+		LDAPSCHEMA=$dir
+		break
+	fi
+done
+[ -n "$LDAPSCHEMA" ] || skip "the inetorgperson schema was not found"
+
+WORK=`mktemp -d /tmp/ovaldi-ldap-check.XXXXXX`
+CREATED_LDAP_CONF=0
+
+cleanup() {
+	if [ -f $WORK/slapd.pid ]; then
+		kill `cat $WORK/slapd.pid` 2> /dev/null
+	fi
+	if [ $CREATED_LDAP_CONF -eq 1 ]; then
+		rm -f /etc/ldap.conf
+	fi
+	rm -rf $WORK
+}
+trap cleanup EXIT
+
+#
+# Start slapd with an empty directory.
+#
+mkdir $WORK/db
+cat > $WORK/slapd.conf << SLAPD_CONF
+include $LDAPSCHEMA/core.schema
+include $LDAPSCHEMA/cosine.schema
+include $LDAPSCHEMA/inetorgperson.schema
+pidfile $WORK/slapd.pid
+access to * by * read
+database ldif
+directory $WORK/db
+suffix "$SUFFIX"
+rootdn "$ROOTDN"
+rootpw $ROOTPW
+SLAPD_CONF
+
+$SLAPD -f $WORK/slapd.conf -h "$URI" || fail "slapd did not start"
+for i in 1 2 3 4 5 6 7 8 9 10; do
+	ldapsearch -x -H "$URI" -b "" -s base > /dev/null 2>&1 && break
+	sleep 1
+done
+
+if [ ! -e /etc/ldap.conf ]; then
+	echo "host 127.0.0.1" > /etc/ldap.conf
+	CREATED_LDAP_CONF=1
+fi
+
+#
+# Load the entries. Each photo is a different megabyte of random data.
+#
+echo "Loading $ENTRIES entries"
+{
+	printf "dn: $SUFFIX\nobjectClass: dcObject\nobjectClass: organization\ndc: example\no: example\n\n"
+	printf "dn: ou=people,$SUFFIX\nobjectClass: organizationalUnit\nou: people\n\n"
+	for i in `seq 1 $ENTRIES`; do
+		printf "dn: cn=user$i,ou=people,$SUFFIX\nobjectClass: inetOrgPerson\ncn: user$i\nsn: user$i\n"
+		printf "description: description of user$i\njpegPhoto:: "
+		head -c 1048576 /dev/urandom | base64 | tr -d '\n'
+		printf "\n\n"
+	done
+} > $WORK/entries.ldif
+ldapadd -x -H "$URI" -D "$ROOTDN" -w $ROOTPW -f $WORK/entries.ldif > /dev/null || fail "the entries could not be loaded"
+rm $WORK/entries.ldif
+
+#
+# Read every description with one subtree object.
+#
+cat > $WORK/definitions.xml << DEFINITIONS
+<?xml version="1.0" encoding="UTF-8"?>
+<oval_definitions xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5" xmlns:oval="http://oval.mitre.org/XMLSchema/oval-common-5" xmlns:ind-def="http://oval.mitre.org/XMLSchema/oval-definitions-5#independent" xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance" xsi:schemaLocation="http://oval.mitre.org/XMLSchema/oval-definitions-5 oval-definitions-schema.xsd http://oval.mitre.org/XMLSchema/oval-definitions-5#independent independent-definitions-schema.xsd http://oval.mitre.org/XMLSchema/oval-common-5 oval-common-schema.xsd">
+	<generator>
+		<oval:product_name>ovaldi ldap check</oval:product_name>
+		<oval:schema_version>5.10.1</oval:schema_version>
+		<oval:timestamp>2014-01-01T00:00:00</oval:timestamp>
+	</generator>
+	<definitions>
+		<definition id="oval:ldapcheck:def:1" version="1" class="compliance">
+			<metadata>
+				<title>Every person has a description</title>
+				<description>Reads the description of every entry under ou=people.</description>
+			</metadata>
+			<criteria>
+				<criterion test_ref="oval:ldapcheck:tst:1"/>
+			</criteria>
+		</definition>
+	</definitions>
+	<tests>
+		<ind-def:ldap_test id="oval:ldapcheck:tst:1" version="1" check="all" check_existence="at_least_one_exists" comment="every description is as loaded">
+			<ind-def:object object_ref="oval:ldapcheck:obj:1"/>
+			<ind-def:state state_ref="oval:ldapcheck:ste:1"/>
+		</ind-def:ldap_test>
+	</tests>
+	<objects>
+		<ind-def:ldap_object id="oval:ldapcheck:obj:1" version="1">
+			<ind-def:behaviors scope="ONE"/>
+			<ind-def:suffix>$SUFFIX</ind-def:suffix>
+			<ind-def:relative_dn>ou=people</ind-def:relative_dn>
+			<ind-def:attribute>description</ind-def:attribute>
+		</ind-def:ldap_object>
+	</objects>
+	<states>
+		<ind-def:ldap_state id="oval:ldapcheck:ste:1" version="1">
+			<ind-def:value operation="pattern match">^description of user[0-9]+$</ind-def:value>
+		</ind-def:ldap_state>
+	</states>
+</oval_definitions>
+DEFINITIONS
+
+echo "Collecting"
+$OVALDI -m -s -a "$SCHEMA" -o $WORK/definitions.xml -d $WORK/system-characteristics.xml -r $WORK/results.xml -y $WORK -P $WORK/report.json > $WORK/ovaldi.out 2>&1 || {
+	cat $WORK/ovaldi.out
+	fail "ovaldi failed"
+}
+
+COLLECTED=`grep -c '>description of user[0-9]*<' $WORK/system-characteristics.xml`
+[ "$COLLECTED" -eq "$ENTRIES" ] || fail "$COLLECTED of $ENTRIES descriptions were collected"
+
+grep -q 'definition_id="oval:ldapcheck:def:1"[^>]*result="true"' $WORK/results.xml || fail "the definition is not true"
+
+# the photos add up to $ENTRIES megabytes
+PEAK=`sed -n 's/.*"total": {[^}]*"peak_memory_kb": \([0-9]*\).*/\1/p' $WORK/report.json`
+LIMIT=`expr $ENTRIES \* 1024 \* 3 / 4`
+[ -n "$PEAK" ] || fail "the peak memory could not be read from the -P report"
+[ "$PEAK" -lt "$LIMIT" ] || fail "the peak memory was ${PEAK}KB, the limit is ${LIMIT}KB"
+
+echo "PASS: ldap check, $COLLECTED descriptions collected, peak memory ${PEAK}KB"
+exit 0